@@ -44,11 +44,17 @@ public:
 
 
 	PH_SETTING_INT3(setScreenDelay, screenDelay, delay)
+	PH_SETTING_INT2(setVideoReadhead, videoReadhead, 8)
+	PH_SETTING_INT2(setVideoPoolSize, videoPoolSize, 32)
+	PH_SETTING_INT2(setVideoCacheSize, videoCacheSize, 2048)
+	PH_SETTING_INT2(setVideoDecodeThreadCount, videoDecodeThreadCount, 0)
+	PH_SETTING_INT2(setVideoDecodeThreadType, videoDecodeThreadType, 0)
 
 	// PhGraphicSettings
 	PH_SETTING_BOOL(setDisplayInfo, displayInfo)
 	PH_SETTING_STRING2(setFontFile, fontFile, QApplication::applicationDirPath() + PATH_TO_RESSOURCES + "/SWENSON.TTF")
 	PH_SETTING_BOOL(setResetInfo, resetInfo)
+	PH_SETTING_BOOL(setRenderThread, renderThread)
 
 	// PhGraphicStripSettings :
 	PH_SETTING_FLOAT2(setStripHeight, stripHeight, 0.25f)
@@ -59,6 +65,9 @@ public:
 	PH_SETTING_STRING2(setHudFontFile, hudFontFile, QApplication::applicationDirPath() + PATH_TO_RESSOURCES + "/Helvetica.ttf")
 	PH_SETTING_STRING2(setTextFontFile, textFontFile, QApplication::applicationDirPath() + PATH_TO_RESSOURCES + "/SWENSON.TTF")
 	PH_SETTING_INT2(setTextBoldness, textBoldness, 2)
+	PH_SETTING_BOOL(setTextDistanceField, textDistanceField)
+	PH_SETTING_BOOL(setTiledStrip, tiledStrip)
+	PH_SETTING_BOOL(setGpuStrip, gpuStrip)
 	PH_SETTING_BOOL(setStripTestMode, stripTestMode)
 	PH_SETTING_BOOL2(setDisplayNextText, displayNextText, true)
 	PH_SETTING_BOOL(setHideSelectedPeoples, hideSelectedPeoples)
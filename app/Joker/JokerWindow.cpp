@@ -11,6 +11,7 @@
 
 #include "PhGraphic/PhGraphicText.h"
 #include "PhGraphic/PhGraphicSolidRect.h"
+#include "PhGraphic/PhGraphicProfiler.h"
 
 #include "JokerWindow.h"
 #include "ui_JokerWindow.h"
@@ -114,21 +115,29 @@ JokerWindow::JokerWindow(JokerSettings *settings) :
 
 	ui->actionShow_ruler->setChecked(_settings->displayRuler());
 
-	this->connect(ui->videoStripView, &PhGraphicView::beforePaint, this, &JokerWindow::timeCounter);
-	this->connect(ui->videoStripView, &PhGraphicView::beforePaint, _strip.clock(), &PhClock::elapse);
+	// The paint signals may come from the render thread (see startRenderThread())
+	this->connect(ui->videoStripView, &PhGraphicView::beforePaint, this, &JokerWindow::timeCounter, Qt::DirectConnection);
+	this->connect(ui->videoStripView, &PhGraphicView::beforePaint, _strip.clock(), &PhClock::elapse, Qt::DirectConnection);
 
-	this->connect(ui->videoStripView, &PhGraphicView::paint, this, &JokerWindow::onPaint);
+	this->connect(ui->videoStripView, &PhGraphicView::paint, this, &JokerWindow::onPaint, Qt::DirectConnection);
 
 	_videoLogo.setFilename(QCoreApplication::applicationDirPath() + PATH_TO_RESSOURCES + "/phonations.png");
 }
 
 JokerWindow::~JokerWindow()
 {
+	// The render thread uses the window members
+	ui->videoStripView->stopRenderThread();
 	_mediaPanel.close();
 
 	delete ui;
 }
 
+void JokerWindow::startRenderThread()
+{
+	ui->videoStripView->startRenderThread();
+}
+
 void JokerWindow::closeEvent(QCloseEvent *event)
 {
 	// the user will be asked if the document has to be saved
@@ -221,8 +230,11 @@ bool JokerWindow::openDocument(const QString &fileName)
 	else
 		_firstDoc = false;
 
-	if(!_doc->openStripFile(fileName))
-		return false;
+	{
+		QMutexLocker locker(ui->videoStripView->renderMutex());
+		if(!_doc->openStripFile(fileName))
+			return false;
+	}
 
 	/// If the document is opened successfully :
 	/// - Update the current document name (settings, windows title)
@@ -230,16 +242,22 @@ bool JokerWindow::openDocument(const QString &fileName)
 	_watcher.addPath(_doc->filePath());
 
 	/// - Load the deinterlace settings
-	_videoEngine.setDeinterlace(_doc->videoDeinterlace());
+	{
+		QMutexLocker locker(ui->videoStripView->renderMutex());
+		_videoEngine.setDeinterlace(_doc->videoDeinterlace());
+	}
 	ui->actionDeinterlace_video->setChecked(_doc->videoDeinterlace());
 
 	/// - Open the corresponding video file if it exists.
 	if(openVideoFile(_doc->videoFilePath())) {
-		_videoEngine.setTimeIn(_doc->videoTimeIn());
+		{
+			QMutexLocker locker(ui->videoStripView->renderMutex());
+			_videoEngine.setTimeIn(_doc->videoTimeIn());
+		}
 		_mediaPanel.setTimeIn(_doc->videoTimeIn());
 	}
 	else
-		_videoEngine.close();
+		on_actionClose_video_triggered();
 
 	/// - Set the video aspect ratio.
 	ui->actionForce_16_9_ratio->setChecked(_doc->forceRatio169());
@@ -458,15 +476,23 @@ bool JokerWindow::openVideoFile(QString videoFile)
 {
 	QFileInfo lastFileInfo(_doc->videoFilePath());
 	QFileInfo fileInfo(videoFile);
-	if (fileInfo.exists() && _videoEngine.open(videoFile)) {
+	bool opened = false;
+	if(fileInfo.exists()) {
+		QMutexLocker locker(ui->videoStripView->renderMutex());
+		opened = _videoEngine.open(videoFile);
+	}
+	if(opened) {
 		PhTime videoTimeIn = _videoEngine.timeIn();
 
 		if(videoTimeIn == 0) {
 			/* the video itself has no timestamp, and until now we have not
 			 * propagated the doc videoTimeIn to the videoEngine */
 			videoTimeIn = _doc->videoTimeIn();
-			_videoEngine.setTimeIn(videoTimeIn);
-			_videoEngine.clock()->setTime(videoTimeIn);
+			{
+				QMutexLocker locker(ui->videoStripView->renderMutex());
+				_videoEngine.setTimeIn(videoTimeIn);
+				_videoEngine.clock()->setTime(videoTimeIn);
+			}
 
 			/* ask the user if he wants to change the video time in */
 			if(fileInfo.fileName() != lastFileInfo.fileName()) {
@@ -475,13 +501,16 @@ bool JokerWindow::openVideoFile(QString videoFile)
 			}
 		}
 
-		if(videoFile != _doc->videoFilePath()) {
-			_doc->setVideoFilePath(videoFile);
-			_doc->setVideoTimeIn(videoTimeIn, _videoEngine.timeCodeType());
-			_doc->setModified(true);
-		}
+		{
+			QMutexLocker locker(ui->videoStripView->renderMutex());
+			if(videoFile != _doc->videoFilePath()) {
+				_doc->setVideoFilePath(videoFile);
+				_doc->setVideoTimeIn(videoTimeIn, _videoEngine.timeCodeType());
+				_doc->setModified(true);
+			}
 
-		_videoEngine.clock()->setTime(videoTimeIn);
+			_videoEngine.clock()->setTime(videoTimeIn);
+		}
 		_mediaPanel.setTimeIn(videoTimeIn);
 		_mediaPanel.setLength(_videoEngine.length());
 
@@ -526,11 +555,14 @@ void JokerWindow::on_actionChange_timestamp_triggered()
 		else
 			timeStamp = _videoEngine.timeIn() + dlg.time() - _synchronizer.videoClock()->time();
 
-		_videoEngine.setTimeIn(timeStamp);
-		setCurrentTime(dlg.time());
-		_doc->setVideoTimeIn(timeStamp, _videoEngine.timeCodeType());
+		{
+			QMutexLocker locker(ui->videoStripView->renderMutex());
+			_videoEngine.setTimeIn(timeStamp);
+			setCurrentTime(dlg.time());
+			_doc->setVideoTimeIn(timeStamp, _videoEngine.timeCodeType());
+			_doc->setModified(true);
+		}
 		_mediaPanel.setTimeIn(timeStamp);
-		_doc->setModified(true);
 	}
 
 	fadeInMediaPanel();
@@ -697,8 +729,10 @@ void JokerWindow::on_actionSave_triggered()
 	QFileInfo info(fileName);
 	if(!info.exists() || (info.suffix() != "joker"))
 		on_actionSave_as_triggered();
-	else if(_doc->saveStripFile(fileName, currentTime()))
+	else if(_doc->saveStripFile(fileName, currentTime())) {
+		QMutexLocker locker(ui->videoStripView->renderMutex());
 		_doc->setModified(false);
+	}
 	else
 		QMessageBox::critical(this, "", tr("Unable to save ") + fileName);
 }
@@ -721,7 +755,10 @@ void JokerWindow::on_actionSave_as_triggered()
 	fileName = QFileDialog::getSaveFileName(this, tr("Save..."), fileName, "*.joker");
 	if(fileName != "") {
 		if(_doc->saveStripFile(fileName, currentTime())) {
-			_doc->setModified(false);
+			{
+				QMutexLocker locker(ui->videoStripView->renderMutex());
+				_doc->setModified(false);
+			}
 			PhEditableDocumentWindow::saveDocument(fileName);
 		}
 		else
@@ -738,7 +775,7 @@ void JokerWindow::on_actionSelect_character_triggered()
 {
 	hideMediaPanel();
 
-	PeopleDialog dlg(this, _doc, _settings);
+	PeopleDialog dlg(this, _doc, _settings, ui->videoStripView->renderMutex());
 
 	dlg.restoreGeometry(_settings->peopleDialogGeometry());
 	dlg.exec();
@@ -747,6 +784,7 @@ void JokerWindow::on_actionSelect_character_triggered()
 
 void JokerWindow::on_actionForce_16_9_ratio_triggered(bool checked)
 {
+	QMutexLocker locker(ui->videoStripView->renderMutex());
 	_doc->setForceRatio169(checked);
 	_doc->setModified(true);
 }
@@ -771,12 +809,16 @@ void JokerWindow::on_actionChange_ruler_timestamp_triggered()
 
 void JokerWindow::on_actionNew_triggered()
 {
-	_doc->reset();
+	{
+		QMutexLocker locker(ui->videoStripView->renderMutex());
+		_doc->reset();
+	}
 	on_actionClose_video_triggered();
 }
 
 void JokerWindow::on_actionClose_video_triggered()
 {
+	QMutexLocker locker(ui->videoStripView->renderMutex());
 	_videoEngine.close();
 }
 
@@ -788,8 +830,28 @@ void JokerWindow::on_actionSend_feedback_triggered()
 	fadeInMediaPanel();
 }
 
+void JokerWindow::on_actionProfile_the_frames_triggered(bool checked)
+{
+	PhGraphicProfiler::instance()->setEnabled(checked);
+}
+
+void JokerWindow::on_actionSave_the_frame_profile_triggered()
+{
+	hideMediaPanel();
+
+	QString fileName = QFileDialog::getSaveFileName(this, tr("Save the frame profile..."),
+	                                                _settings->lastDocumentFolder() + "/profile.json", "*.json");
+	if(fileName != "") {
+		if(!PhGraphicProfiler::instance()->saveTrace(fileName))
+			QMessageBox::critical(this, "", tr("Unable to save ") + fileName);
+	}
+
+	fadeInMediaPanel();
+}
+
 void JokerWindow::on_actionDeinterlace_video_triggered(bool checked)
 {
+	QMutexLocker locker(ui->videoStripView->renderMutex());
 	_videoEngine.setDeinterlace(checked);
 	if(checked != _doc->videoDeinterlace()) {
 		_doc->setVideoDeinterlace(checked);
@@ -808,6 +870,17 @@ void JokerWindow::onPaint(int width, int height)
 	long delay = (int)(24 * _settings->screenDelay() * clock->rate());
 	PhTime clockTime = clock->time() + delay;
 
+	// Keep the loop being rehearsed in the video cache
+	PhStripLoop *rehearsedLoop = _doc->previousLoop(clockTime + 1);
+	PhStripLoop *followingLoop = _doc->nextLoop(clockTime);
+	if(rehearsedLoop || followingLoop) {
+		PhTime loopTimeIn = rehearsedLoop ? rehearsedLoop->timeIn() : _videoEngine.timeIn();
+		PhTime loopTimeOut = followingLoop ? followingLoop->timeIn() : _videoEngine.timeOut();
+		_videoEngine.setPinnedRange(loopTimeIn, loopTimeOut);
+	}
+	else
+		_videoEngine.setPinnedRange(0, -1);
+
 	float stripHeightRatio = 0.0f;
 	if(!_settings->hideStrip())
 		stripHeightRatio = _settings->stripHeight();
@@ -868,6 +941,7 @@ void JokerWindow::onPaint(int width, int height)
 	int x = videoX + videoWidth;
 	int y = 0;
 	if(_settings->displayNextText()) {
+		PhGraphicProfilerScope scope(PhGraphicProfiler::OverlayStage);
 		QColor infoColor = _settings->backgroundColorLight();
 		int infoWidth = width - videoWidth;
 		int spacing = 4;
@@ -973,6 +1047,7 @@ void JokerWindow::onPaint(int width, int height)
 	}
 
 	if((_settings->synchroProtocol() == PhSynchronizer::Sony) && (_lastVideoSyncElapsed.elapsed() > 1000)) {
+		PhGraphicProfilerScope scope(PhGraphicProfiler::OverlayStage);
 		PhGraphicText errorText(_strip.getHUDFont(), tr("No video sync"));
 		errorText.setRect(width / 2 - 100, height / 2 - 25, 200, 50);
 		int red = (_lastVideoSyncElapsed.elapsed() - 1000) / 4;
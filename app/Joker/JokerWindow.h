@@ -60,6 +60,13 @@ public:
 	///
 	bool openVideoFile(QString videoFile);
 
+	///
+	/// @brief Render the video and strip view from a dedicated thread
+	///
+	/// The window must be visible.
+	///
+	void startRenderThread();
+
 public slots:
 	///
 	/// \brief timeCounter Slot used to count the time played on nominal speed
@@ -231,6 +238,10 @@ private slots:
 
 	void on_actionSend_feedback_triggered();
 
+	void on_actionProfile_the_frames_triggered(bool checked);
+
+	void on_actionSave_the_frame_profile_triggered();
+
 	void on_actionDeinterlace_video_triggered(bool checked);
 
 	void on_actionHide_the_rythmo_triggered(bool checked);
@@ -11,11 +11,12 @@
 
 #include "PeopleEditionDialog.h"
 
-PeopleDialog::PeopleDialog(QWidget *parent, PhStripDoc* doc, JokerSettings *settings) :
+PeopleDialog::PeopleDialog(QWidget *parent, PhStripDoc* doc, JokerSettings *settings, QMutex *renderMutex) :
 	QDialog(parent),
 	ui(new Ui::PeopleDialog),
 	_doc(doc),
-	_settings(settings)
+	_settings(settings),
+	_renderMutex(renderMutex)
 {
 	ui->setupUi(this);
 
@@ -82,6 +83,6 @@ void PeopleDialog::on_deselectAllButton_clicked()
 void PeopleDialog::on_changeCharButton_clicked()
 {
 	PhPeople * people = _doc->peopleByName(ui->peopleList->selectedItems().first()->text());
-	PeopleEditionDialog * dlg = new PeopleEditionDialog(_doc, people);
+	PeopleEditionDialog * dlg = new PeopleEditionDialog(_doc, people, _renderMutex);
 	dlg->exec();
 }
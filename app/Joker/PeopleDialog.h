@@ -7,6 +7,8 @@
 #ifndef PEOPLEDIALOG_H
 #define PEOPLEDIALOG_H
 
+#include <QMutex>
+
 #include "PhCommonUI/PhUI.h"
 
 #include "PhStrip/PhStripDoc.h"
@@ -37,8 +39,9 @@ public:
 	 * @param parent The parent object
 	 * @param doc The current PhStripDoc
 	 * @param settings The application settings
+	 * @param renderMutex The mutex held while the strip is painted
 	 */
-	explicit PeopleDialog(QWidget *parent, PhStripDoc* doc, JokerSettings *settings);
+	explicit PeopleDialog(QWidget *parent, PhStripDoc* doc, JokerSettings *settings, QMutex *renderMutex);
 
 	~PeopleDialog();
 
@@ -55,6 +58,7 @@ private:
 	Ui::PeopleDialog *ui;
 	PhStripDoc* _doc;
 	JokerSettings *_settings;
+	QMutex *_renderMutex;
 	QStringList _oldPeopleNameList;
 };
 
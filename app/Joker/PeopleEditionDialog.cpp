@@ -6,11 +6,12 @@
 #include "PeopleEditionDialog.h"
 #include "ui_PeopleEditionDialog.h"
 
-PeopleEditionDialog::PeopleEditionDialog(PhStripDoc *doc, PhPeople * people, QWidget *parent) :
+PeopleEditionDialog::PeopleEditionDialog(PhStripDoc *doc, PhPeople * people, QMutex *renderMutex, QWidget *parent) :
 	QDialog(parent),
 	ui(new Ui::PhColorPickerDialog),
 	_doc(doc),
-	_people(people)
+	_people(people),
+	_renderMutex(renderMutex)
 {
 	ui->setupUi(this);
 	// Setting the label
@@ -31,8 +32,11 @@ PeopleEditionDialog::~PeopleEditionDialog()
 
 void PeopleEditionDialog::OnColorSelected(QColor newColor) {
 	// Setting the new color
-	_people->setColor(newColor.name());
-	_doc->setModified(true);
+	{
+		QMutexLocker locker(_renderMutex);
+		_people->setColor(newColor.name());
+		_doc->setModified(true);
+	}
 
 	ui->pbColor->setStyleSheet("background-color:" +  newColor.name() +";");
 
@@ -40,8 +44,9 @@ void PeopleEditionDialog::OnColorSelected(QColor newColor) {
 
 void PeopleEditionDialog::on_buttonBox_rejected()
 {
-	// Reseting color
-	_people->setColor(_oldColor);
+	// Reseting color, which emits changed() for the strip
+	OnColorSelected(_oldColor);
+	QMutexLocker locker(_renderMutex);
 	_doc->setModified(_oldModified);
 }
 
@@ -6,6 +6,8 @@
 #ifndef PHCOLORPICKERDIALOG_H
 #define PHCOLORPICKERDIALOG_H
 
+#include <QMutex>
+
 #include "PhCommonUI/PhUI.h"
 
 #include "PhStrip/PhStripDoc.h"
@@ -26,7 +28,14 @@ class PeopleEditionDialog : public QDialog
 	Q_OBJECT
 
 public:
-	explicit PeopleEditionDialog(PhStripDoc * doc, PhPeople * people, QWidget *parent = 0);
+	/**
+	 * @brief The PeopleEditionDialog constructor
+	 * @param doc The current PhStripDoc
+	 * @param people The people to edit
+	 * @param renderMutex The mutex held while the strip is painted
+	 * @param parent The parent object
+	 */
+	explicit PeopleEditionDialog(PhStripDoc * doc, PhPeople * people, QMutex *renderMutex, QWidget *parent = 0);
 	~PeopleEditionDialog();
 
 public slots:
@@ -48,6 +57,7 @@ private:
 	QString _oldColor;
 	bool _oldModified;
 	PhPeople * _people;
+	QMutex *_renderMutex;
 };
 
 #endif // PHCOLORPICKERDIALOG_H
@@ -35,8 +35,16 @@ PreferencesDialog::PreferencesDialog(JokerSettings *settings, QWidget *parent) :
 	_oldHorizontalTimePerPixel = _settings->horizontalTimePerPixel();
 	_oldBolness = _settings->textBoldness();
 	_oldFont = _settings->textFontFile();
+	_oldDistanceField = _settings->textDistanceField();
+	_oldTiledStrip = _settings->tiledStrip();
+	_oldGpuStrip = _settings->gpuStrip();
+	_oldRenderThread = _settings->renderThread();
 
 	ui->sliderBoldness->setValue(_oldBolness);
+	ui->checkBoxDistanceField->setChecked(_oldDistanceField);
+	ui->checkBoxTiledStrip->setChecked(_oldTiledStrip);
+	ui->checkBoxGpuStrip->setChecked(_oldGpuStrip);
+	ui->checkBoxRenderThread->setChecked(_oldRenderThread);
 	ui->spinBoxSpeed->setValue(_oldHorizontalTimePerPixel);
 
 	_delayButtonGroup.addButton(ui->radioButtonQF);
@@ -255,6 +263,10 @@ void PreferencesDialog::reject()
 	_settings->setHorizontalTimePerPixel(_oldHorizontalTimePerPixel);
 	_settings->setTextBoldness(_oldBolness);
 	_settings->setTextFontFile(_oldFont);
+	_settings->setTextDistanceField(_oldDistanceField);
+	_settings->setTiledStrip(_oldTiledStrip);
+	_settings->setGpuStrip(_oldGpuStrip);
+	_settings->setRenderThread(_oldRenderThread);
 
 	QDialog::reject();
 }
@@ -316,6 +328,26 @@ void PreferencesDialog::on_sliderBoldness_valueChanged(int value)
 	_settings->setTextBoldness(value);
 }
 
+void PreferencesDialog::on_checkBoxDistanceField_toggled(bool checked)
+{
+	_settings->setTextDistanceField(checked);
+}
+
+void PreferencesDialog::on_checkBoxTiledStrip_toggled(bool checked)
+{
+	_settings->setTiledStrip(checked);
+}
+
+void PreferencesDialog::on_checkBoxGpuStrip_toggled(bool checked)
+{
+	_settings->setGpuStrip(checked);
+}
+
+void PreferencesDialog::on_checkBoxRenderThread_toggled(bool checked)
+{
+	_settings->setRenderThread(checked);
+}
+
 void PreferencesDialog::on_lineEditFilter_textEdited(const QString &value)
 {
 	ui->listWidgetFont->clear();
@@ -60,6 +60,14 @@ private slots:
 
 	void on_sliderBoldness_valueChanged(int value);
 
+	void on_checkBoxDistanceField_toggled(bool checked);
+
+	void on_checkBoxTiledStrip_toggled(bool checked);
+
+	void on_checkBoxGpuStrip_toggled(bool checked);
+
+	void on_checkBoxRenderThread_toggled(bool checked);
+
 	void on_lineEditFilter_textEdited(const QString &value);
 
 private:
@@ -70,6 +78,10 @@ private:
 	int _oldDelay;
 	int _oldHorizontalTimePerPixel;
 	int _oldBolness;
+	bool _oldDistanceField;
+	bool _oldTiledStrip;
+	bool _oldGpuStrip;
+	bool _oldRenderThread;
 	float _oldStripHeight;
 
 	QMap<QString, QString> _fontList;
@@ -59,6 +59,9 @@ int main(int argc, char *argv[])
 	w.processArg(argc, argv);
 	w.show();
 
+	if(settings.renderThread())
+		w.startRenderThread();
+
 	int result = a.exec();
 	settings.setExitedNormaly(result == 0);
 
@@ -4,19 +4,85 @@
  * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
  */
 
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+
+#include <cmath>
+#include <cstring>
+
 #include "PhFont.h"
 #include "PhTools/PhDebug.h"
 
-PhFont::PhFont() : _texture(-1), _glyphHeight(0), _boldness(0), _ready(false)
+/** Width and height of the glyph atlas (in pixel) */
+#define PHFONT_ATLAS_SIZE 2048
+/** Empty pixels between two glyphs of the atlas to avoid bleeding when filtering */
+#define PHFONT_GLYPH_PADDING 1
+/** Distance covered by the distance field on each side of the glyph edge (in pixel) */
+#define PHFONT_DISTANCE_SPREAD 16
+/** Magic number identifying the atlas cache files */
+#define PHFONT_CACHE_MAGIC 0x50684641
+/** Version of the atlas cache files */
+#define PHFONT_CACHE_VERSION 1
+
+PhFont::PhFont() :
+	_texture(0),
+	_glyphHeight(0),
+	_boldness(0),
+	_ready(false),
+	_font(NULL),
+	_fontSize(0),
+	_shelfX(0),
+	_shelfY(0),
+	_shelfHeight(0),
+	_dirtyTop(0),
+	_dirtyBottom(0),
+	_textureOutdated(true),
+	_cacheModified(false),
+	_distanceField(false),
+	_outline(0),
+	_outlineColor(Qt::black),
+	_invertColor(false)
 {
 }
 
+PhFont::~PhFont()
+{
+	QMutexLocker locker(&_mutex);
+	reset();
+
+	if((_texture == 0) || _textureContext.isNull())
+		return;
+
+	// The texture can only be deleted by its own context
+	QOpenGLContext *previousContext = QOpenGLContext::currentContext();
+	QSurface *previousSurface = previousContext ? previousContext->surface() : NULL;
+	const QGLContext *context = QGLContext::fromOpenGLContext(_textureContext);
+	if(previousContext != _textureContext)
+		const_cast<QGLContext *>(context)->makeCurrent();
+
+	if(QOpenGLContext::currentContext() == _textureContext)
+		glDeleteTextures(1, &_texture);
+	else
+		PHDEBUG << "Unable to make the context current: leaking the texture";
+
+	if(previousContext == NULL)
+		const_cast<QGLContext *>(context)->doneCurrent();
+	else if(previousContext != _textureContext)
+		previousContext->makeCurrent(previousSurface);
+}
+
 void PhFont::setFontFile(QString fontFile)
 {
+	QMutexLocker locker(&_mutex);
 	if(fontFile != this->_fontFile) {
 		PHDEBUG << fontFile;
+		reset();
 		this->_fontFile = fontFile;
-		_ready = false;
 	}
 }
 
@@ -27,6 +93,16 @@ QString PhFont::getFontFile()
 
 int PhFont::computeMaxFontSize(QString fileName)
 {
+	// The search opens the font several times: its result is kept
+	static QMutex mutex;
+	static QHash<QString, int> sizes;
+	QString key = fileName + "@" + QString::number(QFileInfo(fileName).lastModified().toMSecsSinceEpoch());
+	{
+		QMutexLocker locker(&mutex);
+		if(sizes.contains(key))
+			return sizes.value(key);
+	}
+
 	int size = 25;
 	int fontHeight = 128;
 	int low = 0, high = 1000;
@@ -37,134 +113,348 @@ int PhFont::computeMaxFontSize(QString fileName)
 		if(!font)
 			return -1;
 
-		if (fontHeight == TTF_FontHeight(font))
+		int height = TTF_FontHeight(font);
+		TTF_CloseFont(font);
+		if (fontHeight == height)
 			break;
-		else if (fontHeight < TTF_FontHeight(font))
+		else if (fontHeight < height)
 			high = size - 1;
 		else
 			low = size + 1;
-		TTF_CloseFont(font);
 	}
 	TTF_Font * font = TTF_OpenFont(fileName.toStdString().c_str(), size);
 	if(fontHeight < TTF_FontHeight(font))
 		size--;
 	TTF_CloseFont(font);
 
+	QMutexLocker locker(&mutex);
+	sizes[key] = size;
 	return size;
 }
 
+/**
+ * @brief One dimension squared euclidean distance transform
+ *
+ * See "Distance Transforms of Sampled Functions" by P. Felzenszwalb and D. Huttenlocher.
+ * @param f The sampled function
+ * @param d The squared distances
+ * @param n The number of samples
+ * @param v A buffer for the parabolas location (n elements)
+ * @param z A buffer for the parabolas boundaries (n + 1 elements)
+ */
+static void distanceTransform(const float *f, float *d, int n, int *v, float *z)
+{
+	const float infinity = 1e20f;
+	int k = 0;
+	v[0] = 0;
+	z[0] = -infinity;
+	z[1] = infinity;
+	for(int q = 1; q < n; q++) {
+		float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+		while(s <= z[k]) {
+			k--;
+			s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+		}
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = infinity;
+	}
+
+	k = 0;
+	for(int q = 0; q < n; q++) {
+		while(z[k + 1] < q)
+			k++;
+		d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+	}
+}
+
+/**
+ * @brief Two dimensions squared euclidean distance transform
+ * @param grid The function values (0 on the features, infinity elsewhere), replaced by the squared distances
+ * @param width The grid width
+ * @param height The grid height
+ */
+static void distanceTransform(QVector<float> &grid, int width, int height)
+{
+	int n = qMax(width, height);
+	QVector<float> f(n), d(n), z(n + 1);
+	QVector<int> v(n);
+
+	for(int x = 0; x < width; x++) {
+		for(int y = 0; y < height; y++)
+			f[y] = grid[y * width + x];
+		distanceTransform(f.constData(), d.data(), height, v.data(), z.data());
+		for(int y = 0; y < height; y++)
+			grid[y * width + x] = d[y];
+	}
+
+	for(int y = 0; y < height; y++) {
+		distanceTransform(grid.constData() + y * width, d.data(), width, v.data(), z.data());
+		memcpy(grid.data() + y * width, d.constData(), width * sizeof(float));
+	}
+}
+
+/**
+ * @brief Replace a glyph coverage by its signed distance field
+ *
+ * The edge lies at 128, the inside of the glyph is above and the values
+ * reach 0 and 255 at the spread distance.
+ * @param pixels The glyph coverage
+ * @param width The glyph width
+ * @param height The glyph height
+ * @param spread The distance covered by the field on each side of the edge
+ */
+static void computeDistanceField(uchar *pixels, int width, int height, int spread)
+{
+	const float infinity = 1e20f;
+	int count = width * height;
+	QVector<float> outside(count), inside(count);
+	for(int i = 0; i < count; i++) {
+		bool in = pixels[i] >= 128;
+		outside[i] = in ? 0 : infinity;
+		inside[i] = in ? infinity : 0;
+	}
+
+	distanceTransform(outside, width, height);
+	distanceTransform(inside, width, height);
+
+	for(int i = 0; i < count; i++) {
+		// The distance is measured from the pixel boundary
+		float distance = (outside[i] > 0) ? std::sqrt(outside[i]) - 0.5f : 0.5f - std::sqrt(inside[i]);
+		float value = 0.5f - distance / (2 * spread);
+		pixels[i] = static_cast<uchar>(qBound(0.0f, value, 1.0f) * 255);
+	}
+}
+
+int PhFont::atlasSize()
+{
+	return PHFONT_ATLAS_SIZE;
+}
+
 // This will split the setting of the bolness and the fontfile, which allow to change the boldness without reloading a font
 bool PhFont::init()
 {
-	int size = computeMaxFontSize(_fontFile);
-
-	if(size < 0)
+	QFile file(_fontFile);
+	if(!file.open(QIODevice::ReadOnly)) {
+		PHDEBUG << "Unable to open" << _fontFile;
 		return false;
-	PHDEBUG << "Opening" << _fontFile << "at size" << size;
-	TTF_Font * font = TTF_OpenFont(_fontFile.toStdString().c_str(), size);
+	}
+	_fontHash = QCryptographicHash::hash(file.readAll(), QCryptographicHash::Md5).toHex();
+	file.close();
 
-	//Font foreground color is white
-	SDL_Color color = {255, 255, 255, 255};
+	if(loadCache())
+		PHDEBUG << "Atlas loaded from" << cacheFileName() << ":" << _glyphs.count() << "glyphs";
+	else {
+		_fontSize = computeMaxFontSize(_fontFile);
+		if(_fontSize < 0)
+			return false;
+		if(!openFont())
+			return false;
 
-	// used to set the base surface
-	Uint32 rmask = 0x000000ff;
-	Uint32 gmask = 0x0000ff00;
-	Uint32 bmask = 0x00ff0000;
-	Uint32 amask = 0xff000000;
-	SDL_Surface * matrixSurface = SDL_CreateRGBSurface(0, 2048, 2048, 32, rmask, gmask, bmask, amask);
+		// The outline passes enlarge the glyphs by the boldness on each side
+		// while the distance field is drawn around the nominal glyph.
+		_glyphHeight = TTF_FontHeight(_font);
+		if(!_distanceField)
+			_glyphHeight += 2 * _boldness;
+		_atlas.fill(0, PHFONT_ATLAS_SIZE * PHFONT_ATLAS_SIZE);
+	}
 
-	// Font background color is transparent
-	Uint32 backgroundColor = 0x00000000;
-	SDL_FillRect(matrixSurface, NULL, backgroundColor);
+	_dirtyTop = 0;
+	_dirtyBottom = 0;
+	_textureOutdated = true;
+	_ready = true;
+	return _ready;
+}
+
+void PhFont::reset()
+{
+	saveCache();
 
-	// Space between glyph
-	int space = 128;
+	if(_font && TTF_WasInit())
+		TTF_CloseFont(_font);
+	_font = NULL;
+	_glyphs.clear();
+	_atlas.clear();
 	_glyphHeight = 0;
+	_shelfX = _shelfY = _shelfHeight = 0;
+	_cacheModified = false;
+	_ready = false;
+}
 
-	for(Uint16 ch = 0; ch < 32; ++ch) {
-		_glyphAdvance[ch] = 0;
-	}
-
-	//set the boldness
-	PHDEBUG << "Setting the font boldness to :" << _boldness;
-	for(int boldIndex = 0; boldIndex <= _boldness; boldIndex++) {
-		TTF_SetFontOutline(font, boldIndex);
-		// We get rid of the 32 first useless char
-		for(Uint16 charIndex = 32; charIndex < 256; ++charIndex) {
-			if(TTF_GlyphIsProvided(font, charIndex) or charIndex == 153) {
-				int minx, maxx, miny, maxy, advance;
-				Uint16 charCode = charIndex;
-				if(charCode == 153) {
-					charCode = 339;
-				}
-				TTF_GlyphMetrics(font, charCode, &minx, &maxx, &miny, &maxy, &advance);
-				if(advance > 0) {
-					// First render the glyph to a surface
-					SDL_Surface * glyphSurface = TTF_RenderGlyph_Blended(font, charCode, color);
-					if (glyphSurface) {
-						SDL_Rect glyphRect;
-						glyphRect.x = (charIndex % 16) * space;
-						glyphRect.y = (charIndex / 16) * space;
-						glyphRect.w = glyphSurface->w;
-						glyphRect.h = glyphSurface->h;
-						if(glyphRect.h > _glyphHeight)
-							_glyphHeight = glyphRect.h;
-						//PHDEBUG << ch << (char) ch << minx << maxx << miny << maxy << advance << _glyphHeight;
-						// Then blit it to the matrix
-						SDL_BlitSurface( glyphSurface, NULL, matrixSurface, &glyphRect );
-
-						// Store information about the glyph
-						_glyphAdvance[charIndex] = advance;
-					}
-					else {
-						_glyphAdvance[charIndex] = 0;
-						PHDEBUG << "Error during the Render Glyph of " << (char) charIndex << SDL_GetError();
-					}
-					SDL_FreeSurface(glyphSurface);
-				}
-				else {
-					PHDEBUG <<" Error with Glyph of char:" << charIndex << (char) charIndex << minx << maxx << miny << maxy << advance;
-					_glyphAdvance[charIndex] = 0;
-				}
-			}
-			else
-				_glyphAdvance[charIndex] = 0;
+bool PhFont::openFont()
+{
+	if(_font)
+		return true;
+
+	PHDEBUG << "Opening" << _fontFile << "at size" << _fontSize;
+	_font = TTF_OpenFont(_fontFile.toStdString().c_str(), _fontSize);
+	if(_font == NULL) {
+		PHDEBUG << "Unable to open" << _fontFile << TTF_GetError();
+		return false;
+	}
+	return true;
+}
+
+PhFont::Glyph PhFont::glyph(uint ch)
+{
+	QMutexLocker locker(&_mutex);
+	if(!_ready && !init())
+		return Glyph();
+
+	QHash<uint, Glyph>::const_iterator it = _glyphs.constFind(ch);
+	if(it != _glyphs.constEnd())
+		return it.value();
+
+	Glyph result = rasterize(ch);
+	_glyphs[ch] = result;
+	_cacheModified = true;
+	return result;
+}
+
+PhFont::Glyph PhFont::rasterize(uint ch)
+{
+	Glyph result;
+	result.advance = 0;
+	result.x = result.y = result.width = result.height = 0;
+
+	// We get rid of the control characters and of the code points that SDL_ttf can't handle
+	if((ch < 32) || (ch > 0xFFFF) || !openFont())
+		return result;
+
+	Uint16 charCode = ch;
+	if(!TTF_GlyphIsProvided(_font, charCode))
+		return result;
+
+	int minx, maxx, miny, maxy, advance;
+	TTF_SetFontOutline(_font, _boldness);
+	TTF_GlyphMetrics(_font, charCode, &minx, &maxx, &miny, &maxy, &advance);
+	if(advance <= 0) {
+		PHDEBUG << "Error with Glyph of char:" << ch << minx << maxx << miny << maxy << advance;
+		return result;
+	}
+	result.advance = advance;
+
+	//Font foreground color is white
+	SDL_Color color = {255, 255, 255, 255};
+
+	// The boldness is obtained by blending the outlines from 0 to the boldness,
+	// except for the distance field where it is a shader parameter.
+	int padding = getPadding();
+	int lastBoldIndex = _distanceField ? 0 : _boldness;
+	QList<SDL_Surface*> surfaces;
+	for(int boldIndex = 0; boldIndex <= lastBoldIndex; boldIndex++) {
+		TTF_SetFontOutline(_font, boldIndex);
+		SDL_Surface * glyphSurface = TTF_RenderGlyph_Blended(_font, charCode, color);
+		if(glyphSurface == NULL) {
+			PHDEBUG << "Error during the Render Glyph of" << ch << SDL_GetError();
+			continue;
 		}
+		result.width = qMax(result.width, glyphSurface->w + 2 * padding);
+		result.height = qMax(result.height, glyphSurface->h + 2 * padding);
+		surfaces.append(glyphSurface);
 	}
 
-	glEnable( GL_TEXTURE_2D );
-	// Have OpenGL generate a texture object handle for us
-	glGenTextures( 1, &_texture );
+	// Find a place in the atlas
+	if(_shelfX + result.width > PHFONT_ATLAS_SIZE) {
+		_shelfX = 0;
+		_shelfY += _shelfHeight + PHFONT_GLYPH_PADDING;
+		_shelfHeight = 0;
+	}
+	if((result.width > PHFONT_ATLAS_SIZE) || (_shelfY + result.height > PHFONT_ATLAS_SIZE)) {
+		PHDEBUG << "The atlas is full, unable to display" << ch;
+		result.width = result.height = 0;
+	}
+	else {
+		result.x = _shelfX;
+		result.y = _shelfY;
+		_shelfX += result.width + PHFONT_GLYPH_PADDING;
+		_shelfHeight = qMax(_shelfHeight, result.height);
 
-	// Bind the texture object
-	glBindTexture( GL_TEXTURE_2D, _texture );
+		// Blend the alpha of each pass into the atlas
+		QVector<uchar> coverage(result.width * result.height, 0);
+		foreach(SDL_Surface *glyphSurface, surfaces) {
+			SDL_LockSurface(glyphSurface);
+			for(int row = 0; row < glyphSurface->h; row++) {
+				Uint32 *pixels = reinterpret_cast<Uint32*>(static_cast<Uint8*>(glyphSurface->pixels) + row * glyphSurface->pitch);
+				uchar *line = coverage.data() + (row + padding) * result.width + padding;
+				for(int col = 0; col < glyphSurface->w; col++) {
+					Uint8 r, g, b, a;
+					SDL_GetRGBA(pixels[col], glyphSurface->format, &r, &g, &b, &a);
+					line[col] = a + line[col] * (255 - a) / 255;
+				}
+			}
+			SDL_UnlockSurface(glyphSurface);
+		}
 
+		if(_distanceField)
+			computeDistanceField(coverage.data(), result.width, result.height, PHFONT_DISTANCE_SPREAD);
 
-	// Edit the texture object's image data using the information SDL_Surface gives us
-	glTexImage2D( GL_TEXTURE_2D, 0, matrixSurface->format->BytesPerPixel, matrixSurface->w, matrixSurface->h, 0,
-	              GL_RGBA, GL_UNSIGNED_BYTE, matrixSurface->pixels);
+		uchar *atlas = reinterpret_cast<uchar*>(_atlas.data());
+		for(int row = 0; row < result.height; row++)
+			memcpy(atlas + (result.y + row) * PHFONT_ATLAS_SIZE + result.x, coverage.constData() + row * result.width, result.width);
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		if(_dirtyTop == _dirtyBottom) {
+			_dirtyTop = result.y;
+			_dirtyBottom = result.y + result.height;
+		}
+		else {
+			_dirtyTop = qMin(_dirtyTop, result.y);
+			_dirtyBottom = qMax(_dirtyBottom, result.y + result.height);
+		}
+	}
 
-	// Once the texture is created, the surface is no longer needed.
-	SDL_FreeSurface(matrixSurface);
-	TTF_CloseFont(font);
+	foreach(SDL_Surface *glyphSurface, surfaces)
+		SDL_FreeSurface(glyphSurface);
 
-	_ready = true;
-	return _ready;
+	return result;
 }
 
-int PhFont::getAdvance(unsigned char ch)
+int PhFont::getAdvance(uint ch)
 {
-	return _glyphAdvance[ch];
+	return glyph(ch).advance;
 }
 
 void PhFont::select()
 {
-	if(!_ready)
-		this->init();
-	glBindTexture(GL_TEXTURE_2D, (GLuint)_texture);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)texture());
+}
+
+unsigned int PhFont::texture()
+{
+	QMutexLocker locker(&_mutex);
+	if(!_ready && !init())
+		return _texture;
+
+	if(_texture == 0) {
+		glGenTextures(1, &_texture);
+		_textureContext = QOpenGLContext::currentContext();
+	}
+
+	if(_textureOutdated) {
+		glBindTexture(GL_TEXTURE_2D, _texture);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		// An intensity texture modulates the four channels of the color:
+		// the glyphs are drawn with a premultiplied alpha.
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_INTENSITY8, PHFONT_ATLAS_SIZE, PHFONT_ATLAS_SIZE, 0,
+		             GL_LUMINANCE, GL_UNSIGNED_BYTE, _atlas.constData());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		_textureOutdated = false;
+		_dirtyTop = _dirtyBottom = 0;
+	}
+	else if(_dirtyTop < _dirtyBottom) {
+		// Only the rows holding the new glyphs are uploaded
+		glBindTexture(GL_TEXTURE_2D, _texture);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, _dirtyTop, PHFONT_ATLAS_SIZE, _dirtyBottom - _dirtyTop,
+		                GL_LUMINANCE, GL_UNSIGNED_BYTE, _atlas.constData() + _dirtyTop * PHFONT_ATLAS_SIZE);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		_dirtyTop = _dirtyBottom = 0;
+	}
+
+	return _texture;
 }
 
 int PhFont::getBoldness() const
@@ -176,16 +466,144 @@ int PhFont::getNominalWidth(QString string)
 {
 	int width = 0;
 	foreach(QChar c, string) {
-		width += getAdvance(c.toLatin1());
+		width += getAdvance(c.unicode());
 	}
 	return width;
 }
 
 void PhFont::setBoldness(int value)
 {
+	QMutexLocker locker(&_mutex);
 	if(_boldness != value) {
+		// The distance field atlas does not depend on the boldness
+		if(!_distanceField)
+			reset();
 		_boldness = value;
-		_ready = false;
 	}
 }
 
+void PhFont::setDistanceField(bool enabled)
+{
+	QMutexLocker locker(&_mutex);
+	if(_distanceField != enabled) {
+		reset();
+		_distanceField = enabled;
+	}
+}
+
+void PhFont::setOutline(int width)
+{
+	_outline = width;
+}
+
+void PhFont::setOutlineColor(QColor color)
+{
+	_outlineColor = color;
+}
+
+void PhFont::setInvertColor(bool invert)
+{
+	_invertColor = invert;
+}
+
+int PhFont::getPadding() const
+{
+	return _distanceField ? PHFONT_DISTANCE_SPREAD : 0;
+}
+
+PhGraphicBatch::DistanceField PhFont::distanceFieldParameters() const
+{
+	// The field covers twice the spread from 0 to 1 and the edge lies at 0.5
+	PhGraphicBatch::DistanceField result;
+	result.threshold = 0.5f - _boldness / (2.0f * PHFONT_DISTANCE_SPREAD);
+	result.outlineWidth = _outline / (2.0f * PHFONT_DISTANCE_SPREAD);
+	result.outlineColor = _outlineColor;
+	result.invertColor = _invertColor;
+	return result;
+}
+
+QString PhFont::cacheFileName()
+{
+	QString variant = _distanceField ? "sdf" : QString::number(_boldness);
+	return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/font/"
+	       + QString("%1-%2.phfont").arg(QString(_fontHash)).arg(variant);
+}
+
+bool PhFont::loadCache()
+{
+	QFile file(cacheFileName());
+	if(!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream stream(&file);
+	quint32 magic, version;
+	qint32 fontSize, glyphHeight, shelfX, shelfY, shelfHeight, glyphCount;
+	stream >> magic >> version;
+	if((magic != PHFONT_CACHE_MAGIC) || (version != PHFONT_CACHE_VERSION)) {
+		PHDEBUG << "Bad atlas file:" << file.fileName();
+		return false;
+	}
+
+	stream >> fontSize >> glyphHeight >> shelfX >> shelfY >> shelfHeight >> glyphCount;
+	QHash<uint, Glyph> glyphs;
+	for(int i = 0; i < glyphCount; i++) {
+		quint32 ch;
+		qint32 advance, x, y, width, height;
+		stream >> ch >> advance >> x >> y >> width >> height;
+		Glyph glyph;
+		glyph.advance = advance;
+		glyph.x = x;
+		glyph.y = y;
+		glyph.width = width;
+		glyph.height = height;
+		glyphs[ch] = glyph;
+	}
+	QByteArray atlas;
+	stream >> atlas;
+	atlas = qUncompress(atlas);
+
+	if((stream.status() != QDataStream::Ok) || (atlas.size() != PHFONT_ATLAS_SIZE * PHFONT_ATLAS_SIZE))
+		return false;
+
+	// The font itself is only opened when a glyph is missing
+	_fontSize = fontSize;
+	_glyphHeight = glyphHeight;
+	_shelfX = shelfX;
+	_shelfY = shelfY;
+	_shelfHeight = shelfHeight;
+	_glyphs = glyphs;
+	_atlas = atlas;
+	_cacheModified = false;
+	return true;
+}
+
+void PhFont::saveCache()
+{
+	if(!_ready || !_cacheModified)
+		return;
+
+	QString fileName = cacheFileName();
+	QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+	QFile file(fileName);
+	if(!file.open(QIODevice::WriteOnly)) {
+		PHDEBUG << "Unable to write" << fileName;
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream << (quint32)PHFONT_CACHE_MAGIC << (quint32)PHFONT_CACHE_VERSION;
+	stream << (qint32)_fontSize << (qint32)_glyphHeight;
+	stream << (qint32)_shelfX << (qint32)_shelfY << (qint32)_shelfHeight;
+	stream << (qint32)_glyphs.count();
+	for(QHash<uint, Glyph>::const_iterator it = _glyphs.constBegin(); it != _glyphs.constEnd(); ++it) {
+		const Glyph &glyph = it.value();
+		stream << (quint32)it.key() << (qint32)glyph.advance << (qint32)glyph.x << (qint32)glyph.y
+		       << (qint32)glyph.width << (qint32)glyph.height;
+	}
+	// Most of the atlas is empty
+	stream << qCompress(_atlas);
+
+	PHDEBUG << _glyphs.count() << "glyphs saved to" << fileName;
+	_cacheModified = false;
+}
@@ -7,26 +7,63 @@
 #ifndef PHFONT_H
 #define PHFONT_H
 
+#include <QHash>
+#include <QMutex>
+#include <QOpenGLContext>
+#include <QPointer>
+
 #include "PhGraphic.h"
+#include "PhGraphicBatch.h"
 
 /**
  * @brief Describe the font appearance for PhGraphicText
  *
  * The PhFont instance are initialized with a true type font file.
  * The boldness can be configured.
+ *
+ * The glyphs are rasterized on first use into a single channel atlas,
+ * so any character provided by the font can be displayed. The atlas is
+ * saved in the cache folder when the font, its boldness or the PhFont
+ * instance change, and loaded back the next time the same font is
+ * used with the same boldness.
+ *
+ * In distance field mode, the atlas stores the distance to the glyph
+ * edge instead of its coverage. The text stays sharp at any size and the
+ * boldness, the outline and the color inversion are applied by a shader
+ * when drawing, without rasterizing the glyphs again.
+ *
+ * The glyphs and the atlas are guarded by a mutex: the text widths may be
+ * measured by the GUI thread while a render thread draws with the font.
  */
 class PhFont
 {
 public:
+	/**
+	 * @brief The location and metrics of a glyph
+	 */
+	struct Glyph {
+		/** The regular advance of the glyph */
+		int advance;
+		/** The left coordinate of the glyph in the atlas */
+		int x;
+		/** The top coordinate of the glyph in the atlas */
+		int y;
+		/** The glyph width in the atlas (0 if nothing is drawn) */
+		int width;
+		/** The glyph height in the atlas */
+		int height;
+	};
+
 	/**
 	 * @brief PhFont constructor
 	 */
 	PhFont();
 
+	~PhFont();
+
 	/**
 	 * @brief Set the source font file.
 	 * @param fontFile Path to the new font file
-	 * @return true if the font was loaded successfully, false otherwise.
 	 */
 	void setFontFile(QString fontFile);
 
@@ -41,10 +78,17 @@ public:
 	 *
 	 * The returned value is correspond to the amount of pixel the character at a regular text size (100).
 	 * This value must be converted proportionaly if the text width is scaled.
-	 * @param ch ASCII index of the character.
+	 * @param ch Unicode code point of the character.
 	 * @return A value in pixel.
 	 */
-	int getAdvance(unsigned char ch);
+	int getAdvance(uint ch);
+
+	/**
+	 * @brief Get a glyph, rasterizing it if needed.
+	 * @param ch Unicode code point of the character.
+	 * @return A glyph description.
+	 */
+	Glyph glyph(uint ch);
 
 	/**
 	 * @brief Get the regular height of the font.
@@ -57,11 +101,26 @@ public:
 		return _glyphHeight;
 	}
 
+	/**
+	 * @brief The width and height of the glyph atlas
+	 * @return A value in pixel.
+	 */
+	static int atlasSize();
+
 	/**
 	 * @brief Select the font for the further rendering operation.
 	 */
 	void select();
 
+	/**
+	 * @brief The texture holding the glyphs
+	 *
+	 * The font is initialized if needed and the glyphs
+	 * rasterized since the last call are uploaded.
+	 * @return A texture name
+	 */
+	unsigned int texture();
+
 	/**
 	 * @brief Set the font boldness
 	 * The boldness is created using <a href=http://www.libsdl.org/projects/SDL_ttf/docs/SDL_ttf_24.html#SEC24>TTF_SetFontOutline</a>
@@ -76,6 +135,52 @@ public:
 	 */
 	int getBoldness() const;
 
+	/**
+	 * @brief Enable the distance field mode
+	 * @param enabled True to render the glyphs as a distance field
+	 */
+	void setDistanceField(bool enabled);
+
+	/**
+	 * @brief Get the distance field mode
+	 * @return True if the glyphs are rendered as a distance field
+	 */
+	bool distanceField() const {
+		return _distanceField;
+	}
+
+	/**
+	 * @brief Set the outline width (distance field mode only)
+	 * @param width The outline width in pixel at the regular size
+	 */
+	void setOutline(int width);
+
+	/**
+	 * @brief Set the outline color (distance field mode only)
+	 * @param color A color
+	 */
+	void setOutlineColor(QColor color);
+
+	/**
+	 * @brief Invert the text color (distance field mode only)
+	 * @param invert True to invert the color
+	 */
+	void setInvertColor(bool invert);
+
+	/**
+	 * @brief The empty border around each glyph of the atlas
+	 *
+	 * The border holds the distance field outside the glyph edge.
+	 * @return A value in pixel at the regular size.
+	 */
+	int getPadding() const;
+
+	/**
+	 * @brief The shader parameters matching the font appearance
+	 * @return The distance field parameters
+	 */
+	PhGraphicBatch::DistanceField distanceFieldParameters() const;
+
 	/**
 	 * @brief Get the nominal width of a given string
 	 * @param string to be measured
@@ -98,13 +203,25 @@ private:
 	 * The texture reference
 	 */
 	unsigned int _texture;
+	QPointer<QOpenGLContext> _textureContext;
 
 	bool init();
+	void reset();
+	bool openFont();
+	Glyph rasterize(uint ch);
+	QString cacheFileName();
+	bool loadCache();
+	void saveCache();
+
+	/**
+	 * @brief The glyphs rasterized so far
+	 */
+	QHash<uint, Glyph> _glyphs;
 
 	/**
-	 * @brief Store the regular advance of each glyph.
+	 * @brief The single channel pixels of the atlas
 	 */
-	int _glyphAdvance[256];
+	QByteArray _atlas;
 
 	/**
 	 * @brief Store the regular advance of the font.
@@ -116,6 +233,25 @@ private:
 	int _boldness;
 
 	bool _ready;
+
+	TTF_Font *_font;
+	int _fontSize;
+	QByteArray _fontHash;
+
+	// The atlas is filled row by row (shelf packing)
+	int _shelfX, _shelfY, _shelfHeight;
+
+	// The atlas rows not uploaded yet
+	int _dirtyTop, _dirtyBottom;
+	bool _textureOutdated;
+	bool _cacheModified;
+
+	bool _distanceField;
+	int _outline;
+	QColor _outlineColor;
+	bool _invertColor;
+
+	QMutex _mutex;
 };
 
 #endif // PHFONT_H
@@ -12,9 +12,15 @@ HEADERS += \
     $$PWD/PhGraphic.h \
 	$$PWD/PhGraphicSettings.h \
 	$$PWD/PhGraphicView.h \
+	$$PWD/PhGraphicRenderThread.h \
+	$$PWD/PhGraphicFramePacer.h \
+	$$PWD/PhGraphicProfiler.h \
+	$$PWD/PhGraphicOffscreen.h \
+	$$PWD/PhGraphicBatch.h \
 	$$PWD/PhGraphicImage.h \
 	$$PWD/PhGraphicText.h \
 	$$PWD/PhGraphicTexturedRect.h \
+	$$PWD/PhGraphicYUVRect.h \
 	$$PWD/PhFont.h \
 	$$PWD/PhGraphicObject.h \
 	$$PWD/PhGraphicRect.h \
@@ -26,9 +32,15 @@ HEADERS += \
 
 SOURCES += \
 	$$PWD/PhGraphicView.cpp \
+	$$PWD/PhGraphicRenderThread.cpp \
+	$$PWD/PhGraphicFramePacer.cpp \
+	$$PWD/PhGraphicProfiler.cpp \
+	$$PWD/PhGraphicOffscreen.cpp \
+	$$PWD/PhGraphicBatch.cpp \
 	$$PWD/PhGraphicImage.cpp \
 	$$PWD/PhGraphicText.cpp \
 	$$PWD/PhGraphicTexturedRect.cpp \
+	$$PWD/PhGraphicYUVRect.cpp \
 	$$PWD/PhFont.cpp \
 	$$PWD/PhGraphicObject.cpp \
 	$$PWD/PhGraphicRect.cpp \
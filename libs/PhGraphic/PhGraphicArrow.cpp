@@ -1,3 +1,4 @@
+#include "PhGraphicBatch.h"
 #include "PhGraphicArrow.h"
 
 PhGraphicArrow::PhGraphicArrow(PhGraphicArrow::PhGraphicArrowDirection direction, int x, int y, int w, int h)
@@ -14,46 +15,39 @@ void PhGraphicArrow::setDirection(PhGraphicArrow::PhGraphicArrowDirection direct
 
 void PhGraphicArrow::draw()
 {
-	PhGraphicObject::draw();
+	PhGraphicBatch *batch = PhGraphicBatch::instance();
+	QColor color = this->color();
 
-	int thickness = this->height() / 10;
-	int nose = this->height() / 3;
+	int x = this->x();
+	int y = this->y();
+	int z = this->z();
+	int w = this->width();
+	int h = this->height();
+	int thickness = h / 10;
+	int nose = h / 3;
 
 	switch (_direction) {
 	case DownLeftToUpRight:
-		glBegin(GL_QUADS);
-		{
-			glVertex3i(this->x(),      this->y() + thickness, this->z());
-			glVertex3i(this->x()+ thickness,      this->y(), this->z());
-			glVertex3i(this->x() + this->width(), this->y() + this->height()- thickness,  this->z());
-			glVertex3i(this->x() + this->width() - thickness, this->y() + this->height(),  this->z());
-		}
-		glEnd();
-
-		glBegin(GL_TRIANGLES);
-		{
-			glVertex3i(this->x() + this->width(), this->y() + this->height(),  this->z());
-			glVertex3i(this->x() + this->width() - nose, this->y() + this->height(),  this->z());
-			glVertex3i(this->x() + this->width(), this->y() + this->height()- nose,  this->z());
-		}
-		glEnd();
+		batch->addQuad(0, PhGraphicBatch::NoBlend,
+		               PhGraphicBatch::vertex(x, y + thickness, z, color),
+		               PhGraphicBatch::vertex(x + thickness, y, z, color),
+		               PhGraphicBatch::vertex(x + w, y + h - thickness, z, color),
+		               PhGraphicBatch::vertex(x + w - thickness, y + h, z, color));
+		batch->addTriangle(0, PhGraphicBatch::NoBlend,
+		                   PhGraphicBatch::vertex(x + w, y + h, z, color),
+		                   PhGraphicBatch::vertex(x + w - nose, y + h, z, color),
+		                   PhGraphicBatch::vertex(x + w, y + h - nose, z, color));
 		break;
 	case UpLefToDownRight:
-		glBegin(GL_QUADS);
-		{
-			glVertex3i(this->x() + this->width() -thickness, this->y(), this->z());
-			glVertex3i(this->x(),      this->y() + this->height()-thickness,  this->z());
-			glVertex3i(this->x()+thickness,      this->y() + this->height(),  this->z());
-			glVertex3i(this->x() + this->width(), this->y()+thickness, this->z());
-		}
-		glEnd();
-		glBegin(GL_TRIANGLES);
-		{
-			glVertex3i(this->x() + this->width(), this->y(),  this->z());
-			glVertex3i(this->x() + this->width() - nose, this->y(),  this->z());
-			glVertex3i(this->x() + this->width(), this->y() + nose,  this->z());
-		}
-		glEnd();
+		batch->addQuad(0, PhGraphicBatch::NoBlend,
+		               PhGraphicBatch::vertex(x + w - thickness, y, z, color),
+		               PhGraphicBatch::vertex(x, y + h - thickness, z, color),
+		               PhGraphicBatch::vertex(x + thickness, y + h, z, color),
+		               PhGraphicBatch::vertex(x + w, y + thickness, z, color));
+		batch->addTriangle(0, PhGraphicBatch::NoBlend,
+		                   PhGraphicBatch::vertex(x + w, y, z, color),
+		                   PhGraphicBatch::vertex(x + w - nose, y, z, color),
+		                   PhGraphicBatch::vertex(x + w, y + nose, z, color));
 		break;
 	}
 }
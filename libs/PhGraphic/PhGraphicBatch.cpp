@@ -0,0 +1,287 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include <algorithm>
+#include <cstddef>
+
+#include <QMutex>
+
+#include "PhTools/PhDebug.h"
+
+#include "PhGraphicBatch.h"
+
+static const char *distanceFieldVertexShader =
+    "void main()\n"
+    "{\n"
+    "	gl_Position = ftransform();\n"
+    "	gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+    "	gl_FrontColor = gl_Color;\n"
+    "}\n";
+
+static const char *distanceFieldFragmentShader =
+    "uniform sampler2D atlas;\n"
+    "uniform float threshold;\n"
+    "uniform float outlineWidth;\n"
+    "uniform vec4 outlineColor;\n"
+    "uniform float invertColor;\n"
+    "void main()\n"
+    "{\n"
+    "	float distance = texture2D(atlas, gl_TexCoord[0].st).a;\n"
+    "	float smoothing = 0.5 * fwidth(distance);\n"
+    "	vec4 color = gl_Color;\n"
+    "	color.rgb = mix(color.rgb, vec3(1.0) - color.rgb, invertColor);\n"
+    "	float fill = smoothstep(threshold - smoothing, threshold + smoothing, distance);\n"
+    "	float edge = threshold - outlineWidth;\n"
+    "	float shape = smoothstep(edge - smoothing, edge + smoothing, distance);\n"
+    "	gl_FragColor = vec4(mix(outlineColor.rgb, color.rgb, fill), mix(outlineColor.a, color.a, fill) * shape);\n"
+    "}\n";
+
+PhGraphicBatch *PhGraphicBatch::instance()
+{
+	// The contexts may be current in different threads
+	static QMutex mutex;
+	static QHash<const QGLContext*, PhGraphicBatch*> batches;
+
+	const QGLContext *context = QGLContext::currentContext();
+	QMutexLocker locker(&mutex);
+	PhGraphicBatch *batch = batches.value(context, NULL);
+	if(batch == NULL) {
+		batch = new PhGraphicBatch();
+		batch->_context = context;
+		batches[context] = batch;
+
+		if(context) {
+			QObject::connect(context->contextHandle(), &QOpenGLContext::aboutToBeDestroyed, [context]() {
+				QMutexLocker locker(&mutex);
+				delete batches.take(context);
+			});
+		}
+	}
+	return batch;
+}
+
+PhGraphicBatch::PhGraphicBatch() :
+	_usedBucketCount(0),
+	_lastBucket(-1),
+	_vertexCount(0),
+	_drawnVertexCount(0),
+	_drawCount(0),
+	_context(NULL),
+	_buffer(0),
+	_distanceFieldProgram(NULL)
+{
+}
+
+PhGraphicBatch::~PhGraphicBatch()
+{
+	delete _distanceFieldProgram;
+}
+
+PhGraphicBatch::Vertex PhGraphicBatch::vertex(float x, float y, float z, QColor color, float u, float v)
+{
+	Vertex result;
+	result.x = x;
+	result.y = y;
+	result.z = z;
+	result.u = u;
+	result.v = v;
+	result.r = color.red();
+	result.g = color.green();
+	result.b = color.blue();
+	result.a = color.alpha();
+	return result;
+}
+
+void PhGraphicBatch::addTriangle(GLuint texture, BlendMode blend, const Vertex &v1, const Vertex &v2, const Vertex &v3)
+{
+	QVector<Vertex> &vertices = bucket(v1.z, texture, blend);
+	vertices.append(v1);
+	vertices.append(v2);
+	vertices.append(v3);
+	_vertexCount += 3;
+}
+
+void PhGraphicBatch::addQuad(GLuint texture, BlendMode blend, const Vertex &v1, const Vertex &v2, const Vertex &v3, const Vertex &v4)
+{
+	QVector<Vertex> &vertices = bucket(v1.z, texture, blend);
+	vertices.append(v1);
+	vertices.append(v2);
+	vertices.append(v3);
+	vertices.append(v1);
+	vertices.append(v3);
+	vertices.append(v4);
+	_vertexCount += 6;
+}
+
+void PhGraphicBatch::addRect(int x, int y, int z, int w, int h, QColor color)
+{
+	addQuad(0, NoBlend,
+	        vertex(x, y, z, color),
+	        vertex(x + w, y, z, color),
+	        vertex(x + w, y + h, z, color),
+	        vertex(x, y + h, z, color));
+}
+
+void PhGraphicBatch::setDistanceField(GLuint texture, const DistanceField &distanceField)
+{
+	_distanceFields[texture] = distanceField;
+}
+
+void PhGraphicBatch::flush()
+{
+	if(_vertexCount == 0)
+		return;
+
+	if(initializeBuffer()) {
+		// From back to front, in creation order for a given depth (see the class description)
+		QVector<int> order(_usedBucketCount);
+		for(int i = 0; i < _usedBucketCount; i++)
+			order[i] = i;
+		std::stable_sort(order.begin(), order.end(), [this](int index1, int index2) {
+			return _buckets[index1].z < _buckets[index2].z;
+		});
+
+		// All the buckets are sent in a single buffer
+		QGLFunctions &functions = _functions;
+		functions.glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+		functions.glBufferData(GL_ARRAY_BUFFER, _vertexCount * sizeof(Vertex), NULL, GL_STREAM_DRAW);
+		int first = 0;
+		foreach(int index, order) {
+			const QVector<Vertex> &vertices = _buckets[index].vertices;
+			functions.glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(Vertex), vertices.count() * sizeof(Vertex), vertices.constData());
+			first += vertices.count();
+		}
+
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+		glVertexPointer(3, GL_FLOAT, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, x)));
+		glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, u)));
+		glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, r)));
+
+		first = 0;
+		foreach(int index, order) {
+			const Bucket &bucket = _buckets[index];
+			if(bucket.texture) {
+				glEnable(GL_TEXTURE_2D);
+				glBindTexture(GL_TEXTURE_2D, bucket.texture);
+			}
+			else
+				glDisable(GL_TEXTURE_2D);
+
+			if(bucket.blend == PremultipliedAlphaBlend) {
+				glEnable(GL_BLEND);
+				glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+			}
+			else if(bucket.blend == DistanceFieldBlend) {
+				// The shader computes a straight alpha
+				glEnable(GL_BLEND);
+				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			}
+			else
+				glDisable(GL_BLEND);
+
+			QGLShaderProgram *program = NULL;
+			if(bucket.blend == DistanceFieldBlend) {
+				program = distanceFieldProgram();
+				if(program) {
+					DistanceField distanceField = _distanceFields.value(bucket.texture);
+					program->bind();
+					program->setUniformValue("atlas", 0);
+					program->setUniformValue("threshold", distanceField.threshold);
+					program->setUniformValue("outlineWidth", distanceField.outlineWidth);
+					program->setUniformValue("outlineColor", distanceField.outlineColor);
+					program->setUniformValue("invertColor", distanceField.invertColor ? 1.0f : 0.0f);
+				}
+			}
+
+			glDrawArrays(GL_TRIANGLES, first, bucket.vertices.count());
+			if(program)
+				program->release();
+			first += bucket.vertices.count();
+			_drawCount++;
+		}
+
+		glDisableClientState(GL_COLOR_ARRAY);
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+		glDisable(GL_BLEND);
+		glDisable(GL_TEXTURE_2D);
+		functions.glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		// The current color is undefined after using a color array
+		glColor4f(1, 1, 1, 1);
+
+		_drawnVertexCount += _vertexCount;
+	}
+	else
+		PHDEBUG << "No OpenGL context: dropping" << _vertexCount << "vertices";
+
+	// The buckets keep their memory for the next frame
+	for(int i = 0; i < _usedBucketCount; i++)
+		_buckets[i].vertices.resize(0);
+	_usedBucketCount = 0;
+	_lastBuckets.clear();
+	_lastBucket = -1;
+	_vertexCount = 0;
+}
+
+void PhGraphicBatch::resetCounters()
+{
+	_drawnVertexCount = 0;
+	_drawCount = 0;
+}
+
+QVector<PhGraphicBatch::Vertex> &PhGraphicBatch::bucket(GLfloat z, GLuint texture, BlendMode blend)
+{
+	// Consecutive primitives usually share the same state
+	int index = _lastBucket;
+	if((index < 0) || (_buckets[index].z != z) || (_buckets[index].texture != texture) || (_buckets[index].blend != blend)) {
+		// Joining an older bucket of the same depth would draw the primitive
+		// before the ones submitted since.
+		index = _lastBuckets.value(z, -1);
+		if((index < 0) || (_buckets[index].texture != texture) || (_buckets[index].blend != blend)) {
+			index = _usedBucketCount++;
+			if(index == _buckets.count())
+				_buckets.append(Bucket());
+			Bucket &bucket = _buckets[index];
+			bucket.z = z;
+			bucket.texture = texture;
+			bucket.blend = blend;
+			_lastBuckets[z] = index;
+		}
+		_lastBucket = index;
+	}
+
+	return _buckets[index].vertices;
+}
+
+bool PhGraphicBatch::initializeBuffer()
+{
+	if(_context == NULL)
+		return false;
+
+	if(_buffer == 0) {
+		_functions.initializeGLFunctions(_context);
+		_functions.glGenBuffers(1, &_buffer);
+	}
+	return true;
+}
+
+QGLShaderProgram *PhGraphicBatch::distanceFieldProgram()
+{
+	if(_distanceFieldProgram == NULL) {
+		_distanceFieldProgram = new QGLShaderProgram(_context);
+		if(!_distanceFieldProgram->addShaderFromSourceCode(QGLShader::Vertex, distanceFieldVertexShader)
+		   || !_distanceFieldProgram->addShaderFromSourceCode(QGLShader::Fragment, distanceFieldFragmentShader)
+		   || !_distanceFieldProgram->link())
+			PHDEBUG << "Unable to build the distance field shader:" << _distanceFieldProgram->log();
+	}
+
+	if(!_distanceFieldProgram->isLinked())
+		return NULL;
+	return _distanceFieldProgram;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef PHGRAPHICBATCH_H
+#define PHGRAPHICBATCH_H
+
+#include <QVector>
+#include <QHash>
+#include <QGLFunctions>
+#include <QGLShaderProgram>
+
+#include "PhGraphic.h"
+
+/**
+ * @brief Group the primitives drawn during a frame into a few draw calls
+ *
+ * Instead of issuing their own glBegin()/glEnd() sequence, the simple graphic
+ * objects (rectangles, loops, discs, glyphs, ...) append their triangles to a
+ * bucket corresponding to their depth, texture and blend mode. The buckets are
+ * sent to the graphic card in a single vertex buffer and drawn with one call
+ * each when flush() is called.
+ *
+ * PhGraphicView flushes the batch at the end of each paint. The objects which
+ * still draw by themselves (PhGraphicTexturedRect, PhGraphicYUVRect) flush it
+ * first so that the drawing order is preserved.
+ *
+ * Inside a flush, the buckets are drawn from the farthest depth to the nearest
+ * one, so that the blended textures (such as the text) are drawn over what lies
+ * behind them. At a given depth, where the GL_LEQUAL depth test lets the last
+ * primitive win, the submission order is kept: a primitive only joins the last
+ * bucket of its depth, and starts a new one if its texture or blend mode differ.
+ *
+ * The distance field buckets are drawn with a shader whose parameters
+ * are given per texture with setDistanceField().
+ */
+class PhGraphicBatch
+{
+public:
+	/**
+	 * @brief The blending applied to a bucket
+	 */
+	enum BlendMode {
+		/** The vertices color is written as is */
+		NoBlend,
+		/** The color is blended with the premultiplied alpha of the texture */
+		PremultipliedAlphaBlend,
+		/** The texture alpha is a distance field (see setDistanceField()) */
+		DistanceFieldBlend,
+	};
+
+	/**
+	 * @brief The shader parameters of a distance field texture
+	 *
+	 * The distances are normalized: the field goes from 0 to 1.
+	 */
+	struct DistanceField {
+		/** The distance of the edge */
+		float threshold;
+		/** The width of the outline drawn outside the edge */
+		float outlineWidth;
+		/** The outline color */
+		QColor outlineColor;
+		/** True to invert the vertices color */
+		bool invertColor;
+	};
+
+	/**
+	 * @brief A batched vertex
+	 */
+	struct Vertex {
+		/** Position */
+		GLfloat x, y, z;
+		/** Texture coordinate */
+		GLfloat u, v;
+		/** Color */
+		GLubyte r, g, b, a;
+	};
+
+	/**
+	 * @brief The batch of the current OpenGL context
+	 *
+	 * Each context has its own batch so that a view rendered by a dedicated
+	 * thread and an offscreen context never mix their primitives. It is
+	 * destroyed with the context.
+	 * @return A batch instance
+	 */
+	static PhGraphicBatch *instance();
+
+	/**
+	 * @brief Build a vertex
+	 * @param x The x coordinate
+	 * @param y The y coordinate
+	 * @param z The z coordinate
+	 * @param color The color
+	 * @param u The horizontal texture coordinate
+	 * @param v The vertical texture coordinate
+	 * @return A vertex
+	 */
+	static Vertex vertex(float x, float y, float z, QColor color, float u = 0, float v = 0);
+
+	/**
+	 * @brief Add a triangle to the batch
+	 *
+	 * The depth of the triangle is the one of its first vertex.
+	 * @param texture A texture name or 0 for an untextured triangle
+	 * @param blend The blend mode
+	 * @param v1 The first vertex
+	 * @param v2 The second vertex
+	 * @param v3 The third vertex
+	 */
+	void addTriangle(GLuint texture, BlendMode blend, const Vertex &v1, const Vertex &v2, const Vertex &v3);
+
+	/**
+	 * @brief Add a quad to the batch
+	 *
+	 * The vertices must be given in order around the quad.
+	 * @param texture A texture name or 0 for an untextured quad
+	 * @param blend The blend mode
+	 * @param v1 The first vertex
+	 * @param v2 The second vertex
+	 * @param v3 The third vertex
+	 * @param v4 The fourth vertex
+	 */
+	void addQuad(GLuint texture, BlendMode blend, const Vertex &v1, const Vertex &v2, const Vertex &v3, const Vertex &v4);
+
+	/**
+	 * @brief Add an untextured and opaque rectangle to the batch
+	 * @param x The left coordinate
+	 * @param y The top coordinate
+	 * @param z The z coordinate
+	 * @param w The width
+	 * @param h The height
+	 * @param color The color
+	 */
+	void addRect(int x, int y, int z, int w, int h, QColor color);
+
+	/**
+	 * @brief Set the parameters used to draw a distance field texture
+	 * @param texture A texture name
+	 * @param distanceField The shader parameters
+	 */
+	void setDistanceField(GLuint texture, const DistanceField &distanceField);
+
+	/**
+	 * @brief Draw the pending primitives in the current OpenGL context
+	 */
+	void flush();
+
+	/**
+	 * @brief The number of vertices drawn since the last resetCounters()
+	 * @return An integer value
+	 */
+	int drawnVertexCount() {
+		return _drawnVertexCount;
+	}
+
+	/**
+	 * @brief The number of draw calls issued since the last resetCounters()
+	 * @return An integer value
+	 */
+	int drawCount() {
+		return _drawCount;
+	}
+
+	/**
+	 * @brief Reset the vertices and draw calls counters
+	 */
+	void resetCounters();
+
+private:
+	PhGraphicBatch();
+
+	struct Bucket {
+		GLfloat z;
+		GLuint texture;
+		BlendMode blend;
+		QVector<Vertex> vertices;
+	};
+
+	~PhGraphicBatch();
+
+	QVector<Vertex> &bucket(GLfloat z, GLuint texture, BlendMode blend);
+	bool initializeBuffer();
+	QGLShaderProgram *distanceFieldProgram();
+
+	// The buckets of the frame are the first ones, in creation order.
+	// The following ones keep their memory for the next frames.
+	QVector<Bucket> _buckets;
+	int _usedBucketCount;
+	// The last bucket of each depth
+	QHash<GLfloat, int> _lastBuckets;
+	int _lastBucket;
+	int _vertexCount;
+	int _drawnVertexCount, _drawCount;
+	// The context owning the buffer and the shader (NULL for the batch used without context)
+	const QGLContext *_context;
+	QGLFunctions _functions;
+	GLuint _buffer;
+	QGLShaderProgram *_distanceFieldProgram;
+	QHash<GLuint, DistanceField> _distanceFields;
+};
+
+#endif // PHGRAPHICBATCH_H
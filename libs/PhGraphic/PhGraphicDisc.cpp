@@ -1,5 +1,6 @@
 #include "PhTools/PhGeneric.h"
 
+#include "PhGraphicBatch.h"
 #include "PhGraphicDisc.h"
 
 PhGraphicDisc::PhGraphicDisc(int x, int y, int radius, int resolution)
@@ -12,13 +13,16 @@ PhGraphicDisc::PhGraphicDisc(int x, int y, int radius, int resolution)
 
 void PhGraphicDisc::draw()
 {
-	glBegin(GL_TRIANGLE_FAN);
-	{
-		glVertex3f( this->x(), this->y(), this->z());
-		for( int i = 0; i <= _resolution; i++ ) {
-			float angle = i * 2 * M_PI / _resolution;
-			glVertex3f( this->x() + sin( angle ) * _radius, this->y() + cos( angle ) * _radius, this->z());
-		}
+	PhGraphicBatch *batch = PhGraphicBatch::instance();
+	QColor color = this->color();
+
+	// The triangle fan is split into independent triangles
+	PhGraphicBatch::Vertex center = PhGraphicBatch::vertex(this->x(), this->y(), this->z(), color);
+	PhGraphicBatch::Vertex previous = PhGraphicBatch::vertex(this->x(), this->y() + _radius, this->z(), color);
+	for( int i = 1; i <= _resolution; i++ ) {
+		float angle = i * 2 * M_PI / _resolution;
+		PhGraphicBatch::Vertex current = PhGraphicBatch::vertex(this->x() + sin( angle ) * _radius, this->y() + cos( angle ) * _radius, this->z(), color);
+		batch->addTriangle(0, PhGraphicBatch::NoBlend, center, previous, current);
+		previous = current;
 	}
-	glEnd();
 }
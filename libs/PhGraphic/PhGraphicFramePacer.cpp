@@ -0,0 +1,75 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include "PhGraphicFramePacer.h"
+
+/**
+ * @brief Integer division rounded toward negative infinity
+ * @param value A value
+ * @param divisor A positive divisor
+ * @return The quotient
+ */
+static qint64 floorDiv(qint64 value, qint64 divisor)
+{
+	return (value >= 0) ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+PhGraphicFramePacer::PhGraphicFramePacer(double frequency)
+{
+	setFrequency(frequency);
+}
+
+void PhGraphicFramePacer::setFrequency(double frequency)
+{
+	if(frequency <= 0)
+		frequency = 60;
+	_nominalPeriod = static_cast<qint64>(1000000000.0 / frequency);
+	_period = _nominalPeriod;
+	_phase = 0;
+	_locked = false;
+	_missedCount = 0;
+}
+
+void PhGraphicFramePacer::addSwap(qint64 time)
+{
+	if(!_locked) {
+		_phase = time;
+		_locked = true;
+		return;
+	}
+
+	// The grid instant closest to the swap
+	qint64 n = floorDiv(time - _phase + _period / 2, _period);
+	// Several swaps in the same period: the swap is not synchronized
+	if(n <= 0)
+		return;
+
+	qint64 expected = _phase + n * _period;
+	qint64 error = time - expected;
+
+	// Too far from the grid: the synchronization is lost, start again from this swap
+	if(qAbs(error) > _period / 4) {
+		_phase = time;
+		_period = _nominalPeriod;
+		return;
+	}
+
+	_missedCount += n - 1;
+
+	// Follow the swaps slowly so that their jitter does not reach the display times
+	_phase = expected + error / 8;
+	_period += error / (16 * n);
+	_period = qBound(_nominalPeriod * 9 / 10, _period, _nominalPeriod * 11 / 10);
+}
+
+qint64 PhGraphicFramePacer::displayTime(qint64 paintTime) const
+{
+	if(!_locked)
+		return paintTime + _period;
+
+	qint64 n = floorDiv(paintTime - _phase + _period / 2, _period);
+	return _phase + (n + 1) * _period;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef PHGRAPHICFRAMEPACER_H
+#define PHGRAPHICFRAMEPACER_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Predict when the rendered frames reach the screen
+ *
+ * The pacer follows the vertical synchronization grid of the screen from the
+ * instants where the buffer swaps return. The grid phase and period are
+ * corrected a little on each swap so that the jitter of the swap timestamps
+ * is smoothed out.
+ *
+ * The display time of a frame is the grid instant following the one closest
+ * to the start of its paint: a paint starting right after a swap is shown
+ * on the next vertical synchronization. Since it is always a multiple of the
+ * period, the clock advanced from one display time to the other moves by
+ * steady steps, and by a whole number of periods when a frame is dropped.
+ *
+ * All the times are expressed in nanoseconds from an arbitrary origin.
+ */
+class PhGraphicFramePacer
+{
+public:
+	/**
+	 * @brief PhGraphicFramePacer constructor
+	 * @param frequency The nominal screen frequency in hertz
+	 */
+	explicit PhGraphicFramePacer(double frequency = 60);
+
+	/**
+	 * @brief Reset the grid and set the nominal screen frequency
+	 * @param frequency A frequency in hertz
+	 */
+	void setFrequency(double frequency);
+
+	/**
+	 * @brief Record the instant where a buffer swap returned
+	 * @param time A time in nanoseconds
+	 */
+	void addSwap(qint64 time);
+
+	/**
+	 * @brief The predicted display time of a frame
+	 * @param paintTime The time where the frame paint starts
+	 * @return A time in nanoseconds
+	 */
+	qint64 displayTime(qint64 paintTime) const;
+
+	/**
+	 * @brief The estimated refresh period
+	 * @return A duration in nanoseconds
+	 */
+	qint64 period() const {
+		return _period;
+	}
+
+	/**
+	 * @brief The number of grid instants skipped between two swaps
+	 * @return An integer value
+	 */
+	int missedCount() const {
+		return _missedCount;
+	}
+
+private:
+	qint64 _nominalPeriod;
+	qint64 _period;
+	qint64 _phase;
+	bool _locked;
+	int _missedCount;
+};
+
+#endif // PHGRAPHICFRAMEPACER_H
@@ -5,6 +5,7 @@
  */
 
 #include "math.h"
+#include "PhGraphicBatch.h"
 #include "PhGraphicLoop.h"
 
 PhGraphicLoop::PhGraphicLoop(int x, int y, int w, int h, int crossSize, int thickness, bool isHorizontal) :
@@ -17,7 +18,8 @@ PhGraphicLoop::PhGraphicLoop(int x, int y, int w, int h, int crossSize, int thic
 
 void PhGraphicLoop::draw()
 {
-	PhGraphicRect::draw();
+	PhGraphicBatch *batch = PhGraphicBatch::instance();
+	QColor color = this->color();
 
 	int x = this->x() - _thickness / 2;
 	int y = this->y();
@@ -33,37 +35,32 @@ void PhGraphicLoop::draw()
 	}
 
 	// Draw the main rectangle
-	glBegin(GL_QUADS);  // draw the vertical line
-	{
-		glVertex3i(x,     y,     z);
-		glVertex3i(x + w, y,     z);
-		glVertex3i(x + w, y + h, z);
-		glVertex3i(x,     y + h, z);
+	batch->addRect(x, y, z, w, h, color);
 
-		x = this->x();
-		y = this->y() + this->height() / 2;
+	x = this->x();
+	y = this->y() + this->height() / 2;
 
-		if(_isHorizontal) {
-			x = this->x() + this->width() / 2;
-			y = this->y();
-		}
+	if(_isHorizontal) {
+		x = this->x() + this->width() / 2;
+		y = this->y();
+	}
 
-		int hcs = _crossSize / 2; // half cross size
-		int ht = _thickness / 3; // half thickness;
+	int hcs = _crossSize / 2; // half cross size
+	int ht = _thickness / 3; // half thickness;
 
-		// draw the fist cross segment
-		glVertex3i(x - hcs + ht, y - hcs - ht, z);
-		glVertex3i(x - hcs - ht, y - hcs + ht, z);
-		glVertex3i(x + hcs - ht, y + hcs + ht, z);
-		glVertex3i(x + hcs + ht, y + hcs - ht, z);
+	// draw the fist cross segment
+	batch->addQuad(0, PhGraphicBatch::NoBlend,
+	               PhGraphicBatch::vertex(x - hcs + ht, y - hcs - ht, z, color),
+	               PhGraphicBatch::vertex(x - hcs - ht, y - hcs + ht, z, color),
+	               PhGraphicBatch::vertex(x + hcs - ht, y + hcs + ht, z, color),
+	               PhGraphicBatch::vertex(x + hcs + ht, y + hcs - ht, z, color));
 
-		// draw the second cross segment
-		glVertex3i(x + hcs - ht, y - hcs - ht, z);
-		glVertex3i(x + hcs + ht, y - hcs + ht, z);
-		glVertex3i(x - hcs + ht, y + hcs + ht, z);
-		glVertex3i(x - hcs - ht, y + hcs - ht, z);
-	}
-	glEnd();
+	// draw the second cross segment
+	batch->addQuad(0, PhGraphicBatch::NoBlend,
+	               PhGraphicBatch::vertex(x + hcs - ht, y - hcs - ht, z, color),
+	               PhGraphicBatch::vertex(x + hcs + ht, y - hcs + ht, z, color),
+	               PhGraphicBatch::vertex(x - hcs + ht, y + hcs + ht, z, color),
+	               PhGraphicBatch::vertex(x - hcs - ht, y + hcs - ht, z, color));
 }
 
 void PhGraphicLoop::setThickness(int thickness)
@@ -0,0 +1,103 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include "PhTools/PhDebug.h"
+
+#include "PhGraphicView.h"
+#include "PhGraphicBatch.h"
+#include "PhGraphicOffscreen.h"
+
+PhGraphicOffscreen::PhGraphicOffscreen(int width, int height, QObject *parent)
+	: QObject(parent),
+	_framebuffer(NULL),
+	_width(0),
+	_height(0)
+{
+	if (SDL_Init(SDL_INIT_VIDEO) != 0)
+		PHDEBUG << "SDL error:" << SDL_GetError();
+	if (TTF_Init() != 0)
+		PHDEBUG << "TTF error:" << TTF_GetError();
+
+	// The graphic objects use the fixed pipeline
+	QSurfaceFormat format;
+	format.setVersion(2, 1);
+	format.setProfile(QSurfaceFormat::CompatibilityProfile);
+	format.setDepthBufferSize(24);
+
+	_surface.setFormat(format);
+	_surface.create();
+
+	_context.setFormat(format);
+	if(!_context.create()) {
+		PHDEBUG << "Unable to create the offscreen context";
+		return;
+	}
+
+	setSize(width, height);
+}
+
+PhGraphicOffscreen::~PhGraphicOffscreen()
+{
+	if(makeCurrent())
+		delete _framebuffer;
+	doneCurrent();
+	TTF_Quit();
+	SDL_Quit();
+}
+
+bool PhGraphicOffscreen::isValid()
+{
+	return _framebuffer && _framebuffer->isValid();
+}
+
+void PhGraphicOffscreen::setSize(int width, int height)
+{
+	if((width == _width) && (height == _height) && _framebuffer)
+		return;
+
+	if(!makeCurrent())
+		return;
+
+	delete _framebuffer;
+	_framebuffer = new QOpenGLFramebufferObject(width, height, QOpenGLFramebufferObject::Depth);
+	_width = width;
+	_height = height;
+	if(!_framebuffer->isValid())
+		PHDEBUG << "Unable to create the offscreen framebuffer" << width << height;
+}
+
+bool PhGraphicOffscreen::makeCurrent()
+{
+	return _context.isValid() && _context.makeCurrent(&_surface);
+}
+
+void PhGraphicOffscreen::doneCurrent()
+{
+	if(_context.isValid())
+		_context.doneCurrent();
+}
+
+QImage PhGraphicOffscreen::render(PhTime elapsedTime)
+{
+	if(!isValid() || !makeCurrent())
+		return QImage();
+
+	_framebuffer->bind();
+	PhGraphicView::setupProjection(_width, _height);
+	glClearColor(0, 0, 0, 1);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	emit beforePaint(elapsedTime);
+	emit paint(_width, _height);
+	PhGraphicBatch::instance()->flush();
+
+	// The picture is read once everything is drawn
+	glFinish();
+	QImage image = _framebuffer->toImage().convertToFormat(QImage::Format_RGB32);
+	_framebuffer->release();
+
+	return image;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef PHGRAPHICOFFSCREEN_H
+#define PHGRAPHICOFFSCREEN_H
+
+#include <QObject>
+#include <QImage>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+
+#include "PhSync/PhTime.h"
+
+/**
+ * @brief A render target without window
+ *
+ * The offscreen target owns an OpenGL context bound to an offscreen
+ * surface (a pbuffer or an EGL surface depending on the platform, which
+ * can be provided by Mesa llvmpipe on a machine without display). It
+ * emits the same beforePaint() and paint() signals as PhGraphicView, so that
+ * the same drawing code can be connected to both.
+ *
+ * The frames are rendered synchronously into a framebuffer object by
+ * render() which returns the resulting picture. Nothing depends on the
+ * screen refresh: the time elapsed between two frames is given by the
+ * caller.
+ *
+ * The context is left current after the construction and each render(),
+ * so that the graphic objects can be created and disposed in between.
+ */
+class PhGraphicOffscreen : public QObject
+{
+	Q_OBJECT
+public:
+	/**
+	 * @brief PhGraphicOffscreen constructor
+	 * @param width The picture width
+	 * @param height The picture height
+	 * @param parent The parent object
+	 */
+	PhGraphicOffscreen(int width, int height, QObject *parent = 0);
+
+	~PhGraphicOffscreen();
+
+	/**
+	 * @brief Whether the context and the framebuffer were created
+	 * @return True if the target can render
+	 */
+	bool isValid();
+
+	/**
+	 * @brief The picture width
+	 * @return A width in pixel
+	 */
+	int width() {
+		return _width;
+	}
+
+	/**
+	 * @brief The picture height
+	 * @return A height in pixel
+	 */
+	int height() {
+		return _height;
+	}
+
+	/**
+	 * @brief Change the picture size
+	 * @param width A width in pixel
+	 * @param height A height in pixel
+	 */
+	void setSize(int width, int height);
+
+	/**
+	 * @brief Make the target context current in the calling thread
+	 * @return True if succeeded
+	 */
+	bool makeCurrent();
+
+	/**
+	 * @brief Release the target context
+	 */
+	void doneCurrent();
+
+	/**
+	 * @brief Render a frame
+	 *
+	 * beforePaint() and paint() are emitted and the batch is flushed before
+	 * the picture is read back.
+	 * @param elapsedTime The time elapsed since the previous frame
+	 * @return A picture or a null image if the target is not valid
+	 */
+	QImage render(PhTime elapsedTime = 0);
+
+signals:
+	/**
+	 * @brief Emitted before paint() with the time elapsed since the previous frame
+	 * @param elapsedTime A time value
+	 */
+	void beforePaint(PhTime elapsedTime);
+
+	/**
+	 * @brief Emitted when the frame must be drawn
+	 * @param width The picture width
+	 * @param height The picture height
+	 */
+	void paint(int width, int height);
+
+private:
+	QOffscreenSurface _surface;
+	QOpenGLContext _context;
+	QOpenGLFramebufferObject *_framebuffer;
+	int _width, _height;
+};
+
+#endif // PHGRAPHICOFFSCREEN_H
@@ -0,0 +1,442 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include <QFile>
+#include <QTextStream>
+#include <QThread>
+
+#include "PhTools/PhDebug.h"
+
+#include "PhGraphicBatch.h"
+#include "PhGraphicProfiler.h"
+
+#ifndef GL_TIMESTAMP
+#define GL_TIMESTAMP 0x8E28
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+
+/** The query functions are not part of QGLFunctions */
+typedef void (APIENTRY *PhGenQueriesFunction)(GLsizei n, GLuint *ids);
+typedef void (APIENTRY *PhQueryCounterFunction)(GLuint id, GLenum target);
+typedef void (APIENTRY *PhGetQueryObjectivFunction)(GLuint id, GLenum pname, GLint *params);
+typedef void (APIENTRY *PhGetQueryObjectui64vFunction)(GLuint id, GLenum pname, quint64 *params);
+static PhGenQueriesFunction phGenQueries = NULL;
+static PhQueryCounterFunction phQueryCounter = NULL;
+static PhGetQueryObjectivFunction phGetQueryObjectiv = NULL;
+static PhGetQueryObjectui64vFunction phGetQueryObjectui64v = NULL;
+
+/** State of the timer queries initialization */
+enum {
+	QueryUninitialized,
+	QueryReady,
+	QueryUnsupported
+};
+
+/** The number of frames averaged by averageTime() */
+#define PHGRAPHICPROFILER_AVERAGE_COUNT 60
+/** The number of recent frames whose GPU time may not be known yet */
+#define PHGRAPHICPROFILER_LATENCY_COUNT 4
+
+/** The color of each stage in the graph */
+static const QRgb stageColors[PhGraphicProfiler::StageCount] = {
+	0xe6194b, // decode
+	0xf58231, // convert
+	0xffe119, // upload
+	0x3cb44b, // background
+	0x4363d8, // text
+	0x911eb4, // detect
+	0x42d4f4, // hud
+	0xf032e6  // overlay
+};
+
+PhGraphicProfiler *PhGraphicProfiler::instance()
+{
+	static PhGraphicProfiler profiler;
+	return &profiler;
+}
+
+QString PhGraphicProfiler::stageName(Stage stage)
+{
+	switch(stage) {
+	case VideoDecodeStage:
+		return "decode";
+	case VideoConvertStage:
+		return "convert";
+	case VideoUploadStage:
+		return "upload";
+	case StripBackgroundStage:
+		return "background";
+	case StripTextStage:
+		return "text";
+	case StripDetectStage:
+		return "detect";
+	case StripHudStage:
+		return "hud";
+	case OverlayStage:
+		return "overlay";
+	default:
+		return "";
+	}
+}
+
+PhGraphicProfiler::PhGraphicProfiler() :
+	_enabled(0),
+	_events(PHGRAPHICPROFILER_EVENT_COUNT),
+	_frames(PHGRAPHICPROFILER_FRAME_COUNT),
+	_eventCount(0),
+	_firstEvent(0),
+	_frameCount(0),
+	_firstFrame(0),
+	_paintThread(NULL),
+	_queryState(QueryUninitialized),
+	_queryContext(NULL)
+{
+	for(int i = 0; i < StageCount; i++) {
+		_stageStart[i] = -1;
+		_stageQueries[i].begin = 0;
+	}
+	_timer.start();
+}
+
+void PhGraphicProfiler::setEnabled(bool enabled)
+{
+	if(enabled && !this->enabled()) {
+		QMutexLocker locker(&_mutex);
+		_firstEvent = _eventCount;
+		_firstFrame = _frameCount;
+	}
+	_enabled.store(enabled ? 1 : 0);
+}
+
+bool PhGraphicProfiler::initQueries()
+{
+	const QGLContext *context = QGLContext::currentContext();
+	if(_queryState == QueryUninitialized) {
+		_queryState = QueryUnsupported;
+		if(context == NULL)
+			return false;
+
+		// The timestamp queries are not provided by GL_EXT_timer_query
+		QString extensions(reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS)));
+		if(!(context->format().openGLVersionFlags() & QGLFormat::OpenGL_Version_3_3)
+		   && !extensions.contains("GL_ARB_timer_query"))
+			return false;
+
+		phGenQueries = (PhGenQueriesFunction)context->getProcAddress("glGenQueries");
+		phQueryCounter = (PhQueryCounterFunction)context->getProcAddress("glQueryCounter");
+		phGetQueryObjectiv = (PhGetQueryObjectivFunction)context->getProcAddress("glGetQueryObjectiv");
+		phGetQueryObjectui64v = (PhGetQueryObjectui64vFunction)context->getProcAddress("glGetQueryObjectui64v");
+		if((phGenQueries == NULL) || (phQueryCounter == NULL)
+		   || (phGetQueryObjectiv == NULL) || (phGetQueryObjectui64v == NULL))
+			return false;
+
+		_freeQueries.resize(PHGRAPHICPROFILER_QUERY_COUNT);
+		phGenQueries(PHGRAPHICPROFILER_QUERY_COUNT, _freeQueries.data());
+		_queryContext = context;
+		PHDEBUG << "Using the timer queries";
+		_queryState = QueryReady;
+	}
+
+	// The queries belong to the context they were created with
+	return (_queryState == QueryReady) && (context == _queryContext);
+}
+
+void PhGraphicProfiler::collectQueries()
+{
+	if(_pendingQueries.isEmpty() || !initQueries())
+		return;
+
+	// The queries are pending from the end of their stage: they complete in that order
+	int count = 0;
+	foreach(const Query &query, _pendingQueries) {
+		GLint available = 0;
+		phGetQueryObjectiv(query.end, GL_QUERY_RESULT_AVAILABLE, &available);
+		if(!available)
+			break;
+
+		quint64 begin = 0, end = 0;
+		phGetQueryObjectui64v(query.begin, GL_QUERY_RESULT, &begin);
+		phGetQueryObjectui64v(query.end, GL_QUERY_RESULT, &end);
+		qint64 duration = (end > begin) ? static_cast<qint64>(end - begin) : 0;
+		{
+			QMutexLocker locker(&_mutex);
+			if(query.event >= qMax(_firstEvent, _eventCount - PHGRAPHICPROFILER_EVENT_COUNT))
+				_events[query.event % PHGRAPHICPROFILER_EVENT_COUNT].gpuDuration = duration;
+			Frame *f = frame(query.frame);
+			if(f)
+				f->gpuTime[query.stage] += duration;
+		}
+		_freeQueries.append(query.begin);
+		_freeQueries.append(query.end);
+		count++;
+	}
+	_pendingQueries.remove(0, count);
+}
+
+PhGraphicProfiler::Frame *PhGraphicProfiler::frame(qint64 index)
+{
+	if((index < 0) || (index >= _frameCount) || (index < qMax(_firstFrame, _frameCount - PHGRAPHICPROFILER_FRAME_COUNT)))
+		return NULL;
+	return &_frames[index % PHGRAPHICPROFILER_FRAME_COUNT];
+}
+
+int PhGraphicProfiler::currentThread()
+{
+	Qt::HANDLE handle = QThread::currentThreadId();
+	if(handle == _paintThread)
+		return 0;
+
+	// The other threads are numbered in the order they appear
+	int thread = _threads.indexOf(handle) + 1;
+	if(thread == 0) {
+		_threads.append(handle);
+		QString name = QThread::currentThread()->objectName();
+		_threadNames.append(name.isEmpty() ? QString("thread %1").arg(_threads.count()) : name);
+		thread = _threads.count();
+	}
+	return thread;
+}
+
+qint64 PhGraphicProfiler::addEvent(Stage stage, int thread, qint64 start, qint64 duration)
+{
+	Event &event = _events[_eventCount % PHGRAPHICPROFILER_EVENT_COUNT];
+	event.stage = stage;
+	event.thread = thread;
+	event.start = start;
+	event.duration = duration;
+	event.gpuDuration = -1;
+
+	Frame *f = frame(_frameCount - 1);
+	if(f) {
+		if(thread == 0)
+			f->cpuTime[stage] += duration;
+		else
+			f->threadTime[stage] += duration;
+	}
+
+	return _eventCount++;
+}
+
+void PhGraphicProfiler::beginFrame()
+{
+	collectQueries();
+
+	if(!enabled())
+		return;
+
+	qint64 time = now();
+	QMutexLocker locker(&_mutex);
+	_paintThread = QThread::currentThreadId();
+	Frame *previous = frame(_frameCount - 1);
+	if(previous)
+		previous->duration = time - previous->start;
+
+	Frame &f = _frames[_frameCount % PHGRAPHICPROFILER_FRAME_COUNT];
+	f.start = time;
+	f.duration = 0;
+	for(int i = 0; i < StageCount; i++) {
+		f.cpuTime[i] = 0;
+		f.gpuTime[i] = 0;
+		f.threadTime[i] = 0;
+	}
+	_frameCount++;
+}
+
+void PhGraphicProfiler::begin(Stage stage)
+{
+	if(!enabled() || (_stageStart[stage] >= 0))
+		return;
+
+	// The primitives of the previous stage are not counted with this one
+	PhGraphicBatch::instance()->flush();
+
+	if(initQueries() && (_freeQueries.count() >= 2)) {
+		Query &query = _stageQueries[stage];
+		query.begin = _freeQueries.takeLast();
+		query.end = _freeQueries.takeLast();
+		query.stage = stage;
+		phQueryCounter(query.begin, GL_TIMESTAMP);
+	}
+
+	_stageStart[stage] = now();
+}
+
+void PhGraphicProfiler::end(Stage stage)
+{
+	if(_stageStart[stage] < 0)
+		return;
+
+	PhGraphicBatch::instance()->flush();
+
+	qint64 start = _stageStart[stage];
+	_stageStart[stage] = -1;
+
+	QMutexLocker locker(&_mutex);
+	qint64 event = addEvent(stage, 0, start, now() - start);
+
+	Query &query = _stageQueries[stage];
+	if(query.begin) {
+		phQueryCounter(query.end, GL_TIMESTAMP);
+		query.event = event;
+		query.frame = _frameCount - 1;
+		_pendingQueries.append(query);
+		query.begin = 0;
+	}
+}
+
+void PhGraphicProfiler::addSample(Stage stage, qint64 start, qint64 duration)
+{
+	if(!enabled())
+		return;
+
+	QMutexLocker locker(&_mutex);
+	addEvent(stage, currentThread(), start, duration);
+}
+
+qint64 PhGraphicProfiler::averageTime(Stage stage, bool gpu)
+{
+	QMutexLocker locker(&_mutex);
+
+	// The last frames are skipped: their GPU time may still be pending
+	qint64 last = _frameCount - PHGRAPHICPROFILER_LATENCY_COUNT;
+	qint64 total = 0;
+	int count = 0;
+	bool measured = false;
+	for(qint64 index = last - PHGRAPHICPROFILER_AVERAGE_COUNT; index < last; index++) {
+		Frame *f = frame(index);
+		if(f == NULL)
+			continue;
+		qint64 time = gpu ? f->gpuTime[stage] : f->cpuTime[stage] + f->threadTime[stage];
+		total += time;
+		measured |= (time > 0);
+		count++;
+	}
+
+	if(!measured)
+		return -1;
+	return total / count;
+}
+
+void PhGraphicProfiler::draw(int x, int y, int width, int height, qint64 budget)
+{
+	if(budget <= 0)
+		return;
+
+	QMutexLocker locker(&_mutex);
+
+	PhGraphicBatch *batch = PhGraphicBatch::instance();
+	batch->addRect(x, y, 8, width, height, Qt::black);
+	// The budget line
+	batch->addRect(x, y + height / 2, 10, width, 1, Qt::red);
+
+	// Three pixels per frame, the most recent on the right
+	int columnWidth = 3;
+	qint64 index = _frameCount - 1;
+	for(int columnX = x + width - columnWidth; columnX >= x; columnX -= columnWidth, index--) {
+		Frame *f = frame(index);
+		if(f == NULL)
+			break;
+
+		int duration = qMin<qint64>(height, f->duration * height / (2 * budget));
+		batch->addRect(columnX, y + height - duration, 9, columnWidth, duration, Qt::darkGray);
+
+		int cpuY = y + height;
+		int gpuY = y + height;
+		int threadY = y + height;
+		for(int stage = 0; stage < StageCount; stage++) {
+			QColor color(stageColors[stage]);
+
+			int cpuHeight = f->cpuTime[stage] * height / (2 * budget);
+			cpuHeight = qMin(cpuHeight, cpuY - y);
+			cpuY -= cpuHeight;
+			if(cpuHeight > 0)
+				batch->addRect(columnX, cpuY, 10, 1, cpuHeight, color);
+
+			int gpuHeight = f->gpuTime[stage] * height / (2 * budget);
+			gpuHeight = qMin(gpuHeight, gpuY - y);
+			gpuY -= gpuHeight;
+			if(gpuHeight > 0)
+				batch->addRect(columnX + 1, gpuY, 10, 1, gpuHeight, color);
+
+			int threadHeight = f->threadTime[stage] * height / (2 * budget);
+			threadHeight = qMin(threadHeight, threadY - y);
+			threadY -= threadHeight;
+			if(threadHeight > 0)
+				batch->addRect(columnX + 2, threadY, 10, 1, threadHeight, color);
+		}
+	}
+}
+
+/**
+ * @brief Convert a profiler time into a trace timestamp
+ * @param time A time in nanoseconds
+ * @return A string in microseconds
+ */
+static QString traceTime(qint64 time)
+{
+	return QString::number(time / 1000.0, 'f', 3);
+}
+
+bool PhGraphicProfiler::saveTrace(QString fileName)
+{
+	PHDEBUG << fileName;
+
+	QFile file(fileName);
+	if(!file.open(QFile::WriteOnly | QFile::Text)) {
+		PHDEBUG << "Unable to open" << fileName;
+		return false;
+	}
+
+	// One track per thread, and one for the graphic card
+	enum {
+		PaintTrack = 1,
+		GpuTrack,
+		FirstThreadTrack
+	};
+
+	QStringList traceEvents;
+	traceEvents.append(QString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%1,\"args\":{\"name\":\"paint\"}}").arg(PaintTrack));
+	traceEvents.append(QString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%1,\"args\":{\"name\":\"gpu\"}}").arg(GpuTrack));
+
+	{
+		QMutexLocker locker(&_mutex);
+
+		for(int i = 0; i < _threadNames.count(); i++)
+			traceEvents.append(QString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%1,\"args\":{\"name\":\"%2\"}}")
+			                   .arg(FirstThreadTrack + i).arg(_threadNames[i]));
+
+		for(qint64 index = qMax(_firstFrame, _frameCount - PHGRAPHICPROFILER_FRAME_COUNT); index < _frameCount; index++) {
+			const Frame &f = _frames[index % PHGRAPHICPROFILER_FRAME_COUNT];
+			if(f.duration <= 0)
+				continue;
+			traceEvents.append(QString("{\"name\":\"frame\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%1,\"dur\":%2,\"pid\":1,\"tid\":%3}")
+			                   .arg(traceTime(f.start)).arg(traceTime(f.duration)).arg(PaintTrack));
+		}
+
+		for(qint64 index = qMax(_firstEvent, _eventCount - PHGRAPHICPROFILER_EVENT_COUNT); index < _eventCount; index++) {
+			const Event &event = _events[index % PHGRAPHICPROFILER_EVENT_COUNT];
+			QString name = stageName(event.stage);
+			traceEvents.append(QString("{\"name\":\"%1\",\"cat\":\"cpu\",\"ph\":\"X\",\"ts\":%2,\"dur\":%3,\"pid\":1,\"tid\":%4}")
+			                   .arg(name).arg(traceTime(event.start)).arg(traceTime(event.duration))
+			                   .arg(event.thread ? FirstThreadTrack + event.thread - 1 : PaintTrack));
+			if(event.gpuDuration >= 0)
+				traceEvents.append(QString("{\"name\":\"%1\",\"cat\":\"gpu\",\"ph\":\"X\",\"ts\":%2,\"dur\":%3,\"pid\":1,\"tid\":%4}")
+				                   .arg(name).arg(traceTime(event.start)).arg(traceTime(event.gpuDuration)).arg(GpuTrack));
+		}
+	}
+
+	QTextStream stream(&file);
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	stream << traceEvents.join(",\n");
+	stream << "\n]}\n";
+
+	return stream.status() == QTextStream::Ok;
+}
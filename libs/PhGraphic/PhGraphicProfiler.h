@@ -0,0 +1,246 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef PHGRAPHICPROFILER_H
+#define PHGRAPHICPROFILER_H
+
+#include <QVector>
+#include <QStringList>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+
+#include "PhGraphic.h"
+
+/** The number of frames kept by the profiler (10 seconds at 60 Hz) */
+#define PHGRAPHICPROFILER_FRAME_COUNT 600
+/** The number of stage samples kept by the profiler */
+#define PHGRAPHICPROFILER_EVENT_COUNT 8192
+/** The number of timestamp queries waiting for their result at most (two per stage) */
+#define PHGRAPHICPROFILER_QUERY_COUNT 64
+
+/**
+ * @brief Measure the time spent in each stage of the frames
+ *
+ * The stages drawn by the paint are surrounded by begin() and end()
+ * (or a PhGraphicProfilerScope) which record their CPU time and, when the
+ * OpenGL context supports the timestamp queries, their GPU time. A query is
+ * issued at each limit of a stage, so the stages can be nested. The batch is
+ * flushed at the limits of the stages so that their primitives are counted
+ * with them: the profiling adds a few draw calls per frame.
+ *
+ * The stages running in other threads, such as the decoder, are recorded
+ * with addSample(). Their time is kept apart from the CPU time of the paint.
+ *
+ * The samples are kept in a ring buffer covering the last frames. They are
+ * shown as a graph by draw() and exported to the chrome://tracing format
+ * by saveTrace().
+ *
+ * Nothing is recorded while the profiler is disabled, which is the default.
+ */
+class PhGraphicProfiler
+{
+public:
+	/**
+	 * @brief The profiled stages
+	 */
+	enum Stage {
+		/** Decoding a video frame (decoder thread) */
+		VideoDecodeStage,
+		/** Converting a decoded frame (decoder thread) */
+		VideoConvertStage,
+		/** Uploading a frame to the video texture */
+		VideoUploadStage,
+		/** The strip background, ruler, cuts and loops */
+		StripBackgroundStage,
+		/** The strip texts */
+		StripTextStage,
+		/** The strip detects */
+		StripDetectStage,
+		/** The strip sync bar, next texts and vertical scale */
+		StripHudStage,
+		/** The information panel and the debug overlay */
+		OverlayStage,
+		StageCount
+	};
+
+	/**
+	 * @brief The profiler shared by the application
+	 * @return A profiler instance
+	 */
+	static PhGraphicProfiler *instance();
+
+	/**
+	 * @brief The name of a stage
+	 * @param stage A stage
+	 * @return A string
+	 */
+	static QString stageName(Stage stage);
+
+	/**
+	 * @brief Enable or disable the recording
+	 *
+	 * The previous samples are discarded when the profiler is enabled.
+	 * @param enabled True to record the samples
+	 */
+	void setEnabled(bool enabled);
+
+	/**
+	 * @brief Whether the samples are recorded
+	 * @return True if enabled
+	 */
+	bool enabled() const {
+		return _enabled.load() != 0;
+	}
+
+	/**
+	 * @brief The profiler time
+	 * @return A time in nanoseconds
+	 */
+	qint64 now() const {
+		return _timer.nsecsElapsed();
+	}
+
+	/**
+	 * @brief Start a new frame
+	 *
+	 * It must be called from the paint thread with the context current:
+	 * it also collects the results of the previous timer queries.
+	 */
+	void beginFrame();
+
+	/**
+	 * @brief Start a stage of the current frame
+	 * @param stage A stage drawn by the paint thread
+	 */
+	void begin(Stage stage);
+
+	/**
+	 * @brief End a stage started with begin()
+	 * @param stage The stage
+	 */
+	void end(Stage stage);
+
+	/**
+	 * @brief Record a stage measured by another thread
+	 * @param stage A stage
+	 * @param start The stage start as given by now()
+	 * @param duration The stage duration in nanoseconds
+	 */
+	void addSample(Stage stage, qint64 start, qint64 duration);
+
+	/**
+	 * @brief The average time of a stage over the last frames
+	 * @param stage A stage
+	 * @param gpu True for the GPU time, false for the CPU time of the thread running the stage
+	 * @return A duration in nanoseconds or -1 if it was not measured
+	 */
+	qint64 averageTime(Stage stage, bool gpu);
+
+	/**
+	 * @brief Draw a graph of the last frames into the batch
+	 *
+	 * Each frame is drawn as a column: its total duration in gray, the CPU time
+	 * of the paint stages stacked on the left, their GPU time in the middle and
+	 * the time of the other threads on the right.
+	 * @param x The left coordinate
+	 * @param y The top coordinate
+	 * @param width The graph width
+	 * @param height The graph height
+	 * @param budget The duration of a refresh period in nanoseconds, drawn at half height
+	 */
+	void draw(int x, int y, int width, int height, qint64 budget);
+
+	/**
+	 * @brief Save the samples in the chrome://tracing JSON format
+	 *
+	 * Each thread has its own track. The GPU samples are placed on a separate
+	 * track at the start of the corresponding CPU sample.
+	 * @param fileName The file path
+	 * @return True if succeeded
+	 */
+	bool saveTrace(QString fileName);
+
+private:
+	PhGraphicProfiler();
+
+	struct Event {
+		Stage stage;
+		// 0 for the paint thread, else the position in _threads plus one
+		int thread;
+		qint64 start;
+		qint64 duration;
+		qint64 gpuDuration;
+	};
+
+	struct Frame {
+		qint64 start;
+		qint64 duration;
+		// The stages of the paint thread
+		qint64 cpuTime[StageCount];
+		qint64 gpuTime[StageCount];
+		// The samples of the other threads
+		qint64 threadTime[StageCount];
+	};
+
+	struct Query {
+		GLuint begin, end;
+		Stage stage;
+		qint64 event;
+		qint64 frame;
+	};
+
+	bool initQueries();
+	void collectQueries();
+	int currentThread();
+	qint64 addEvent(Stage stage, int thread, qint64 start, qint64 duration);
+	Frame *frame(qint64 index);
+
+	QAtomicInt _enabled;
+	QElapsedTimer _timer;
+	QMutex _mutex;
+
+	QVector<Event> _events;
+	QVector<Frame> _frames;
+	qint64 _eventCount, _firstEvent;
+	qint64 _frameCount, _firstFrame;
+
+	qint64 _stageStart[StageCount];
+	Qt::HANDLE _paintThread;
+	QVector<Qt::HANDLE> _threads;
+	QStringList _threadNames;
+
+	int _queryState;
+	const QGLContext *_queryContext;
+	QVector<GLuint> _freeQueries;
+	QVector<Query> _pendingQueries;
+	// The queries of the running stages (0 if not measured)
+	Query _stageQueries[StageCount];
+};
+
+/**
+ * @brief Profile a stage until the end of the scope
+ */
+class PhGraphicProfilerScope
+{
+public:
+	/**
+	 * @brief Begin the stage
+	 * @param stage A stage drawn by the paint thread
+	 */
+	explicit PhGraphicProfilerScope(PhGraphicProfiler::Stage stage) : _stage(stage) {
+		PhGraphicProfiler::instance()->begin(_stage);
+	}
+
+	~PhGraphicProfilerScope() {
+		PhGraphicProfiler::instance()->end(_stage);
+	}
+
+private:
+	PhGraphicProfiler::Stage _stage;
+};
+
+#endif // PHGRAPHICPROFILER_H
@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include <QElapsedTimer>
+#include <QCoreApplication>
+
+#include "PhTools/PhDebug.h"
+
+#include "PhGraphicView.h"
+#include "PhGraphicRenderThread.h"
+
+PhGraphicRenderThread::PhGraphicRenderThread(PhGraphicView *view) :
+	_view(view),
+	_stopped(0)
+{
+}
+
+void PhGraphicRenderThread::stop()
+{
+	_stopped.storeRelease(1);
+}
+
+void PhGraphicRenderThread::run()
+{
+	PHDEBUG << "Render thread started";
+
+	_view->makeCurrent();
+
+	QElapsedTimer timer;
+	timer.start();
+	while(!_stopped.loadAcquire()) {
+		qint64 frameStart = timer.nsecsElapsed();
+
+		_view->renderFrame();
+
+		// Without vertical synchronization the swap does not wait for the screen
+		qint64 framePeriod = static_cast<qint64>(1000000000.0 / _view->screenFrequency());
+		qint64 remaining = framePeriod - (timer.nsecsElapsed() - frameStart);
+		if(remaining > 1000000)
+			QThread::usleep(remaining / 1000);
+	}
+
+	// The context is given back to the GUI thread before leaving
+	_view->doneCurrent();
+	_view->context()->moveToThread(QCoreApplication::instance()->thread());
+
+	PHDEBUG << "Render thread stopped";
+}
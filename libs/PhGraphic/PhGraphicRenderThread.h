@@ -0,0 +1,50 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef PHGRAPHICRENDERTHREAD_H
+#define PHGRAPHICRENDERTHREAD_H
+
+#include <QThread>
+#include <QAtomicInt>
+
+class PhGraphicView;
+
+/**
+ * @brief The thread rendering a PhGraphicView
+ *
+ * The thread owns the view OpenGL context while it is running and
+ * renders the frames one after the other. The pace is given by the
+ * buffer swap when the vertical synchronization is enabled, and by the
+ * screen frequency otherwise.
+ */
+class PhGraphicRenderThread : public QThread
+{
+public:
+	/**
+	 * @brief PhGraphicRenderThread constructor
+	 * @param view The rendered view
+	 */
+	explicit PhGraphicRenderThread(PhGraphicView *view);
+
+	/**
+	 * @brief Stop the rendering after the current frame
+	 *
+	 * The view context is given back to the thread which created the view.
+	 */
+	void stop();
+
+protected:
+	/**
+	 * @brief Render the frames until stop() is called
+	 */
+	void run();
+
+private:
+	PhGraphicView *_view;
+	QAtomicInt _stopped;
+};
+
+#endif // PHGRAPHICRENDERTHREAD_H
@@ -4,6 +4,7 @@
  * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
  */
 
+#include "PhGraphicBatch.h"
 #include "PhGraphicSolidRect.h"
 
 PhGraphicSolidRect::PhGraphicSolidRect(int x, int y, int w, int h) :
@@ -18,20 +19,5 @@ PhGraphicSolidRect::~PhGraphicSolidRect()
 
 void PhGraphicSolidRect::draw()
 {
-	PhGraphicObject::draw();
-//		/*
-//		(0,0) ------ (1,0)
-//		  |            |
-//		  |            |
-//		(0,1) ------ (1,1)
-//		*/
-
-	glBegin(GL_QUADS);  //Begining the cube's drawing
-	{
-		glVertex3i(this->x(),      this->y(), this->z());
-		glVertex3i(this->x() + this->width(), this->y(), this->z());
-		glVertex3i(this->x() + this->width(), this->y() + this->height(),  this->z());
-		glVertex3i(this->x(),      this->y() + this->height(),  this->z());
-	}
-	glEnd();
+	PhGraphicBatch::instance()->addRect(this->x(), this->y(), this->z(), this->width(), this->height(), this->color());
 }
@@ -4,6 +4,7 @@
  * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
  */
 
+#include "PhGraphicBatch.h"
 #include "PhGraphicText.h"
 
 PhGraphicText::PhGraphicText(PhFont* font, QString content, int x, int y, int w, int h)
@@ -37,79 +38,68 @@ PhFont * PhGraphicText::getFont()
 
 void PhGraphicText::draw()
 {
-	PhGraphicRect::draw();
+	PhGraphicBatch *batch = PhGraphicBatch::instance();
 
-	_font->select();
+	int totalAdvance = 0;
+	//Compute the natural width of the content to scale it later
+	//(this also rasterizes the missing glyphs before the texture is updated)
+	for(int i = 0; i < _content.length(); i++)
+		totalAdvance += _font->getAdvance(_content.at(i).unicode());
+
+	GLuint texture = _font->texture();
 
 	if(_font->getHeight() == 0) {
 		// bad font initialization: displaying a rect
-		glBegin(GL_QUADS);
-		{
-			glVertex3i(this->x(),      this->y(), this->z());
-			glVertex3i(this->x() + this->width(),  this->y(), this->z());
-			glVertex3i(this->x() + this->width(),  this->y() + this->height(),  this->z());
-			glVertex3i(this->x(),      this->y() +this->height(),  this->z());
-		}
-		glEnd();
-
+		batch->addRect(this->x(), this->y(), this->z(), this->width(), this->height(), this->color());
 		return;
 	}
 
-	glEnable(GL_TEXTURE_2D);
-
-	glEnable(GL_BLEND);
-
-	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-
-	int totalAdvance = 0;
-	//Compute the natural width of the content to scale it later
-	for(int i = 0; i < _content.length(); i++) {
-		totalAdvance += _font->getAdvance(_content.at(i).toLatin1());
-		if(_content.at(i).unicode() == 339)
-			totalAdvance += _font->getAdvance(153);
+	QColor color = this->color();
+	int y = this->y();
+	int z = this->z();
+	// computing the glyph scaling
+	float scaleX = totalAdvance ? (float)this->width() / totalAdvance : 0;
+	float scaleY = (float)this->height() / _font->getHeight();
+	float atlasSize = PhFont::atlasSize();
+
+	// The glyphs of a distance field are surrounded by a border
+	PhGraphicBatch::BlendMode blend = PhGraphicBatch::PremultipliedAlphaBlend;
+	float left = 0, top = 0;
+	if(_font->distanceField()) {
+		blend = PhGraphicBatch::DistanceFieldBlend;
+		batch->setDistanceField(texture, _font->distanceFieldParameters());
+		left = _font->getPadding() * scaleX;
+		top = _font->getPadding() * scaleY;
 	}
 
 	// Set the letter initial horizontal offset
 	int advance = 0;
-	float space = 0.0625f; // all glyph are in a 1/16 x 1/16 box
 	// Display a string
 	for(int i = 0; i < _content.length(); i++) {
-		unsigned char ch = (unsigned char)_content.at(i).toLatin1();
-		if(_content.at(i).unicode() == 339)
-			ch = 153;
-		if(_font->getAdvance(ch) > 0) {
+		PhFont::Glyph glyph = _font->glyph(_content.at(i).unicode());
+		if(glyph.width > 0) {
 			// computing texture coordinates
-			float tu1 = (ch % 16) * space;
-			float tv1 = (ch / 16) * space;
-			float tu2 = tu1 + space;
-			float tv2 = tv1 + space;
-
-			// computing quads coordinate;
-			int h = this->height() * 128 / _font->getHeight();
-			int w = this->width() * 128 / totalAdvance;
+			float tu1 = glyph.x / atlasSize;
+			float tv1 = glyph.y / atlasSize;
+			float tu2 = (glyph.x + glyph.width) / atlasSize;
+			float tv2 = (glyph.y + glyph.height) / atlasSize;
 
 			//        (tu1, tv1) --- (tu2, tv1)
 			//            |              |
 			//            |              |
 			//        (tu1, tv2) --- (tu2, tv2)
 
-			int offset = this->x() + advance * this->width() / totalAdvance;
-			glBegin(GL_QUADS);  //Begining the cube's drawing
-			{
-				glTexCoord3f(tu1, tv1, 1);  glVertex3i(offset,      this->y(), this->z());
-				glTexCoord3f(tu2, tv1, 1);  glVertex3i(offset + w,  this->y(), this->z());
-				glTexCoord3f(tu2, tv2, 1);  glVertex3i(offset + w,  this->y() + h,  this->z());
-				glTexCoord3f(tu1, tv2, 1);  glVertex3i(offset,      this->y() + h,  this->z());
-			}
-			glEnd();
-
+			float x1 = this->x() + advance * this->width() / totalAdvance - left;
+			float y1 = y - top;
+			float x2 = x1 + glyph.width * scaleX;
+			float y2 = y1 + glyph.height * scaleY;
+			batch->addQuad(texture, blend,
+			               PhGraphicBatch::vertex(x1, y1, z, color, tu1, tv1),
+			               PhGraphicBatch::vertex(x2, y1, z, color, tu2, tv1),
+			               PhGraphicBatch::vertex(x2, y2, z, color, tu2, tv2),
+			               PhGraphicBatch::vertex(x1, y2, z, color, tu1, tv2));
 		}
 		// Inc the advance
-		advance += _font->getAdvance(ch);
+		advance += glyph.advance;
 	}
-
-	glDisable(GL_BLEND);
-
-	glDisable(GL_TEXTURE_2D);
 }
-
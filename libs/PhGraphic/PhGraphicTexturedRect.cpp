@@ -5,6 +5,7 @@
  */
 
 #include "PhTools/PhDebug.h"
+#include "PhGraphicBatch.h"
 #include "PhGraphicTexturedRect.h"
 
 PhGraphicTexturedRect::PhGraphicTexturedRect(int x, int y, int w, int h)
@@ -235,6 +236,9 @@ bool PhGraphicTexturedRect::createTextureFromYUVBuffer(void *data, int width, in
 
 void PhGraphicTexturedRect::draw()
 {
+	// The batched primitives drawn before must stay below
+	PhGraphicBatch::instance()->flush();
+
 	PhGraphicRect::draw();
 
 	glBindTexture(GL_TEXTURE_2D, _currentTexture);
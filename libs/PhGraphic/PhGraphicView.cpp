@@ -7,18 +7,34 @@
 #include "PhTools/PhDebug.h"
 
 #include "PhGraphicText.h"
+#include "PhGraphicBatch.h"
+#include "PhGraphicRenderThread.h"
 
 #include "PhGraphicView.h"
 
+/**
+ * @brief The default format requesting the vertical synchronization
+ * @return A format with a swap interval of one screen refresh
+ */
+static QGLFormat synchronizedFormat()
+{
+	QGLFormat format = QGLFormat::defaultFormat();
+	format.setSwapInterval(1);
+	return format;
+}
+
 PhGraphicView::PhGraphicView( QWidget *parent)
-	: QGLWidget(parent),
+	: QGLWidget(synchronizedFormat(), parent),
 	_settings(NULL),
 	_dropDetected(0),
 	_maxRefreshRate(0),
 	_maxPaintDuration(0),
 	_lastUpdateDuration(0),
 	_maxUpdateDuration(0),
-	_previousNsecsElapsed(0)
+	_lastDisplayTime(0),
+	_paintWidth(0),
+	_paintHeight(0),
+	_renderThread(NULL)
 {
 	if (SDL_Init(SDL_INIT_VIDEO) != 0)
 		PHDEBUG << "SDL error:" << SDL_GetError();
@@ -36,7 +52,9 @@ PhGraphicView::PhGraphicView( QWidget *parent)
 	else
 		PHDEBUG << "Unable to get the screen";
 
-	int timerInterval = static_cast<int>(500.0 / _screenFrequency);
+	_framePacer.setFrequency(_screenFrequency);
+
+	int timerInterval = refreshTimerInterval();
 	_refreshTimer->start( timerInterval);
 	//PHDEBUG << "Refresh rate set to " << _screenFrequency << "hz, timer restart every" << timerInterval << "ms";
 	_dropTimer.start();
@@ -53,12 +71,20 @@ PhGraphicView::PhGraphicView(int width, int height, QWidget *parent)
 
 PhGraphicView::~PhGraphicView()
 {
+	stopRenderThread();
 	_refreshTimer->stop();
 	TTF_Quit();
 	SDL_Quit();
 }
 
 void PhGraphicView::resizeGL(int width, int height)
+{
+	_paintWidth = width;
+	_paintHeight = height;
+	setupProjection(width, height);
+}
+
+void PhGraphicView::setupProjection(int width, int height)
 {
 	if(height == 0)
 		height = 1;
@@ -82,7 +108,117 @@ void PhGraphicView::addInfo(QString info)
 	_infos.append(info);
 }
 
+void PhGraphicView::startRenderThread()
+{
+	if(_renderThread)
+		return;
+
+	PHDEBUG << "Starting the render thread";
+	_refreshTimer->stop();
+
+	// Make sure the context is initialized before giving it away
+	QGLWidget::updateGL();
+	setAutoBufferSwap(false);
+	{
+		QMutexLocker locker(&_sizeMutex);
+		_pendingSize = QSize(_paintWidth, _paintHeight);
+	}
+
+	doneCurrent();
+	_renderThread = new PhGraphicRenderThread(this);
+	context()->moveToThread(_renderThread);
+	_renderThread->start(QThread::HighPriority);
+}
+
+void PhGraphicView::stopRenderThread()
+{
+	if(_renderThread == NULL)
+		return;
+
+	PHDEBUG << "Stopping the render thread";
+	_renderThread->stop();
+	_renderThread->wait();
+	delete _renderThread;
+	_renderThread = NULL;
+
+	setAutoBufferSwap(true);
+	_refreshTimer->start(refreshTimerInterval());
+}
+
+void PhGraphicView::updateGL()
+{
+	// The context belongs to the render thread
+	if(_renderThread)
+		return;
+	QGLWidget::updateGL();
+}
+
+void PhGraphicView::paintEvent(QPaintEvent *event)
+{
+	if(_renderThread == NULL)
+		QGLWidget::paintEvent(event);
+}
+
+void PhGraphicView::resizeEvent(QResizeEvent *event)
+{
+	if(_renderThread == NULL) {
+		QGLWidget::resizeEvent(event);
+		return;
+	}
+
+	// The viewport is updated by the render thread before its next frame
+	QMutexLocker locker(&_sizeMutex);
+	_pendingSize = event->size() * this->devicePixelRatio();
+}
+
+void PhGraphicView::renderFrame()
+{
+	QSize size;
+	{
+		QMutexLocker locker(&_sizeMutex);
+		size = _pendingSize;
+		_pendingSize = QSize();
+	}
+
+	QTime t;
+	t.start();
+	{
+		QMutexLocker locker(&_renderMutex);
+		if(size.isValid())
+			resizeGL(size.width(), size.height());
+		addRefreshInfo();
+		paintGL();
+	}
+	// The GUI thread may change the paint state while waiting for the screen
+	swapBuffers();
+	_framePacer.addSwap(_timer.nsecsElapsed());
+	checkUpdateDuration(t.elapsed());
+}
+
+int PhGraphicView::refreshTimerInterval()
+{
+	// The swap waits for the screen: the timer only has to fire again once it returned
+	if(format().swapInterval() > 0)
+		return 1;
+	return static_cast<int>(500.0 / _screenFrequency);
+}
+
 void PhGraphicView::onRefresh()
+{
+	// A frame is already waiting for this screen refresh
+	if(_framePacer.displayTime(_timer.nsecsElapsed()) <= _lastDisplayTime)
+		return;
+
+	addRefreshInfo();
+
+	QTime t;
+	t.start();
+	updateGL();
+	_framePacer.addSwap(_timer.nsecsElapsed());
+	checkUpdateDuration(t.elapsed());
+}
+
+void PhGraphicView::addRefreshInfo()
 {
 	if(this->refreshRate() > _maxRefreshRate)
 		_maxRefreshRate = this->refreshRate();
@@ -93,43 +229,80 @@ void PhGraphicView::onRefresh()
 	        .arg(this->refreshRate()));
 	addInfo(QString("Update : %1 %2").arg(_maxUpdateDuration).arg(_lastUpdateDuration));
 	addInfo(QString("drop: %1 %2").arg(_dropDetected).arg(_dropTimer.elapsed() / 1000));
+	addInfo(QString("vsync: %1 us, missed %2").arg(_framePacer.period() / 1000).arg(_framePacer.missedCount()));
+	if(_renderThread)
+		addInfo("render thread");
+}
 
-	QTime t;
-	t.start();
-	updateGL();
-	_lastUpdateDuration = t.elapsed();
+void PhGraphicView::addProfilerInfo()
+{
+	PhGraphicProfiler *profiler = PhGraphicProfiler::instance();
+	for(int i = 0; i < PhGraphicProfiler::StageCount; i++) {
+		PhGraphicProfiler::Stage stage = static_cast<PhGraphicProfiler::Stage>(i);
+		qint64 cpuTime = profiler->averageTime(stage, false);
+		if(cpuTime < 0)
+			continue;
+		qint64 gpuTime = profiler->averageTime(stage, true);
+		addInfo(QString("%1: %2 / %3 ms")
+		        .arg(PhGraphicProfiler::stageName(stage))
+		        .arg(cpuTime / 1000000.0, 0, 'f', 2)
+		        .arg(gpuTime < 0 ? QString("-") : QString::number(gpuTime / 1000000.0, 'f', 2)));
+	}
+}
+
+void PhGraphicView::checkUpdateDuration(int duration)
+{
+	_lastUpdateDuration = duration;
 	if(_lastUpdateDuration > _maxUpdateDuration)
 		_maxUpdateDuration = _lastUpdateDuration;
 	if(_lastUpdateDuration > static_cast<int>(1500.0 / _screenFrequency)) {
 		_dropTimer.restart();
 		_dropDetected++;
 	}
-
 }
 
 void PhGraphicView::paintGL()
 {
 	//PHDEBUG << "PhGraphicView::paintGL" ;
 
-	// Update the clock time according to the time elapsed since the last paint event
-	// In the particular case of V-sync enabled and no dropped frames, this is equivalent
-	// to using the screen refresh rate to compute the elapsed time.
-	// If V-sync is not enabled, using the screen refresh rate is plain wrong
-	// (the refreshTimer period would be ok though).
-	// If frames are dropped, only an actual timer can be correct.
-	// Millisecond precision is not enough (60 Hz is 16.6 ms), so we use nanoseconds.
-	qint64 nsecsElapsed = _timer.nsecsElapsed();
-	double elapsedSeconds = static_cast<double>(nsecsElapsed - _previousNsecsElapsed) / 1000000000.0f;
-	emit beforePaint(static_cast<PhTime> (24000.0 * elapsedSeconds));
-	_previousNsecsElapsed = nsecsElapsed;
+	PhGraphicProfiler *profiler = PhGraphicProfiler::instance();
+	profiler->beginFrame();
+
+	// Update the clock time according to the instant where the frame will be
+	// displayed rather than the one where its paint starts: the display times
+	// follow the screen refresh grid given by the buffer swaps, so the clock moves
+	// by steady steps, and by whole refresh periods when frames are dropped.
+	// Both times are converted to PhTime before the difference so that the
+	// rounding errors do not accumulate. Millisecond precision is not enough
+	// (60 Hz is 16.6 ms), so we use nanoseconds.
+	qint64 displayTime = _framePacer.displayTime(_timer.nsecsElapsed());
+	if(_lastDisplayTime == 0)
+		_lastDisplayTime = displayTime - _framePacer.period();
+	if(displayTime > _lastDisplayTime) {
+		emit beforePaint(static_cast<PhTime>(displayTime * 3 / 125000 - _lastDisplayTime * 3 / 125000));
+		_lastDisplayTime = displayTime;
+	}
+	else
+		emit beforePaint(0);
 
 	glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	QTime timer;
 	timer.start();
 
-	int ratio = this->windowHandle()->devicePixelRatio();
-	emit paint(this->width() * ratio, this->height() * ratio);
+	PhGraphicBatch *batch = PhGraphicBatch::instance();
+	batch->resetCounters();
+
+	// The render thread only knows the size handed off by resizeEvent()
+	if(_renderThread)
+		emit paint(_paintWidth, _paintHeight);
+	else {
+		int ratio = this->windowHandle()->devicePixelRatio();
+		emit paint(this->width() * ratio, this->height() * ratio);
+	}
+	batch->flush();
+	if(_settings && _settings->displayInfo())
+		addInfo(QString("batch: %1 draws, %2 vertices").arg(batch->drawCount()).arg(batch->drawnVertexCount()));
 
 	if(timer.elapsed() > _maxPaintDuration)
 		_maxPaintDuration = timer.elapsed();
@@ -142,6 +315,11 @@ void PhGraphicView::paintGL()
 			_maxUpdateDuration = 0;
 		}
 		if(_settings->displayInfo()) {
+			PhGraphicProfilerScope scope(PhGraphicProfiler::OverlayStage);
+
+			if(profiler->enabled())
+				addProfilerInfo();
+
 			_infoFont.setFontFile(_settings->infoFontFile());
 			int y = 0;
 			foreach(QString info, _infos) {
@@ -152,6 +330,10 @@ void PhGraphicView::paintGL()
 				gInfo.draw();
 				y += gInfo.height();
 			}
+
+			if(profiler->enabled())
+				profiler->draw(0, y, 360, 120, static_cast<qint64>(1000000000.0 / _screenFrequency));
+			batch->flush();
 		}
 	}
 	// Once the informations have been displayed
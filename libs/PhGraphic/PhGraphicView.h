@@ -7,12 +7,18 @@
 #ifndef PHGRAPHICVIEW_H
 #define PHGRAPHICVIEW_H
 
+#include <QMutex>
+
 #include "PhSync/PhTime.h"
 #include "PhTools/PhTickCounter.h"
 
 #include "PhGraphicSettings.h"
+#include "PhGraphicFramePacer.h"
+#include "PhGraphicProfiler.h"
 #include "PhFont.h"
 
+class PhGraphicRenderThread;
+
 /**
  * @brief The PhGraphicView class is a canvas to create your custom graphic view.
  *
@@ -20,6 +26,17 @@
  * paint them with paint(), and clear them with dispose().
  * These methods are called automatically after the view creation and during all
  * its lifetime.
+ *
+ * The view requests the vertical synchronization: the buffer swaps give the
+ * pace of the rendering and the time passed to beforePaint() is computed
+ * from the predicted display instants of the frames (see PhGraphicFramePacer).
+ *
+ * By default, the view is refreshed by a timer of the GUI thread. After
+ * startRenderThread(), the frames are rendered by a dedicated thread owning
+ * the OpenGL context, so that a busy GUI thread does not delay them.
+ * The beforePaint() and paint() signals are then emitted from the render
+ * thread: they must be connected with Qt::DirectConnection, and the GUI
+ * code changing the state read by their slots must hold renderMutex().
  */
 class PhGraphicView : public QGLWidget
 {
@@ -52,6 +69,15 @@ public:
 	 */
 	void resizeGL(int width, int height);
 
+	/**
+	 * @brief Set the viewport and the projection used by the graphic objects
+	 *
+	 * The origin is at the top left corner and a unit is a pixel.
+	 * @param width The viewport width
+	 * @param height The viewport height
+	 */
+	static void setupProjection(int width, int height);
+
 	/**
 	 * @brief Get the refresh rate of the view
 	 * @return The rate (in fps)
@@ -70,6 +96,54 @@ public:
 	 * @param info A string
 	 */
 	void addInfo(QString info);
+
+	/**
+	 * @brief Get the screen frequency
+	 * @return A frequency in hertz
+	 */
+	qreal screenFrequency() {
+		return _screenFrequency;
+	}
+
+	/**
+	 * @brief Render the view from a dedicated thread
+	 *
+	 * The GUI timer is stopped and the OpenGL context is moved to the render thread.
+	 */
+	void startRenderThread();
+
+	/**
+	 * @brief Stop the render thread and go back to the GUI timer
+	 */
+	void stopRenderThread();
+
+	/**
+	 * @brief Tell if the view is rendered by a dedicated thread
+	 * @return True if the render thread is running
+	 */
+	bool isRenderThreadRunning() {
+		return _renderThread != NULL;
+	}
+
+	/**
+	 * @brief The mutex held during the paint
+	 *
+	 * Lock it before changing what the paint slots read when the
+	 * render thread is running.
+	 * @return A mutex
+	 */
+	QMutex *renderMutex() {
+		return &_renderMutex;
+	}
+
+public slots:
+	/**
+	 * @brief Repaint the view immediately
+	 *
+	 * Nothing is done when the render thread is running.
+	 */
+	void updateGL();
+
 signals:
 	/**
 	 * @brief emit a signal just before the paint
@@ -91,6 +165,18 @@ protected:
 	 */
 	void paintGL();
 
+	/**
+	 * @brief Ignored when the render thread is running
+	 * @param event The paint event
+	 */
+	void paintEvent(QPaintEvent *event);
+
+	/**
+	 * @brief Forward the new size to the render thread when it is running
+	 * @param event The resize event
+	 */
+	void resizeEvent(QResizeEvent *event);
+
 	/**
 	 * @brief The screen frequency
 	 */
@@ -100,6 +186,14 @@ private slots:
 	void onRefresh();
 
 private:
+	friend class PhGraphicRenderThread;
+
+	void renderFrame();
+	int refreshTimerInterval();
+	void addRefreshInfo();
+	void addProfilerInfo();
+	void checkUpdateDuration(int duration);
+
 	PhGraphicSettings *_settings;
 	/**
 	 * @brief t_Timer
@@ -112,7 +206,16 @@ private:
 	QTime _dropTimer;
 	int _dropDetected, _maxRefreshRate, _maxPaintDuration, _lastUpdateDuration, _maxUpdateDuration;
 	QElapsedTimer _timer;
-	qint64 _previousNsecsElapsed;
+	// The screen refresh grid and the display time of the last painted frame
+	PhGraphicFramePacer _framePacer;
+	qint64 _lastDisplayTime;
+	int _paintWidth, _paintHeight;
+
+	PhGraphicRenderThread *_renderThread;
+	QMutex _renderMutex;
+	// The size given by the GUI thread to the render thread
+	QMutex _sizeMutex;
+	QSize _pendingSize;
 };
 
 #endif // PHGRAPHICVIEW
@@ -0,0 +1,244 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include <QMatrix3x3>
+#include <QVector3D>
+
+#include "PhTools/PhDebug.h"
+#include "PhGraphicBatch.h"
+#include "PhGraphicYUVRect.h"
+
+static const char *yuvVertexShader =
+    "void main()\n"
+    "{\n"
+    "	gl_Position = ftransform();\n"
+    "	gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+    "	gl_FrontColor = gl_Color;\n"
+    "}\n";
+
+static const char *yuvFragmentShader =
+    "uniform sampler2D yTexture;\n"
+    "uniform sampler2D uTexture;\n"
+    "uniform sampler2D vTexture;\n"
+    "uniform float sampleScale;\n"
+    "uniform vec3 offset;\n"
+    "uniform mat3 colorMatrix;\n"
+    "void main()\n"
+    "{\n"
+    "	vec3 yuv = vec3(texture2D(yTexture, gl_TexCoord[0].st).r,\n"
+    "	                texture2D(uTexture, gl_TexCoord[0].st).r,\n"
+    "	                texture2D(vTexture, gl_TexCoord[0].st).r) * sampleScale;\n"
+    "	gl_FragColor = vec4(colorMatrix * (yuv - offset), 1.0) * gl_Color;\n"
+    "}\n";
+
+PhGraphicYUVRect::PhGraphicYUVRect(int x, int y, int w, int h)
+	: PhGraphicRect(x, y, w, h),
+	_program(NULL),
+	_bitDepth(8),
+	_bt709(false),
+	_fullRange(false),
+	_bilinearFiltering(true)
+{
+	for(int i = 0; i < 3; i++) {
+		_textures[i] = 0;
+		_planeWidth[i] = 0;
+		_planeHeight[i] = 0;
+	}
+}
+
+PhGraphicYUVRect::~PhGraphicYUVRect()
+{
+	delete _program;
+
+	if((_textures[0] == 0) || _textureContext.isNull())
+		return;
+
+	// The textures can only be deleted by their own context
+	QOpenGLContext *previousContext = QOpenGLContext::currentContext();
+	QSurface *previousSurface = previousContext ? previousContext->surface() : NULL;
+	const QGLContext *context = QGLContext::fromOpenGLContext(_textureContext);
+	if(previousContext != _textureContext)
+		const_cast<QGLContext *>(context)->makeCurrent();
+
+	if(QOpenGLContext::currentContext() == _textureContext)
+		glDeleteTextures(3, _textures);
+	else
+		PHDEBUG << "Unable to make the context current: leaking the textures";
+
+	if(previousContext == NULL)
+		const_cast<QGLContext *>(context)->doneCurrent();
+	else if(previousContext != _textureContext)
+		previousContext->makeCurrent(previousSurface);
+}
+
+bool PhGraphicYUVRect::initProgram()
+{
+	if(_program)
+		return _program->isLinked();
+
+	_functions.initializeGLFunctions();
+
+	_program = new QGLShaderProgram();
+	if(!_program->addShaderFromSourceCode(QGLShader::Vertex, yuvVertexShader)
+	   || !_program->addShaderFromSourceCode(QGLShader::Fragment, yuvFragmentShader)
+	   || !_program->link()) {
+		PHDEBUG << "Unable to build the YUV shader:" << _program->log();
+		return false;
+	}
+
+	glGenTextures(3, _textures);
+	if(_textures[0] == 0) {
+		PHDEBUG << "glGenTextures() errored: is opengl context ready?";
+		return false;
+	}
+	_textureContext = QOpenGLContext::currentContext();
+
+	return true;
+}
+
+bool PhGraphicYUVRect::createTextureFromYUVPlanes(void *y, void *u, void *v, int width, int height,
+                                                  int chromaWidth, int chromaHeight, int bitDepth)
+{
+	if(!initProgram())
+		return false;
+
+	_bitDepth = bitDepth;
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	uploadPlane(0, y, width, height);
+	uploadPlane(1, u, chromaWidth, chromaHeight);
+	uploadPlane(2, v, chromaWidth, chromaHeight);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	return true;
+}
+
+void PhGraphicYUVRect::uploadPlane(int index, void *data, int width, int height)
+{
+	GLenum type = (_bitDepth > 8) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE;
+
+	glBindTexture(GL_TEXTURE_2D, _textures[index]);
+
+	if((width != _planeWidth[index]) || (height != _planeHeight[index])) {
+		_planeWidth[index] = width;
+		_planeHeight[index] = height;
+
+		PHDEBUG << index << QString("%1x%2").arg(width).arg(height);
+
+		GLint internalFormat = (_bitDepth > 8) ? GL_LUMINANCE16 : GL_LUMINANCE8;
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, GL_LUMINANCE, type, data);
+		applyTextureSettings();
+	}
+	else
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_LUMINANCE, type, data);
+}
+
+void PhGraphicYUVRect::draw()
+{
+	if((_program == NULL) || !_program->isLinked() || (_planeWidth[0] == 0))
+		return;
+
+	// The batched primitives drawn before must stay below
+	PhGraphicBatch::instance()->flush();
+
+	PhGraphicRect::draw();
+
+	// The samples with less than 16 significant bits are normalized by OpenGL as 16 bit values
+	float sampleScale = 1.0f;
+	if(_bitDepth > 8)
+		sampleScale = 65535.0f / ((1 << _bitDepth) - 1);
+
+	// The normalized samples are n / (2^bitDepth - 1): the neutral chroma is
+	// 128 / 255 in 8 bit, and the video range levels scale with the bit depth.
+	float maxValue = (1 << _bitDepth) - 1;
+	float step = (_bitDepth > 8) ? (1 << (_bitDepth - 8)) : 1.0f;
+	float chromaOffset = 128.0f * step / maxValue;
+
+	// Coefficients converting (Y, U - 128, V - 128) to RGB
+	float coefficients[9];
+	QVector3D offset(0.0f, chromaOffset, chromaOffset);
+	float yScale = 1.0f;
+	float cScale = 1.0f;
+	if(!_fullRange) {
+		offset.setX(16.0f * step / maxValue);
+		yScale = maxValue / (219.0f * step);
+		cScale = maxValue / (224.0f * step);
+	}
+	float kr = _bt709 ? 0.2126f : 0.299f;
+	float kb = _bt709 ? 0.0722f : 0.114f;
+	float kg = 1.0f - kr - kb;
+	float rv = 2.0f * (1.0f - kr);
+	float bu = 2.0f * (1.0f - kb);
+	float gu = -bu * kb / kg;
+	float gv = -rv * kr / kg;
+	coefficients[0] = yScale; coefficients[1] = 0.0f;        coefficients[2] = rv * cScale;
+	coefficients[3] = yScale; coefficients[4] = gu * cScale; coefficients[5] = gv * cScale;
+	coefficients[6] = yScale; coefficients[7] = bu * cScale; coefficients[8] = 0.0f;
+
+	_program->bind();
+	_program->setUniformValue("yTexture", 0);
+	_program->setUniformValue("uTexture", 1);
+	_program->setUniformValue("vTexture", 2);
+	_program->setUniformValue("sampleScale", sampleScale);
+	_program->setUniformValue("offset", offset);
+	_program->setUniformValue("colorMatrix", QMatrix3x3(coefficients));
+
+	for(int i = 2; i >= 0; i--) {
+		_functions.glActiveTexture(GL_TEXTURE0 + i);
+		glBindTexture(GL_TEXTURE_2D, _textures[i]);
+	}
+
+	glEnable(GL_TEXTURE_2D);
+
+	glBegin(GL_QUADS);
+	{
+		glTexCoord3f(0, 0, 1);  glVertex3i(this->x(),      this->y(), this->z());
+		glTexCoord3f(1, 0, 1);  glVertex3i(this->x() + this->width(), this->y(), this->z());
+		glTexCoord3f(1, 1, 1);  glVertex3i(this->x() + this->width(), this->y() + this->height(),  this->z());
+		glTexCoord3f(0, 1, 1);  glVertex3i(this->x(),      this->y() + this->height(),  this->z());
+	}
+	glEnd();
+
+	glDisable(GL_TEXTURE_2D);
+
+	_program->release();
+}
+
+void PhGraphicYUVRect::setBT709(bool bt709)
+{
+	_bt709 = bt709;
+}
+
+void PhGraphicYUVRect::setFullRange(bool fullRange)
+{
+	_fullRange = fullRange;
+}
+
+void PhGraphicYUVRect::setBilinearFiltering(bool bilinear)
+{
+	_bilinearFiltering = bilinear;
+
+	for(int i = 0; i < 3; i++) {
+		if(_textures[i] != 0) {
+			glBindTexture(GL_TEXTURE_2D, _textures[i]);
+			applyTextureSettings();
+		}
+	}
+}
+
+bool PhGraphicYUVRect::bilinearFiltering()
+{
+	return _bilinearFiltering;
+}
+
+void PhGraphicYUVRect::applyTextureSettings()
+{
+	int filterSetting = _bilinearFiltering ? GL_LINEAR : GL_NEAREST;
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filterSetting);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filterSetting);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
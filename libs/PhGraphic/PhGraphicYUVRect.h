@@ -0,0 +1,103 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef PHGRAPHICYUVRECT_H
+#define PHGRAPHICYUVRECT_H
+
+#include <QGLFunctions>
+#include <QGLShaderProgram>
+#include <QOpenGLContext>
+#include <QPointer>
+
+#include "PhGraphicRect.h"
+
+/**
+ * @brief Draw a rectangle filled with a planar YUV picture
+ *
+ * The Y, U and V planes are uploaded into three single channel textures
+ * and a fragment shader performs the conversion to RGB. It avoids the
+ * conversion on the CPU and reduces the amount of data sent to the graphic
+ * card compared to a BGRA texture (by 2.7 for a 4:2:0 picture).
+ *
+ * The 4:2:0, 4:2:2 and 4:4:4 subsamplings are supported (the chroma planes
+ * are simply stretched on the rectangle) with 8 bit or 16 bit samples.
+ */
+class PhGraphicYUVRect : public PhGraphicRect
+{
+public:
+	/**
+	 * @brief PhGraphicYUVRect constructor
+	 * @param x Upper left corner coordinate
+	 * @param y Upper left corner coordinate
+	 * @param w Desired width
+	 * @param h Desired heigth
+	 */
+	PhGraphicYUVRect(int x = 0, int y = 0, int w = 0, int h = 0);
+	~PhGraphicYUVRect();
+
+	/**
+	 * @brief draw the picture
+	 */
+	void draw();
+
+	/**
+	 * @brief Create the textures from tightly packed YUV planes
+	 * @param y The luma plane
+	 * @param u The blue difference plane
+	 * @param v The red difference plane
+	 * @param width The luma plane width
+	 * @param height The luma plane height
+	 * @param chromaWidth The chroma planes width
+	 * @param chromaHeight The chroma planes height
+	 * @param bitDepth The number of significant bits per sample (8 to 16)
+	 * @return True if succeed, false otherwise
+	 */
+	bool createTextureFromYUVPlanes(void *y, void *u, void *v, int width, int height,
+	                                int chromaWidth, int chromaHeight, int bitDepth = 8);
+
+	/**
+	 * @brief Set the YUV color matrix
+	 * @param bt709 True for ITU-R BT.709 (HD), false for ITU-R BT.601 (SD)
+	 */
+	void setBT709(bool bt709);
+
+	/**
+	 * @brief Set the YUV samples range
+	 * @param fullRange True for full range (JPEG), false for video range
+	 */
+	void setFullRange(bool fullRange);
+
+	/**
+	 * @brief Enable or disable the texture bilinear filtering
+	 * Texture bilinear filtering is enabled by default.
+	 * @param bilinear True to enable bilinear filtering
+	 */
+	void setBilinearFiltering(bool bilinear);
+
+	/**
+	 * @brief Retrieve the texture filtering
+	 * @return True if bilinear filtering is enabled
+	 */
+	bool bilinearFiltering();
+
+private:
+	bool initProgram();
+	void uploadPlane(int index, void *data, int width, int height);
+	void applyTextureSettings();
+
+	QGLFunctions _functions;
+	QGLShaderProgram *_program;
+	GLuint _textures[3];
+	// The context owning the textures
+	QPointer<QOpenGLContext> _textureContext;
+	int _planeWidth[3], _planeHeight[3];
+	int _bitDepth;
+	bool _bt709;
+	bool _fullRange;
+	bool _bilinearFiltering;
+};
+
+#endif // PHGRAPHICYUVRECT_H
@@ -4,6 +4,9 @@
  * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
  */
 
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+
 #include "PhTools/PhFile.h"
 #include "PhTools/PhDebug.h"
 #include "PhCommonUI/PhUI.h"
@@ -14,10 +17,45 @@
 #include "PhGraphicStrip.h"
 #include "PhGraphic/PhGraphicSolidRect.h"
 #include "PhGraphic/PhGraphicLoop.h"
+#include "PhGraphic/PhGraphicBatch.h"
+#include "PhGraphic/PhGraphicProfiler.h"
+
+PhGraphicStrip::TextNode::TextNode(PhStripText *text, PhFont *textFont, PhFont *hudFont) :
+	text(text),
+	gText(textFont, text->content()),
+	gPeople(hudFont, text->people() ? text->people()->name().toLower() : "???"),
+	displayPeople(false),
+	x(0),
+	peopleX(0)
+{
+}
+
+PhGraphicStrip::LoopNode::LoopNode(PhStripLoop *loop, PhFont *hudFont) :
+	loop(loop),
+	gLabel(hudFont, loop->label()),
+	x(0)
+{
+}
+
+PhGraphicStrip::DetectNode::~DetectNode()
+{
+	delete gDetect;
+}
 
 PhGraphicStrip::PhGraphicStrip(PhGraphicStripSettings *settings) :
 	_settings(settings),
-	_maxDrawElapsed(0)
+	_maxDrawElapsed(0),
+	_sceneDirty(true),
+	_layoutY(0),
+	_layoutHeight(0),
+	_layoutTimePerPixel(0),
+	_layoutCutWidth(0),
+	_layoutInvertedColor(false),
+	_layoutTextDistanceField(false),
+	_maxPeopleLead(0),
+	_sceneGeneration(0),
+	_bufferDirty(true),
+	_bufferSceneGeneration(-1)
 {
 	// update the  content when the doc changes :
 	this->connect(&_doc, SIGNAL(changed()), this, SLOT(onDocChanged()));
@@ -27,6 +65,12 @@ PhGraphicStrip::PhGraphicStrip(PhGraphicStripSettings *settings) :
 
 }
 
+PhGraphicStrip::~PhGraphicStrip()
+{
+	clearTiles();
+	clearScene();
+}
+
 PhStripDoc *PhGraphicStrip::doc()
 {
 	return &_doc;
@@ -39,7 +83,188 @@ PhClock *PhGraphicStrip::clock()
 
 void PhGraphicStrip::onDocChanged()
 {
+	// The document may still be filled after the signal (see PhStripDoc::reset()):
+	// the scene is rebuilt on the next draw.
+	_sceneDirty = true;
+}
 
+void PhGraphicStrip::clearScene()
+{
+	qDeleteAll(_textNodes);
+	_textNodes.clear();
+	qDeleteAll(_loopNodes);
+	_loopNodes.clear();
+	qDeleteAll(_cutNodes);
+	_cutNodes.clear();
+	qDeleteAll(_detectNodes);
+	_detectNodes.clear();
+}
+
+void PhGraphicStrip::buildScene()
+{
+	PHDEBUG << "texts:" << _doc.texts().count() << "loops:" << _doc.loops().count()
+	        << "cuts:" << _doc.cuts().count() << "detects:" << _doc.detects().count();
+	clearScene();
+
+	// The nodes are kept in the order of the document indexes so that
+	// the positions of the visible objects are also the ones of their nodes.
+	const PhStripIndex<PhStripText> &textIndex = _doc.textIndex();
+	for(int i = 0; i < textIndex.count(); i++)
+		_textNodes.append(new TextNode(textIndex.at(i), &_textFont, &_hudFont));
+
+	// Display the people name only if one of the following condition is true:
+	// - it is the first text of the track
+	// - it is a different people
+	// - the distance between the latest text and the current is superior to a limit
+	PhTime minTimeBetweenPeople = 48000;
+	QMap<float, PhStripText * > lastTextList;
+	foreach(TextNode *node, _textNodes) {
+		PhStripText *text = node->text;
+		PhStripText *lastText = lastTextList.value(text->y(), NULL);
+		node->displayPeople = (lastText == NULL)
+		                      || (lastText->people() != text->people())
+		                      || (text->timeIn() - lastText->timeOut() > minTimeBetweenPeople);
+		lastTextList[text->y()] = text;
+	}
+
+	const PhStripIndex<PhStripLoop> &loopIndex = _doc.loopIndex();
+	for(int i = 0; i < loopIndex.count(); i++)
+		_loopNodes.append(new LoopNode(loopIndex.at(i), &_hudFont));
+
+	const PhStripIndex<PhStripCut> &cutIndex = _doc.cutIndex();
+	for(int i = 0; i < cutIndex.count(); i++) {
+		CutNode *node = new CutNode;
+		node->cut = cutIndex.at(i);
+		node->x = 0;
+		_cutNodes.append(node);
+	}
+
+	const PhStripIndex<PhStripDetect> &detectIndex = _doc.detectIndex();
+	for(int i = 0; i < detectIndex.count(); i++) {
+		PhStripDetect *detect = detectIndex.at(i);
+		DetectNode *node = new DetectNode;
+		node->detect = detect;
+		node->x = 0;
+		switch (detect->type()) {
+		case PhStripDetect::Off:
+			node->gDetect = new PhGraphicSolidRect();
+			break;
+		case PhStripDetect::SemiOff:
+			node->gDetect = new PhGraphicDashedLine((detect->timeOut() - detect->timeIn()) / 1200);
+			break;
+		case PhStripDetect::ArrowUp:
+			node->gDetect = new PhGraphicArrow(PhGraphicArrow::DownLeftToUpRight);
+			break;
+		case PhStripDetect::ArrowDown:
+			node->gDetect = new PhGraphicArrow(PhGraphicArrow::UpLefToDownRight);
+			break;
+		default:
+			node->gDetect = NULL;
+			break;
+		}
+		_detectNodes.append(node);
+	}
+
+	_sceneDirty = false;
+	_bufferDirty = true;
+	// Force the layout
+	_layoutHeight = 0;
+}
+
+void PhGraphicStrip::layoutScene(int y, int height, int timePerPixel, bool invertedColor, QList<PhPeople *> selectedPeoples)
+{
+	PhTime timeBetweenPeopleAndText = 4000;
+	int cutWidth = _settings->cutWidth();
+
+	_layoutY = y;
+	_layoutHeight = height;
+	_layoutTimePerPixel = timePerPixel;
+	_layoutCutWidth = cutWidth;
+	_layoutInvertedColor = invertedColor;
+	_layoutSelectedPeoples = selectedPeoples;
+	_layoutHudFontFile = _hudFont.getFontFile();
+	_layoutTextDistanceField = _textFont.distanceField();
+
+	// computeColor() gives the complementary colors when inverted
+	bool invertText = invertedColor && !_layoutTextDistanceField;
+	_maxPeopleLead = 0;
+	foreach(TextNode *node, _textNodes) {
+		PhStripText *text = node->text;
+		QColor color = computeColor(text->people(), selectedPeoples, invertedColor);
+
+		node->x = text->timeIn() / timePerPixel;
+		node->gText.setWidth((text->timeOut() - text->timeIn()) / timePerPixel);
+		node->gText.setY(y + text->y() * height);
+		node->gText.setHeight(text->height() * height);
+		node->gText.setZ(-1);
+		node->gText.setColor(computeColor(text->people(), selectedPeoples, invertText));
+
+		node->gPeople.setWidth(_hudFont.getNominalWidth(node->gPeople.getContent()) / 5);
+		node->gPeople.setHeight(text->height() * height / 2);
+		node->gPeople.setY(y + text->y() * height);
+		node->gPeople.setZ(-1);
+		node->gPeople.setColor(color);
+		node->peopleX = (text->timeIn() - timeBetweenPeopleAndText) / timePerPixel - node->gPeople.width();
+		_maxPeopleLead = qMax(_maxPeopleLead, node->x - node->peopleX);
+	}
+
+	foreach(LoopNode *node, _loopNodes) {
+		node->x = node->loop->timeIn() / timePerPixel;
+
+		if(!invertedColor)
+			node->gLoop.setColor(Qt::black);
+		else
+			node->gLoop.setColor(Qt::white);
+		node->gLoop.setY(y);
+		node->gLoop.setZ(-1);
+		node->gLoop.setThickness(height / 40);
+		node->gLoop.setHeight(height);
+		node->gLoop.setCrossSize(height / 4);
+		node->gLoop.setWidth(height / 4);
+
+		node->gLabel.setY(y + height * 4 / 5);
+		node->gLabel.setZ(-1);
+		node->gLabel.setWidth(_hudFont.getNominalWidth(node->loop->label()) / 2);
+		node->gLabel.setHeight(height / 5);
+		node->gLabel.setColor(Qt::gray);
+	}
+
+	foreach(CutNode *node, _cutNodes) {
+		node->x = node->cut->timeIn() / timePerPixel;
+
+		node->gCut.setZ(-1);
+		node->gCut.setWidth(cutWidth);
+		if(invertedColor)
+			node->gCut.setColor(QColor(255, 255, 255));
+		else
+			node->gCut.setColor(QColor(0, 0, 0));
+		node->gCut.setHeight(height);
+		node->gCut.setY(y);
+	}
+
+	foreach(DetectNode *node, _detectNodes) {
+		PhStripDetect *detect = node->detect;
+		node->x = detect->timeIn() / timePerPixel;
+		if(node->gDetect == NULL)
+			continue;
+
+		switch (detect->type()) {
+		case PhStripDetect::Off:
+		case PhStripDetect::SemiOff:
+			node->gDetect->setY(y + detect->y() * height + detect->height() * height * 0.9);
+			node->gDetect->setHeight(detect->height() * height / 10);
+			break;
+		default:
+			node->gDetect->setY(y + detect->y() * height);
+			node->gDetect->setHeight(detect->height() * height);
+			break;
+		}
+		node->gDetect->setColor(computeColor(detect->people(), selectedPeoples, invertedColor));
+		node->gDetect->setZ(-1);
+		node->gDetect->setWidth((detect->timeOut() - detect->timeIn()) / timePerPixel);
+	}
+
+	_sceneGeneration++;
 }
 
 PhFont *PhGraphicStrip::getTextFont()
@@ -95,6 +320,7 @@ void PhGraphicStrip::draw(int x, int y, int width, int height, int nextTextX, in
 
 	_textFont.setFontFile(_settings->textFontFile());
 	_textFont.setBoldness(_settings->textBoldness());
+	_textFont.setDistanceField(_settings->textDistanceField());
 
 	_hudFont.setFontFile(_settings->hudFontFile());
 
@@ -106,14 +332,14 @@ void PhGraphicStrip::draw(int x, int y, int width, int height, int nextTextX, in
 
 	int counter = 0;
 	bool invertedColor = _settings->invertColor();
+	// The distance field text is inverted by the shader
+	_textFont.setInvertColor(invertedColor);
 
 	int lastDrawElapsed = _testTimer.elapsed();
 	//PHDEBUG << "time " << _clock.time() << " \trate " << _clock.rate();
 
 	if(height > 0) {
 		int timePerPixel = _settings->horizontalTimePerPixel();
-		_textFont.setBoldness(_settings->textBoldness());
-		_textFont.setFontFile(_settings->textFontFile());
 
 		long syncBar_X_FromLeft = width / 6;
 		long delay = (int)(24 * _settings->screenDelay() *  _clock.rate());
@@ -125,16 +351,12 @@ void PhGraphicStrip::draw(int x, int y, int width, int height, int nextTextX, in
 
 
 		if(_settings->stripTestMode()) {
-			foreach(PhStripCut * cut, _doc.cuts()) {
+			PhStripIndexRange cutRange = _doc.cutIndex().startingRange(clockTime, clockTime);
+			if(cutRange.first < cutRange.last) {
 				counter++;
-				if(cut->timeIn() == clockTime) {
-					PhGraphicSolidRect white(x, y, width, height);
-					white.setColor(Qt::white);
-					white.draw();
-
-					//This is useless to continue the foreach if the cut is displayed.
-					break;
-				}
+				PhGraphicSolidRect white(x, y, width, height);
+				white.setColor(Qt::white);
+				white.draw();
 			}
 			return;
 		}
@@ -142,38 +364,28 @@ void PhGraphicStrip::draw(int x, int y, int width, int height, int nextTextX, in
 		PhTime stripTimeIn = clockTime - syncBar_X_FromLeft * timePerPixel;
 		PhTime stripTimeOut = stripTimeIn + stripDuration;
 
+		// The tiles are rendered from the top of an offscreen buffer
+		bool tiled = _settings->tiledStrip();
+		int bandY = tiled ? 0 : y;
 
-		if(_settings->displayBackground()) {
-			//Draw backgroung picture
-			int n = width / height + 2; // compute how much background repetition do we need
-			long leftBG = 0;
-			if(offset >= 0)
-				leftBG -= offset % height;
-			else
-				leftBG -= height - ((-offset) % height);
-
-			PhGraphicTexturedRect* backgroundImage = &_backgroundImageLight;
-			if(invertedColor)
-				backgroundImage = &_backgroundImageDark;
-
-			backgroundImage->setX(x + leftBG);
-			backgroundImage->setY(y);
-			backgroundImage->setSize(height * n, height);
-			backgroundImage->setZ(-2);
-			backgroundImage->setTextureCoordinate(n, 1);
-			backgroundImage->draw();
-		}
+		if(_sceneDirty)
+			buildScene();
+		if((bandY != _layoutY) || (height != _layoutHeight) || (timePerPixel != _layoutTimePerPixel)
+		   || (invertedColor != _layoutInvertedColor) || (selectedPeoples != _layoutSelectedPeoples)
+		   || (_settings->cutWidth() != _layoutCutWidth) || (_hudFont.getFontFile() != _layoutHudFontFile)
+		   || (_textFont.distanceField() != _layoutTextDistanceField))
+			layoutScene(bandY, height, timePerPixel, invertedColor, selectedPeoples);
+
+		if(tiled)
+			drawTiles(x, y, width, height, offset, timePerPixel, invertedColor);
 		else {
-			PhGraphicSolidRect backgroundRect(x, y, width, height);
-			if(_settings->invertColor())
-				backgroundRect.setColor(QColor(_settings->backgroundColorDark()));
-			else
-				backgroundRect.setColor(QColor(_settings->backgroundColorLight()));
-
-			backgroundRect.setZ(-2);
-			backgroundRect.draw();
+			clearTiles();
+			counter += drawBand(x, y, width, height, offset, stripTimeIn, stripTimeOut, timePerPixel, invertedColor);
 		}
 
+		PhGraphicProfiler *profiler = PhGraphicProfiler::instance();
+		profiler->begin(PhGraphicProfiler::StripHudStage);
+
 		PhGraphicSolidRect syncBarRect;
 		syncBarRect.setColor(QColor(225, 86, 108));
 		syncBarRect.setSize(4, height);
@@ -181,72 +393,7 @@ void PhGraphicStrip::draw(int x, int y, int width, int height, int nextTextX, in
 
 		syncBarRect.draw();
 
-		if(_settings->displayRuler()) {
-			PhTime rulerTimeIn = _settings->rulerTimeIn();
-			PhTime timeBetweenRuler = _settings->timeBetweenRuler();
-			int rulerNumber = (stripTimeIn - rulerTimeIn) / timeBetweenRuler;
-			if (rulerNumber < 0)
-				rulerNumber = 0;
-
-			PhTime rulerTime = rulerTimeIn + rulerNumber * timeBetweenRuler;
-			PhGraphicSolidRect rulerRect;
-			PhGraphicDisc rulerDisc;
-			PhGraphicText rulerText(&_hudFont);
-			QColor rulerColor(80, 80, 80);
-			if(invertedColor)
-				rulerColor = Qt::white;
-
-			int width = 1000 / timePerPixel;
-
-			rulerRect.setColor(rulerColor);
-			rulerRect.setWidth(width);
-			rulerRect.setHeight(height / 2);
-			rulerRect.setZ(0);
-			rulerRect.setY(y);
-
-			rulerDisc.setColor(rulerColor);
-			rulerDisc.setRadius(2 * width);
-			rulerDisc.setY(y + height / 2 + 3 * width);
-			rulerDisc.setZ(0);
-
-			rulerText.setColor(rulerColor);
-			rulerText.setY(y + height / 2);
-			rulerText.setHeight(height / 2);
-			rulerText.setZ(0);
-
-
-			while (rulerTime < stripTimeOut + timeBetweenRuler) {
-				counter++;
-				int x = rulerTime / timePerPixel - offset;
-
-				rulerRect.setX(x - rulerRect.width() / 2);
-				rulerRect.draw();
-
-				QString text = QString::number(rulerNumber);
-				rulerText.setContent(text);
-				int textWidth = _hudFont.getNominalWidth(text);
-				rulerText.setWidth(textWidth);
-				rulerText.setX(x - textWidth / 2);
-				rulerText.draw();
-
-				x += timeBetweenRuler / timePerPixel / 2;
-
-				rulerRect.setX(x - rulerRect.width() / 2);
-				rulerRect.draw();
-
-				rulerDisc.setX(x);
-				rulerDisc.draw();
-
-				rulerNumber++;
-				rulerTime += timeBetweenRuler;
-			}
-		}
-
-		int minTimeBetweenPeople = 48000;
-		int timeBetweenPeopleAndText = 4000;
 		int spacing = 8;
-		QMap<float, PhStripText * > lastTextList;
-
 
 		int verticalTimePerPixel = _settings->verticalTimePerPixel();
 		bool displayNextText = _settings->displayNextText();
@@ -289,139 +436,41 @@ void PhGraphicStrip::draw(int x, int y, int width, int height, int nextTextX, in
 			}
 		}
 
-		// Display the texts
-		foreach(PhStripText * text, _doc.texts()) {
-			if( !((text->timeOut() < stripTimeIn) || (text->timeIn() > stripTimeOut)) ) {
-				counter++;
-				PhGraphicText gText(&_textFont, text->content());
-				gText.setZ(-1);
-
-				gText.setX(x + text->timeIn() / timePerPixel - offset);
-				gText.setWidth((text->timeOut() - text->timeIn()) / timePerPixel);
-				gText.setY(y + text->y() * height);
-				gText.setHeight(text->height() * height);
-				gText.setZ(-1);
-				gText.setColor(computeColor(text->people(), selectedPeoples, invertedColor));
-
-				gText.draw();
-			}
-
-			PhPeople * people = text->people();
-			QString name = people ? people->name().toLower() : "???";
-			PhGraphicText gPeople(&_hudFont, name);
-			gPeople.setWidth(_hudFont.getNominalWidth(name) / 5);
-			gPeople.setHeight(text->height() * height / 2);
-			int x0 = x + (text->timeIn() - timeBetweenPeopleAndText) / timePerPixel - offset - gPeople.width();
-
-			PhStripText * lastText = lastTextList[text->y()];
-			// Display the people name only if one of the following condition is true:
-			// - it is the first text
-			// - it is a different people
-			// - the distance between the latest text and the current is superior to a limit
-			if( x0 < width
-			    && x0 + gPeople.width() > 0
-			    && (
-			        (lastText == NULL)
-			        || (lastText->people() != text->people())
-			        || (text->timeIn() - lastText->timeOut() > minTimeBetweenPeople))
-			    ) {
-
-				gPeople.setX(x0);
-				gPeople.setY(y + text->y() * height);
-				gPeople.setZ(-1);
-
-				gPeople.setColor(computeColor(people, selectedPeoples, invertedColor));
-
-				gPeople.draw();
-			}
-
-			PhTime timePerPeopleHeight = gPeople.height() * verticalTimePerPixel;
-
-			if(displayNextText
-			   && (text->timeIn() > clockTime)
-			   && (text->timeIn() < maxTimeIn - timePerPeopleHeight)
-			   && ((lastText == NULL)
-			       || (lastText->people() != text->people())
-			       || (text->timeIn() - lastText->timeOut() > minTimeBetweenPeople))) {
-				PhPeople * people = text->people();
-
-				//This line is used to see which text's name will be displayed
-				gPeople.setX(nextTextX + spacing);
-				gPeople.setY(y - (text->timeIn() - clockTime + timePerPeopleHeight) / verticalTimePerPixel);
-				gPeople.setZ(-3);
-				gPeople.setHeight(height / 10);
-
-				if(selectedPeoples.size() && !selectedPeoples.contains(people))
-					gPeople.setColor(unselectedPeopleColor);
-				else
-					gPeople.setColor(selectedPeopleColor);
-
-				gPeople.draw();
-			}
-
-			lastTextList[text->y()] = text;
-
-			if(text->timeIn() > maxTimeIn)
-				break;
-		}
-
-		if(_settings->displayCuts()) {
-			int cutWidth = _settings->cutWidth();
-			foreach(PhStripCut * cut, _doc.cuts()) {
-				//_counter++;
-				if( (stripTimeIn < cut->timeIn()) && (cut->timeIn() < stripTimeOut)) {
-					PhGraphicSolidRect gCut;
-					gCut.setZ(-1);
-					gCut.setWidth(cutWidth);
-
-					if(invertedColor)
-						gCut.setColor(QColor(255, 255, 255));
+		if(displayNextText) {
+			// Display the next people names scrolling vertically
+			PhGraphicText gPeoplePred(&_hudFont);
+			gPeoplePred.setZ(-3);
+			gPeoplePred.setHeight(height / 10);
+
+			PhStripIndexRange textRange = _doc.textIndex().startingRange(clockTime + 1, maxTimeIn);
+			for(int i = textRange.first; i < qMin(textRange.last, _textNodes.count()); i++) {
+				TextNode *node = _textNodes.at(i);
+				PhStripText *text = node->text;
+
+				PhTime timePerPeopleHeight = node->gPeople.height() * verticalTimePerPixel;
+				if(node->displayPeople && (text->timeIn() < maxTimeIn - timePerPeopleHeight)) {
+					PhPeople * people = text->people();
+
+					//This line is used to see which text's name will be displayed
+					gPeoplePred.setContent(node->gPeople.getContent());
+					gPeoplePred.setWidth(node->gPeople.width());
+					gPeoplePred.setX(nextTextX + spacing);
+					gPeoplePred.setY(y - (text->timeIn() - clockTime + timePerPeopleHeight) / verticalTimePerPixel);
+
+					if(selectedPeoples.size() && !selectedPeoples.contains(people))
+						gPeoplePred.setColor(unselectedPeopleColor);
 					else
-						gCut.setColor(QColor(0, 0, 0));
-					gCut.setHeight(height);
-					gCut.setX(x + cut->timeIn() / timePerPixel - offset);
-					gCut.setY(y);
+						gPeoplePred.setColor(selectedPeopleColor);
 
-					gCut.draw();
+					gPeoplePred.draw();
 				}
-				//Doesn't need to process undisplayed content
-				if(cut->timeIn() > stripTimeOut)
-					break;
 			}
-		}
 
-		foreach(PhStripLoop * loop, _doc.loops()) {
-			//_counter++;
-			// This calcul allow the cross to come smoothly on the screen (height * timePerPixel / 8)
-#warning /// @todo clean this it is not clear
-			if( ((loop->timeIn() + height * timePerPixel / 8) > stripTimeIn) && ((loop->timeIn() - height * timePerPixel / 8 ) < stripTimeOut)) {
-				PhGraphicLoop gLoop;
-				if(!invertedColor)
-					gLoop.setColor(Qt::black);
-				else
-					gLoop.setColor(Qt::white);
-
-				int xLoop = x + loop->timeIn() / timePerPixel - offset;
-				gLoop.setX(xLoop);
-				gLoop.setY(y);
-				gLoop.setZ(-1);
-				gLoop.setThickness(height / 40);
-				gLoop.setHeight(height);
-				gLoop.setCrossSize(height / 4);
-				gLoop.setWidth(height / 4);
-
-				gLoop.draw();
-
-				PhGraphicText gLabel(&_hudFont, loop->label(), xLoop + 10, y + height * 4 / 5, -1);
-				gLabel.setWidth(_hudFont.getNominalWidth(loop->label()) / 2);
-				gLabel.setHeight(height / 5);
-				gLabel.setColor(Qt::gray);
-				gLabel.draw();
-			}
+			// Display the next loops
+			PhStripIndexRange loopRange = _doc.loopIndex().startingRange(clockTime + 1, maxTimeIn - 1);
+			for(int i = loopRange.first; i < qMin(loopRange.last, _loopNodes.count()); i++) {
+				PhStripLoop *loop = _loopNodes.at(i)->loop;
 
-			if(displayNextText
-			   && (loop->timeIn() > clockTime)
-			   && (loop->timeIn() < maxTimeIn)) {
 				PhGraphicLoop gLoopPred;
 
 				gLoopPred.setColor(Qt::white);
@@ -450,53 +499,6 @@ void PhGraphicStrip::draw(int x, int y, int width, int height, int nextTextX, in
 				gLabel.setColor(Qt::gray);
 				gLabel.draw();
 			}
-			if(loop->timeIn() > maxTimeIn + timePerPixel * height / 4)
-				break;
-		}
-
-		foreach(PhStripDetect * detect, _doc.detects()) {
-			//_counter++;
-
-			if((stripTimeIn < detect->timeOut()) && (detect->timeIn() < stripTimeOut) ) {
-				PhGraphicRect *gDetect = NULL;
-				switch (detect->type()) {
-				case PhStripDetect::Off:
-					gDetect = new PhGraphicSolidRect();
-					gDetect->setY(y + detect->y() * height + detect->height() * height * 0.9);
-					gDetect->setHeight(detect->height() * height / 10);
-					break;
-				case PhStripDetect::SemiOff:
-					gDetect = new PhGraphicDashedLine((detect->timeOut() - detect->timeIn()) / 1200);
-					gDetect->setY(y + detect->y() * height + detect->height() * height * 0.9);
-					gDetect->setHeight(detect->height() * height / 10);
-					break;
-				case PhStripDetect::ArrowUp:
-					gDetect = new PhGraphicArrow(PhGraphicArrow::DownLeftToUpRight);
-					gDetect->setY(y + detect->y() * height);
-					gDetect->setHeight(detect->height() * height);
-					break;
-				case PhStripDetect::ArrowDown:
-					gDetect = new PhGraphicArrow(PhGraphicArrow::UpLefToDownRight);
-					gDetect->setY(y + detect->y() * height);
-					gDetect->setHeight(detect->height() * height);
-					break;
-				default:
-					break;
-				}
-
-				if(gDetect) {
-					gDetect->setColor(computeColor(detect->people(), selectedPeoples, invertedColor));
-
-					gDetect->setX(x + detect->timeIn() / timePerPixel - offset);
-					gDetect->setZ(-1);
-					gDetect->setWidth((detect->timeOut() - detect->timeIn()) / timePerPixel);
-					gDetect->draw();
-					delete gDetect;
-				}
-			}
-			//Doesn't need to process undisplayed content
-			if(detect->timeIn() > stripTimeOut)
-				break;
 		}
 
 		// Change to display the ruler via the settings
@@ -521,6 +523,8 @@ void PhGraphicStrip::draw(int x, int y, int width, int height, int nextTextX, in
 				counter++;
 			}
 		}
+
+		profiler->end(PhGraphicProfiler::StripHudStage);
 	}
 
 	//	PHDEBUG << "off counter : " << offCounter << "cut counter : " << cutCounter << "loop counter : " << loopCounter;
@@ -532,7 +536,527 @@ void PhGraphicStrip::draw(int x, int y, int width, int height, int nextTextX, in
 
 	_infos.append(QString("Max strip draw: %1").arg(_maxDrawElapsed));
 	_infos.append(QString("Count: %1").arg(counter));
+	if(_settings->tiledStrip())
+		_infos.append(QString("Tiles: %1").arg(_tiles.count()));
+	if(_settings->gpuStrip())
+		_infos.append(QString("Strip vertices: %1").arg(_buffer.vertexCount()));
 
 	if(_settings->resetInfo())
 		_maxDrawElapsed = 0;
 }
+
+int PhGraphicStrip::drawBand(int x, int y, int width, int height, long offset, PhTime stripTimeIn, PhTime stripTimeOut, int timePerPixel, bool invertedColor)
+{
+	int counter = 0;
+
+	PhGraphicProfiler *profiler = PhGraphicProfiler::instance();
+	profiler->begin(PhGraphicProfiler::StripBackgroundStage);
+
+	if(_settings->displayBackground()) {
+		//Draw backgroung picture
+		int n = width / height + 2; // compute how much background repetition do we need
+		long leftBG = 0;
+		if(offset >= 0)
+			leftBG -= offset % height;
+		else
+			leftBG -= height - ((-offset) % height);
+
+		PhGraphicTexturedRect* backgroundImage = &_backgroundImageLight;
+		if(invertedColor)
+			backgroundImage = &_backgroundImageDark;
+
+		backgroundImage->setX(x + leftBG);
+		backgroundImage->setY(y);
+		backgroundImage->setSize(height * n, height);
+		backgroundImage->setZ(-2);
+		backgroundImage->setTextureCoordinate(n, 1);
+		backgroundImage->draw();
+	}
+	else {
+		PhGraphicSolidRect backgroundRect(x, y, width, height);
+		if(invertedColor)
+			backgroundRect.setColor(QColor(_settings->backgroundColorDark()));
+		else
+			backgroundRect.setColor(QColor(_settings->backgroundColorLight()));
+
+		backgroundRect.setZ(-2);
+		backgroundRect.draw();
+	}
+
+	if(_settings->displayRuler()) {
+		PhTime rulerTimeIn = _settings->rulerTimeIn();
+		PhTime timeBetweenRuler = _settings->timeBetweenRuler();
+		int rulerNumber = (stripTimeIn - rulerTimeIn) / timeBetweenRuler;
+		if (rulerNumber < 0)
+			rulerNumber = 0;
+
+		PhTime rulerTime = rulerTimeIn + rulerNumber * timeBetweenRuler;
+		PhGraphicSolidRect rulerRect;
+		PhGraphicDisc rulerDisc;
+		PhGraphicText rulerText(&_hudFont);
+		QColor rulerColor(80, 80, 80);
+		if(invertedColor)
+			rulerColor = Qt::white;
+
+		int width = 1000 / timePerPixel;
+
+		rulerRect.setColor(rulerColor);
+		rulerRect.setWidth(width);
+		rulerRect.setHeight(height / 2);
+		rulerRect.setZ(0);
+		rulerRect.setY(y);
+
+		rulerDisc.setColor(rulerColor);
+		rulerDisc.setRadius(2 * width);
+		rulerDisc.setY(y + height / 2 + 3 * width);
+		rulerDisc.setZ(0);
+
+		rulerText.setColor(rulerColor);
+		rulerText.setY(y + height / 2);
+		rulerText.setHeight(height / 2);
+		rulerText.setZ(0);
+
+
+		while (rulerTime < stripTimeOut + timeBetweenRuler) {
+			counter++;
+			int x = rulerTime / timePerPixel - offset;
+
+			rulerRect.setX(x - rulerRect.width() / 2);
+			rulerRect.draw();
+
+			QString text = QString::number(rulerNumber);
+			rulerText.setContent(text);
+			int textWidth = _hudFont.getNominalWidth(text);
+			rulerText.setWidth(textWidth);
+			rulerText.setX(x - textWidth / 2);
+			rulerText.draw();
+
+			x += timeBetweenRuler / timePerPixel / 2;
+
+			rulerRect.setX(x - rulerRect.width() / 2);
+			rulerRect.draw();
+
+			rulerDisc.setX(x);
+			rulerDisc.draw();
+
+			rulerNumber++;
+			rulerTime += timeBetweenRuler;
+		}
+	}
+
+	profiler->end(PhGraphicProfiler::StripBackgroundStage);
+
+	// The buffer draws all the band objects at once
+	if(_settings->gpuStrip()) {
+		PhGraphicProfilerScope scope(PhGraphicProfiler::StripTextStage);
+		return counter + drawBuffer(x, y, width, height, stripTimeIn, timePerPixel, invertedColor);
+	}
+
+	// Only the position of the visible nodes is updated.
+	// The nodes share the positions of the document indexes which give
+	// the positions of the objects visible on the band.
+
+	// Display the texts
+	profiler->begin(PhGraphicProfiler::StripTextStage);
+	// The people name is displayed before the text.
+	// The visibility is tested on the times of the index, not on the texts.
+	const PhStripIndex<PhStripText> &textIndex = _doc.textIndex();
+	foreach(int i, textIndex.overlappingPositions(stripTimeIn, stripTimeOut + _maxPeopleLead * timePerPixel)) {
+		if(i >= _textNodes.count())
+			break;
+		TextNode *node = _textNodes.at(i);
+		if( !((textIndex.timeOut(i) < stripTimeIn) || (textIndex.timeIn(i) > stripTimeOut)) ) {
+			counter++;
+			node->gText.setX(x + node->x - offset);
+			node->gText.draw();
+		}
+
+		int x0 = x + node->peopleX - offset;
+		if(node->displayPeople && (x0 < width) && (x0 + node->gPeople.width() > 0)) {
+			node->gPeople.setX(x0);
+			node->gPeople.draw();
+		}
+	}
+	profiler->end(PhGraphicProfiler::StripTextStage);
+
+	profiler->begin(PhGraphicProfiler::StripBackgroundStage);
+	if(_settings->displayCuts()) {
+		PhStripIndexRange cutRange = _doc.cutIndex().startingRange(stripTimeIn + 1, stripTimeOut - 1);
+		for(int i = cutRange.first; i < qMin(cutRange.last, _cutNodes.count()); i++) {
+			CutNode *node = _cutNodes.at(i);
+			node->gCut.setX(x + node->x - offset);
+			node->gCut.draw();
+		}
+	}
+
+	// This calcul allow the cross to come smoothly on the screen (height * timePerPixel / 8)
+	PhTime loopMargin = height * timePerPixel / 8;
+	PhStripIndexRange loopRange = _doc.loopIndex().startingRange(stripTimeIn - loopMargin + 1, stripTimeOut + loopMargin - 1);
+	for(int i = loopRange.first; i < qMin(loopRange.last, _loopNodes.count()); i++) {
+		LoopNode *node = _loopNodes.at(i);
+		int xLoop = x + node->x - offset;
+		node->gLoop.setX(xLoop);
+		node->gLoop.draw();
+
+		node->gLabel.setX(xLoop + 10);
+		node->gLabel.draw();
+	}
+	profiler->end(PhGraphicProfiler::StripBackgroundStage);
+
+	profiler->begin(PhGraphicProfiler::StripDetectStage);
+	const PhStripIndex<PhStripDetect> &detectIndex = _doc.detectIndex();
+	foreach(int i, detectIndex.overlappingPositions(stripTimeIn, stripTimeOut)) {
+		if(i >= _detectNodes.count())
+			break;
+		DetectNode *node = _detectNodes.at(i);
+		if(node->gDetect && (stripTimeIn < detectIndex.timeOut(i)) && (detectIndex.timeIn(i) < stripTimeOut)) {
+			node->gDetect->setX(x + node->x - offset);
+			node->gDetect->draw();
+		}
+	}
+	profiler->end(PhGraphicProfiler::StripDetectStage);
+
+	return counter;
+}
+
+/**
+ * @brief Integer division rounded toward negative infinity
+ * @param value A value
+ * @param divisor A positive divisor
+ * @return The quotient
+ */
+static long floorDiv(long value, long divisor)
+{
+	return (value >= 0) ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+void PhGraphicStrip::drawTiles(int x, int y, int width, int height, long offset, int timePerPixel, bool invertedColor)
+{
+	// Anything changing the band content makes the tiles outdated
+	QString signature = QString("%1 %2 %3 %4 %5").arg(width).arg(height).arg(timePerPixel).arg(invertedColor).arg(_sceneGeneration);
+	signature += QString(" %1 %2 %3 %4 %5").arg(_settings->displayBackground())
+	             .arg(_settings->backgroundImageLight()).arg(_settings->backgroundImageDark())
+	             .arg(_settings->backgroundColorLight()).arg(_settings->backgroundColorDark());
+	signature += QString(" %1 %2 %3 %4").arg(_settings->displayRuler()).arg(_settings->rulerTimeIn())
+	             .arg(_settings->timeBetweenRuler()).arg(_settings->displayCuts());
+	signature += QString(" %1 %2 %3").arg(_textFont.getFontFile()).arg(_textFont.getBoldness()).arg(_textFont.distanceField());
+	if(signature != _tileSignature) {
+		_spareTiles.append(_tiles.values());
+		_tiles.clear();
+		_tileSignature = signature;
+	}
+
+	// Each tile covers a strip width, starting from the time origin
+	long first = floorDiv(offset, width);
+	long last = floorDiv(offset + width - 1, width);
+
+	foreach(long index, _tiles.keys()) {
+		if((index < first - 1) || (index > last + 1))
+			_spareTiles.append(_tiles.take(index));
+	}
+
+	for(long index = first; index <= last; index++) {
+		if(!_tiles.contains(index))
+			_tiles[index] = renderTile(index, width, height, timePerPixel, invertedColor);
+	}
+
+	// Prepare the next tile in the playing direction
+	long next = (_clock.rate() < 0) ? first - 1 : last + 1;
+	if(!_tiles.contains(next))
+		_tiles[next] = renderTile(next, width, height, timePerPixel, invertedColor);
+
+	PhGraphicBatch *batch = PhGraphicBatch::instance();
+	QColor white(Qt::white);
+	for(long index = first; index <= last; index++) {
+		int left = x + index * width - offset;
+		// The framebuffer texture origin is its bottom left corner
+		batch->addQuad(_tiles[index]->texture(), PhGraphicBatch::NoBlend,
+		               PhGraphicBatch::vertex(left,         y,          -2, white, 0, 1),
+		               PhGraphicBatch::vertex(left + width, y,          -2, white, 1, 1),
+		               PhGraphicBatch::vertex(left + width, y + height, -2, white, 1, 0),
+		               PhGraphicBatch::vertex(left,         y + height, -2, white, 0, 0));
+	}
+}
+
+QGLFramebufferObject *PhGraphicStrip::renderTile(long index, int width, int height, int timePerPixel, bool invertedColor)
+{
+	// The pending primitives belong to the current target
+	PhGraphicBatch::instance()->flush();
+
+	QGLFramebufferObject *tile = NULL;
+	while(!_spareTiles.isEmpty() && (tile == NULL)) {
+		tile = _spareTiles.takeLast();
+		if(tile->size() != QSize(width, height)) {
+			delete tile;
+			tile = NULL;
+		}
+	}
+	if(tile == NULL)
+		tile = new QGLFramebufferObject(width, height, QGLFramebufferObject::Depth);
+
+	// The strip may itself be drawn into a framebuffer
+	GLint previousFramebuffer;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	GLfloat clearColor[4];
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+
+	tile->bind();
+	glViewport(0, 0, width, height);
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	glOrtho(0, width, height, 0, -10, 10);
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	glClearColor(0, 0, 0, 1);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	long offset = index * width;
+	PhTime stripTimeIn = offset * timePerPixel;
+	drawBand(0, 0, width, height, offset, stripTimeIn, stripTimeIn + width * timePerPixel, timePerPixel, invertedColor);
+	PhGraphicBatch::instance()->flush();
+
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPopMatrix();
+	QOpenGLContext::currentContext()->functions()->glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+
+	return tile;
+}
+
+void PhGraphicStrip::clearTiles()
+{
+	qDeleteAll(_tiles);
+	_tiles.clear();
+	qDeleteAll(_spareTiles);
+	_spareTiles.clear();
+}
+
+void PhGraphicStrip::buildBuffer()
+{
+	_buffer.clear();
+
+	// The people colors are looked up by index, 0 being used for the texts without people
+	QHash<PhPeople*, int> peopleIndexes;
+	foreach(PhPeople *people, _doc.peoples())
+		peopleIndexes[people] = peopleIndexes.count() + 1;
+
+	PhTime timeBetweenPeopleAndText = 4000;
+	foreach(TextNode *node, _textNodes) {
+		PhStripText *text = node->text;
+		int people = peopleIndexes.value(text->people(), 0);
+
+		_buffer.beginObject(PhGraphicStripBuffer::TextLayer, text->timeIn(), text->timeOut() - text->timeIn());
+		addGlyphs(PhGraphicStripBuffer::TextLayer, &_textFont, people, node->gText.getContent(),
+		          text->timeIn(), text->timeOut() - text->timeIn(), 0, 0, text->y(), text->height());
+
+		if(node->displayPeople) {
+			QString name = node->gPeople.getContent();
+			float nameWidth = _hudFont.getNominalWidth(name) / 5;
+			_buffer.beginObject(PhGraphicStripBuffer::HudLayer, text->timeIn() - timeBetweenPeopleAndText, 0);
+			addGlyphs(PhGraphicStripBuffer::HudLayer, &_hudFont, people, name,
+			          text->timeIn() - timeBetweenPeopleAndText, 0, -nameWidth, nameWidth, text->y(), text->height() / 2);
+		}
+	}
+
+	// The loop sizes are relative to the strip height (see layoutScene())
+	float halfThickness = 1.0f / 80;
+	float halfCrossSize = 1.0f / 8;
+	float crossThickness = 1.0f / 120;
+	foreach(LoopNode *node, _loopNodes) {
+		PhTime time = node->loop->timeIn();
+		_buffer.beginObject(PhGraphicStripBuffer::ShapeLayer, time, 0);
+		_buffer.addQuad(PhGraphicStripBuffer::ShapeLayer, PhGraphicStripBuffer::InkColor,
+		                PhGraphicStripBuffer::point(time, 0, -halfThickness, 0),
+		                PhGraphicStripBuffer::point(time, 0, halfThickness, 0),
+		                PhGraphicStripBuffer::point(time, 0, halfThickness, 1),
+		                PhGraphicStripBuffer::point(time, 0, -halfThickness, 1));
+		_buffer.addQuad(PhGraphicStripBuffer::ShapeLayer, PhGraphicStripBuffer::InkColor,
+		                PhGraphicStripBuffer::point(time, 0, -halfCrossSize + crossThickness, 0.5f - halfCrossSize - crossThickness),
+		                PhGraphicStripBuffer::point(time, 0, -halfCrossSize - crossThickness, 0.5f - halfCrossSize + crossThickness),
+		                PhGraphicStripBuffer::point(time, 0, halfCrossSize - crossThickness, 0.5f + halfCrossSize + crossThickness),
+		                PhGraphicStripBuffer::point(time, 0, halfCrossSize + crossThickness, 0.5f + halfCrossSize - crossThickness));
+		_buffer.addQuad(PhGraphicStripBuffer::ShapeLayer, PhGraphicStripBuffer::InkColor,
+		                PhGraphicStripBuffer::point(time, 0, halfCrossSize - crossThickness, 0.5f - halfCrossSize - crossThickness),
+		                PhGraphicStripBuffer::point(time, 0, halfCrossSize + crossThickness, 0.5f - halfCrossSize + crossThickness),
+		                PhGraphicStripBuffer::point(time, 0, -halfCrossSize + crossThickness, 0.5f + halfCrossSize + crossThickness),
+		                PhGraphicStripBuffer::point(time, 0, -halfCrossSize - crossThickness, 0.5f + halfCrossSize - crossThickness));
+
+		QString label = node->loop->label();
+		_buffer.beginObject(PhGraphicStripBuffer::HudLayer, time, 0);
+		addGlyphs(PhGraphicStripBuffer::HudLayer, &_hudFont, PhGraphicStripBuffer::GrayColor, label,
+		          time, 0, 10, _hudFont.getNominalWidth(label) / 2, 0.8f, 0.2f);
+	}
+
+	if(_settings->displayCuts()) {
+		int cutWidth = _settings->cutWidth();
+		foreach(CutNode *node, _cutNodes) {
+			PhTime time = node->cut->timeIn();
+			_buffer.beginObject(PhGraphicStripBuffer::ShapeLayer, time, 0);
+			_buffer.addQuad(PhGraphicStripBuffer::ShapeLayer, PhGraphicStripBuffer::InkColor,
+			                PhGraphicStripBuffer::point(time, 0, 0, 0),
+			                PhGraphicStripBuffer::point(time, cutWidth, 0, 0),
+			                PhGraphicStripBuffer::point(time, cutWidth, 0, 1),
+			                PhGraphicStripBuffer::point(time, 0, 0, 1));
+		}
+	}
+
+	foreach(DetectNode *node, _detectNodes) {
+		PhStripDetect *detect = node->detect;
+		PhTime timeIn = detect->timeIn();
+		PhTime timeOut = detect->timeOut();
+		PhTime duration = timeOut - timeIn;
+		int people = peopleIndexes.value(detect->people(), 0);
+		float top = detect->y();
+		float height = detect->height();
+		float bottom = top + height;
+		// Same geometry as PhGraphicArrow
+		float thickness = height / 10;
+		float nose = height / 3;
+
+		switch (detect->type()) {
+		case PhStripDetect::Off:
+			_buffer.beginObject(PhGraphicStripBuffer::ShapeLayer, timeIn, duration);
+			_buffer.addQuad(PhGraphicStripBuffer::ShapeLayer, people,
+			                PhGraphicStripBuffer::point(timeIn, 0, 0, top + height * 0.9f),
+			                PhGraphicStripBuffer::point(timeOut, 0, 0, top + height * 0.9f),
+			                PhGraphicStripBuffer::point(timeOut, 0, 0, bottom),
+			                PhGraphicStripBuffer::point(timeIn, 0, 0, bottom));
+			break;
+		case PhStripDetect::SemiOff:
+		{
+			// Same dashes as PhGraphicDashedLine
+			int dashCount = duration / 1200;
+			if(dashCount <= 0)
+				break;
+			PhTime dashDuration = duration / (2 * dashCount - 1);
+			_buffer.beginObject(PhGraphicStripBuffer::ShapeLayer, timeIn, duration);
+			for(int i = 0; i < dashCount; i++) {
+				PhTime dashIn = timeIn + 2 * i * dashDuration;
+				_buffer.addQuad(PhGraphicStripBuffer::ShapeLayer, people,
+				                PhGraphicStripBuffer::point(dashIn, 0, 0, top + height * 0.9f),
+				                PhGraphicStripBuffer::point(dashIn + dashDuration, 0, 0, top + height * 0.9f),
+				                PhGraphicStripBuffer::point(dashIn + dashDuration, 0, 0, bottom),
+				                PhGraphicStripBuffer::point(dashIn, 0, 0, bottom));
+			}
+			break;
+		}
+		case PhStripDetect::ArrowUp:
+			_buffer.beginObject(PhGraphicStripBuffer::ShapeLayer, timeIn, duration);
+			_buffer.addQuad(PhGraphicStripBuffer::ShapeLayer, people,
+			                PhGraphicStripBuffer::point(timeIn, 0, 0, top + thickness),
+			                PhGraphicStripBuffer::point(timeIn, 0, thickness, top),
+			                PhGraphicStripBuffer::point(timeOut, 0, 0, bottom - thickness),
+			                PhGraphicStripBuffer::point(timeOut, 0, -thickness, bottom));
+			_buffer.addTriangle(PhGraphicStripBuffer::ShapeLayer, people,
+			                    PhGraphicStripBuffer::point(timeOut, 0, 0, bottom),
+			                    PhGraphicStripBuffer::point(timeOut, 0, -nose, bottom),
+			                    PhGraphicStripBuffer::point(timeOut, 0, 0, bottom - nose));
+			break;
+		case PhStripDetect::ArrowDown:
+			_buffer.beginObject(PhGraphicStripBuffer::ShapeLayer, timeIn, duration);
+			_buffer.addQuad(PhGraphicStripBuffer::ShapeLayer, people,
+			                PhGraphicStripBuffer::point(timeOut, 0, -thickness, top),
+			                PhGraphicStripBuffer::point(timeIn, 0, 0, bottom - thickness),
+			                PhGraphicStripBuffer::point(timeIn, 0, thickness, bottom),
+			                PhGraphicStripBuffer::point(timeOut, 0, 0, top + thickness));
+			_buffer.addTriangle(PhGraphicStripBuffer::ShapeLayer, people,
+			                    PhGraphicStripBuffer::point(timeOut, 0, 0, top),
+			                    PhGraphicStripBuffer::point(timeOut, 0, -nose, top),
+			                    PhGraphicStripBuffer::point(timeOut, 0, 0, top + nose));
+			break;
+		default:
+			break;
+		}
+	}
+
+	_bufferDirty = false;
+	// Force the people colors update
+	_bufferSceneGeneration = -1;
+}
+
+void PhGraphicStrip::addGlyphs(PhGraphicStripBuffer::Layer layer, PhFont *font, int people, QString content,
+                               PhTime time, PhTime duration, float pixelX, float pixelWidth, float track, float trackHeight)
+{
+	// Same layout as PhGraphicText::draw(), the text spanning both a duration and a pixel width
+	int totalAdvance = 0;
+	for(int i = 0; i < content.length(); i++)
+		totalAdvance += font->getAdvance(content.at(i).unicode());
+	if((totalAdvance == 0) || (font->getHeight() == 0))
+		return;
+
+	float timeScale = (float)duration / totalAdvance;
+	float pixelScale = pixelWidth / totalAdvance;
+	float trackScale = trackHeight / font->getHeight();
+	float atlasSize = PhFont::atlasSize();
+	int padding = font->getPadding();
+
+	float track1 = track - padding * trackScale;
+	int advance = 0;
+	for(int i = 0; i < content.length(); i++) {
+		PhFont::Glyph glyph = font->glyph(content.at(i).unicode());
+		if(glyph.width > 0) {
+			float tu1 = glyph.x / atlasSize;
+			float tv1 = glyph.y / atlasSize;
+			float tu2 = (glyph.x + glyph.width) / atlasSize;
+			float tv2 = (glyph.y + glyph.height) / atlasSize;
+
+			PhTime time1 = time + (PhTime)((advance - padding) * timeScale);
+			PhTime time2 = time1 + (PhTime)(glyph.width * timeScale);
+			float x1 = pixelX + (advance - padding) * pixelScale;
+			float x2 = x1 + glyph.width * pixelScale;
+			float track2 = track1 + glyph.height * trackScale;
+			_buffer.addQuad(layer, people,
+			                PhGraphicStripBuffer::point(time1, x1, 0, track1, tu1, tv1),
+			                PhGraphicStripBuffer::point(time2, x2, 0, track1, tu2, tv1),
+			                PhGraphicStripBuffer::point(time2, x2, 0, track2, tu2, tv2),
+			                PhGraphicStripBuffer::point(time1, x1, 0, track2, tu1, tv2));
+		}
+		advance += glyph.advance;
+	}
+}
+
+int PhGraphicStrip::drawBuffer(int x, int y, int width, int height, PhTime stripTimeIn, int timePerPixel, bool invertedColor)
+{
+	// The glyph positions in the font atlas and the cuts depend on these settings
+	QString signature = QString("%1 %2 %3 %4").arg(_textFont.getFontFile()).arg(_textFont.getBoldness())
+	                    .arg(_textFont.distanceField()).arg(_hudFont.getFontFile());
+	signature += QString(" %1 %2").arg(_settings->displayCuts()).arg(_settings->cutWidth());
+	if(_bufferDirty || (signature != _bufferSignature)) {
+		buildBuffer();
+		_bufferSignature = signature;
+	}
+
+	// The colors and the selection only change with the layout
+	if(_bufferSceneGeneration != _sceneGeneration) {
+		QVector<QColor> colors;
+		colors.append(QColor(0, 0, 0, 0));
+		foreach(PhPeople *people, _doc.peoples()) {
+			QColor color(people->color());
+			color.setAlpha(_layoutSelectedPeoples.contains(people) ? 255 : 0);
+			colors.append(color);
+		}
+		_buffer.setPeopleColors(colors, !_layoutSelectedPeoples.isEmpty());
+		_bufferSceneGeneration = _sceneGeneration;
+	}
+
+	PhGraphicStripBuffer::Frame frame;
+	frame.x = x;
+	frame.y = y;
+	frame.width = width;
+	frame.height = height;
+	frame.stripTimeIn = stripTimeIn;
+	frame.timePerPixel = timePerPixel;
+	frame.invertColor = invertedColor;
+	frame.textFont = &_textFont;
+	frame.hudFont = &_hudFont;
+	return _buffer.draw(frame);
+}
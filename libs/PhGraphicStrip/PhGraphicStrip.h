@@ -10,11 +10,17 @@
 #include "PhTools/PhGeneric.h"
 
 #include "PhGraphicStripSettings.h"
+#include "PhGraphicStripBuffer.h"
 
 #include "PhStrip/PhStripDoc.h"
 
 #include "PhGraphic/PhFont.h"
 #include "PhGraphic/PhGraphicImage.h"
+#include "PhGraphic/PhGraphicText.h"
+#include "PhGraphic/PhGraphicSolidRect.h"
+#include "PhGraphic/PhGraphicLoop.h"
+
+#include <QGLFramebufferObject>
 
 #include "PhSync/PhClock.h"
 
@@ -42,6 +48,22 @@
  * The portion of strip band scroll smoothly according to the current rate.
  *
  * The font used by the text is customisable.
+ *
+ * The graphic objects of the strip band (texts, people names, cuts, loops and
+ * detects) are built once when the document changes and laid out again only
+ * when the strip geometry, the colors or the selected peoples change. While
+ * the clock moves, only their horizontal position is updated.
+ *
+ * When PhGraphicStripSettings::tiledStrip() is set, the band is rendered
+ * into offscreen tiles of one strip width, aligned on the time origin.
+ * The tiles are kept until the band content changes and the next one is
+ * prepared in the playing direction, so that a paint only composites the
+ * two or three visible tiles. The framebuffers of the tiles leaving the
+ * screen are reused for the next ones.
+ *
+ * When PhGraphicStripSettings::gpuStrip() is set, the band objects are
+ * stored once in a PhGraphicStripBuffer and positioned by the graphic card
+ * from the strip time, so that a paint only selects the visible range.
  */
 class PhGraphicStrip : public QObject
 {
@@ -53,6 +75,8 @@ public:
 	 */
 	explicit PhGraphicStrip(PhGraphicStripSettings * settings);
 
+	~PhGraphicStrip();
+
 	/**
 	 * Get the PhStripDoc attached to the .
 	 * @return A PhStripDoc instance.
@@ -121,6 +145,77 @@ private slots:
 	void onDocChanged();
 
 private:
+	/**
+	 * @brief The graphic objects of a strip text
+	 */
+	struct TextNode {
+		TextNode(PhStripText *text, PhFont *textFont, PhFont *hudFont);
+		/** The text in the document */
+		PhStripText *text;
+		/** The text on the strip band */
+		PhGraphicText gText;
+		/** The people name preceding the text */
+		PhGraphicText gPeople;
+		/** True if the people name is displayed before the text */
+		bool displayPeople;
+		/** The horizontal position of the text relative to the strip origin */
+		long x;
+		/** The horizontal position of the people name relative to the strip origin */
+		long peopleX;
+	};
+
+	/**
+	 * @brief The graphic objects of a strip loop
+	 */
+	struct LoopNode {
+		LoopNode(PhStripLoop *loop, PhFont *hudFont);
+		/** The loop in the document */
+		PhStripLoop *loop;
+		/** The loop on the strip band */
+		PhGraphicLoop gLoop;
+		/** The loop label */
+		PhGraphicText gLabel;
+		/** The horizontal position of the loop relative to the strip origin */
+		long x;
+	};
+
+	/**
+	 * @brief The graphic object of a strip cut
+	 */
+	struct CutNode {
+		/** The cut in the document */
+		PhStripCut *cut;
+		/** The cut on the strip band */
+		PhGraphicSolidRect gCut;
+		/** The horizontal position of the cut relative to the strip origin */
+		long x;
+	};
+
+	/**
+	 * @brief The graphic object of a strip detect
+	 */
+	struct DetectNode {
+		~DetectNode();
+		/** The detect in the document */
+		PhStripDetect *detect;
+		/** The detect on the strip band (NULL if the detect is not displayed) */
+		PhGraphicRect *gDetect;
+		/** The horizontal position of the detect relative to the strip origin */
+		long x;
+	};
+
+	void clearScene();
+	void buildScene();
+	void layoutScene(int y, int height, int timePerPixel, bool invertedColor, QList<PhPeople *> selectedPeoples);
+	int drawBand(int x, int y, int width, int height, long offset, PhTime stripTimeIn, PhTime stripTimeOut, int timePerPixel, bool invertedColor);
+	void drawTiles(int x, int y, int width, int height, long offset, int timePerPixel, bool invertedColor);
+	QGLFramebufferObject *renderTile(long index, int width, int height, int timePerPixel, bool invertedColor);
+	void clearTiles();
+	void buildBuffer();
+	void addGlyphs(PhGraphicStripBuffer::Layer layer, PhFont *font, int people, QString content,
+	               PhTime time, PhTime duration, float pixelX, float pixelWidth, float track, float trackHeight);
+	int drawBuffer(int x, int y, int width, int height, PhTime stripTimeIn, int timePerPixel, bool invertedColor);
+
 	PhGraphicStripSettings * _settings;
 
 	/**
@@ -158,6 +253,33 @@ private:
 	QColor computeColor(PhPeople *people, QList<PhPeople *> selectedPeoples, bool invertColor);
 
 	QStringList _infos;
+
+	QList<TextNode*> _textNodes;
+	QList<LoopNode*> _loopNodes;
+	QList<CutNode*> _cutNodes;
+	QList<DetectNode*> _detectNodes;
+	bool _sceneDirty;
+
+	// The parameters of the last layout
+	int _layoutY, _layoutHeight, _layoutTimePerPixel, _layoutCutWidth;
+	bool _layoutInvertedColor, _layoutTextDistanceField;
+	QList<PhPeople*> _layoutSelectedPeoples;
+	QString _layoutHudFontFile;
+	// The longest distance between a people name and its text
+	long _maxPeopleLead;
+	// Incremented on each layout
+	int _sceneGeneration;
+
+	QMap<long, QGLFramebufferObject*> _tiles;
+	// The framebuffers of the outdated tiles, ready to be rendered again
+	QList<QGLFramebufferObject*> _spareTiles;
+	QString _tileSignature;
+
+	PhGraphicStripBuffer _buffer;
+	bool _bufferDirty;
+	QString _bufferSignature;
+	// The scene generation of the buffer people colors
+	int _bufferSceneGeneration;
 };
 
 #endif // PHGRAPHICSTRIP_H
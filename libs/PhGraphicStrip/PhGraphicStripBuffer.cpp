@@ -0,0 +1,403 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include <algorithm>
+#include <cstddef>
+
+#include "PhTools/PhDebug.h"
+#include "PhGraphic/PhGraphicBatch.h"
+
+#include "PhGraphicStripBuffer.h"
+
+// The time is split in two floats to keep the tick precision on long documents
+#define PHSTRIPBUFFER_TIME_UNIT 65536
+
+static const char *stripVertexShader =
+    "attribute vec2 time;\n"
+    "attribute vec3 position;\n"
+    "attribute vec2 texCoord;\n"
+    "attribute float people;\n"
+    "uniform vec2 stripTimeIn;\n"
+    "uniform float timePerPixel;\n"
+    "uniform vec2 origin;\n"
+    "uniform float stripHeight;\n"
+    "varying vec2 atlasCoord;\n"
+    "varying float peopleIndex;\n"
+    "void main()\n"
+    "{\n"
+    "	float x = ((time.x - stripTimeIn.x) * 65536.0 + (time.y - stripTimeIn.y)) / timePerPixel;\n"
+    "	x += origin.x + position.x + position.y * stripHeight;\n"
+    "	float y = origin.y + position.z * stripHeight;\n"
+    "	gl_Position = gl_ModelViewProjectionMatrix * vec4(x, y, -1.0, 1.0);\n"
+    "	atlasCoord = texCoord;\n"
+    "	peopleIndex = people;\n"
+    "}\n";
+
+static const char *stripFragmentShader =
+    "uniform sampler2D atlas;\n"
+    "uniform sampler2D peopleColors;\n"
+    "uniform float peopleCount;\n"
+    "uniform float selection;\n"
+    "uniform float invertColor;\n"
+    "uniform float textured;\n"
+    "uniform float distanceField;\n"
+    "uniform float threshold;\n"
+    "uniform float outlineWidth;\n"
+    "uniform vec4 outlineColor;\n"
+    "varying vec2 atlasCoord;\n"
+    "varying float peopleIndex;\n"
+    "void main()\n"
+    "{\n"
+    "	vec3 color = vec3(160.0, 160.0, 164.0) / 255.0;\n"
+    "	if(peopleIndex > -1.5) {\n"
+    "		color = vec3(0.0);\n"
+    "		if(peopleIndex > -0.5) {\n"
+    "			vec4 people = texture2D(peopleColors, vec2((peopleIndex + 0.5) / peopleCount, 0.5));\n"
+    "			color = people.rgb;\n"
+    "			if((selection > 0.5) && (people.a < 0.5))\n"
+    "				color = vec3(100.0 / 255.0);\n"
+    "		}\n"
+    "		color = mix(color, vec3(1.0) - color, invertColor);\n"
+    "	}\n"
+    "	float alpha = 1.0;\n"
+    "	if(textured > 0.5) {\n"
+    "		float value = texture2D(atlas, atlasCoord).a;\n"
+    "		if(distanceField > 0.5) {\n"
+    "			float smoothing = 0.5 * fwidth(value);\n"
+    "			float fill = smoothstep(threshold - smoothing, threshold + smoothing, value);\n"
+    "			float edge = threshold - outlineWidth;\n"
+    "			float shape = smoothstep(edge - smoothing, edge + smoothing, value);\n"
+    "			alpha = mix(outlineColor.a, 1.0, fill) * shape;\n"
+    "			color = mix(outlineColor.rgb, color, fill);\n"
+    "		}\n"
+    "		else\n"
+    "			alpha = value;\n"
+    "	}\n"
+    "	gl_FragColor = vec4(color, alpha);\n"
+    "}\n";
+
+/**
+ * @brief The high part of a time, rounded toward negative infinity
+ * @param time A time
+ * @return A multiple of PHSTRIPBUFFER_TIME_UNIT divided by it
+ */
+static PhTime timeHigh(PhTime time)
+{
+	return (time >= 0) ? time / PHSTRIPBUFFER_TIME_UNIT : -((-time + PHSTRIPBUFFER_TIME_UNIT - 1) / PHSTRIPBUFFER_TIME_UNIT);
+}
+
+PhGraphicStripBuffer::PhGraphicStripBuffer() :
+	_uploaded(false),
+	_program(NULL),
+	_buffer(0),
+	_peopleTexture(0),
+	_peopleColorsChanged(false),
+	_selection(false)
+{
+	clear();
+}
+
+PhGraphicStripBuffer::~PhGraphicStripBuffer()
+{
+	// The graphic card objects can only be released with their context
+	if(_program && QGLContext::currentContext()) {
+		_functions.glDeleteBuffers(1, &_buffer);
+		glDeleteTextures(1, &_peopleTexture);
+	}
+	delete _program;
+}
+
+PhGraphicStripBuffer::Point PhGraphicStripBuffer::point(PhTime time, float pixelX, float heightX, float track, float u, float v)
+{
+	Point result;
+	result.time = time;
+	result.pixelX = pixelX;
+	result.heightX = heightX;
+	result.track = track;
+	result.u = u;
+	result.v = v;
+	return result;
+}
+
+void PhGraphicStripBuffer::clear()
+{
+	for(int i = 0; i < LayerCount; i++) {
+		LayerData &layer = _layers[i];
+		layer.objects.clear();
+		layer.vertices.clear();
+		layer.maxDuration = 0;
+		layer.maxPixelX = 0;
+		layer.maxHeightX = 0;
+		layer.firstVertex = 0;
+	}
+	_uploaded = false;
+}
+
+void PhGraphicStripBuffer::beginObject(Layer layer, PhTime timeIn, PhTime duration)
+{
+	LayerData &data = _layers[layer];
+	Object object;
+	object.timeIn = timeIn;
+	object.duration = duration;
+	object.firstVertex = data.vertices.count();
+	object.vertexCount = 0;
+	data.objects.append(object);
+	data.maxDuration = qMax(data.maxDuration, duration);
+	_uploaded = false;
+}
+
+void PhGraphicStripBuffer::addQuad(Layer layer, int people, const Point &p1, const Point &p2, const Point &p3, const Point &p4)
+{
+	addTriangle(layer, people, p1, p2, p3);
+	addTriangle(layer, people, p1, p3, p4);
+}
+
+void PhGraphicStripBuffer::addTriangle(Layer layer, int people, const Point &p1, const Point &p2, const Point &p3)
+{
+	append(layer, people, p1);
+	append(layer, people, p2);
+	append(layer, people, p3);
+}
+
+void PhGraphicStripBuffer::append(Layer layer, int people, const Point &p)
+{
+	LayerData &data = _layers[layer];
+	if(data.objects.isEmpty()) {
+		PHDEBUG << "No object started in layer" << layer;
+		return;
+	}
+
+	// Split the time so that both parts are exact in a float
+	PhTime high = timeHigh(p.time);
+
+	Vertex vertex;
+	vertex.timeHigh = high;
+	vertex.timeLow = p.time - high * PHSTRIPBUFFER_TIME_UNIT;
+	vertex.pixelX = p.pixelX;
+	vertex.heightX = p.heightX;
+	vertex.track = p.track;
+	vertex.u = p.u;
+	vertex.v = p.v;
+	vertex.people = people;
+	data.vertices.append(vertex);
+	data.objects.last().vertexCount++;
+
+	// The horizontal offsets widen the visible range of the layer
+	data.maxPixelX = qMax(data.maxPixelX, qAbs(p.pixelX));
+	data.maxHeightX = qMax(data.maxHeightX, qAbs(p.heightX));
+}
+
+void PhGraphicStripBuffer::setPeopleColors(const QVector<QColor> &colors, bool selection)
+{
+	if((colors == _peopleColors) && (selection == _selection))
+		return;
+	_peopleColors = colors;
+	_selection = selection;
+	_peopleColorsChanged = true;
+}
+
+int PhGraphicStripBuffer::vertexCount() const
+{
+	int result = 0;
+	for(int i = 0; i < LayerCount; i++)
+		result += _layers[i].vertices.count();
+	return result;
+}
+
+bool PhGraphicStripBuffer::init()
+{
+	if(_program)
+		return _program->isLinked();
+
+	_functions.initializeGLFunctions();
+
+	_program = new QGLShaderProgram();
+	if(!_program->addShaderFromSourceCode(QGLShader::Vertex, stripVertexShader)
+	   || !_program->addShaderFromSourceCode(QGLShader::Fragment, stripFragmentShader)
+	   || !_program->link()) {
+		PHDEBUG << "Unable to build the strip shader:" << _program->log();
+		return false;
+	}
+
+	_functions.glGenBuffers(1, &_buffer);
+	glGenTextures(1, &_peopleTexture);
+	if(_peopleTexture == 0) {
+		PHDEBUG << "glGenTextures() errored: is opengl context ready?";
+		return false;
+	}
+
+	_peopleColorsChanged = true;
+	return true;
+}
+
+void PhGraphicStripBuffer::upload()
+{
+	int count = 0;
+	for(int i = 0; i < LayerCount; i++) {
+		LayerData &layer = _layers[i];
+
+		// Reorder the objects by time so that the visible ones are contiguous
+		std::stable_sort(layer.objects.begin(), layer.objects.end(), [](const Object &object1, const Object &object2) {
+			return object1.timeIn < object2.timeIn;
+		});
+		QVector<Vertex> vertices;
+		vertices.reserve(layer.vertices.count());
+		for(int j = 0; j < layer.objects.count(); j++) {
+			Object &object = layer.objects[j];
+			int first = vertices.count();
+			for(int k = 0; k < object.vertexCount; k++)
+				vertices.append(layer.vertices[object.firstVertex + k]);
+			object.firstVertex = first;
+		}
+		layer.vertices = vertices;
+
+		layer.firstVertex = count;
+		count += vertices.count();
+	}
+
+	PHDEBUG << "vertices:" << count;
+
+	_functions.glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+	_functions.glBufferData(GL_ARRAY_BUFFER, count * sizeof(Vertex), NULL, GL_STATIC_DRAW);
+	for(int i = 0; i < LayerCount; i++) {
+		const LayerData &layer = _layers[i];
+		_functions.glBufferSubData(GL_ARRAY_BUFFER, layer.firstVertex * sizeof(Vertex),
+		                           layer.vertices.count() * sizeof(Vertex), layer.vertices.constData());
+	}
+	_functions.glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	_uploaded = true;
+}
+
+void PhGraphicStripBuffer::uploadPeopleColors()
+{
+	// The first texel is used when there is no color at all
+	QVector<GLubyte> texels;
+	foreach(QColor color, _peopleColors) {
+		texels.append(color.red());
+		texels.append(color.green());
+		texels.append(color.blue());
+		texels.append(color.alpha());
+	}
+	if(texels.isEmpty())
+		texels.fill(0, 4);
+
+	glBindTexture(GL_TEXTURE_2D, _peopleTexture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, texels.count() / 4, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.constData());
+
+	_peopleColorsChanged = false;
+}
+
+int PhGraphicStripBuffer::draw(const Frame &frame)
+{
+	if(!init())
+		return 0;
+
+	// The batched primitives (background, ruler, ...) lie behind the band objects
+	PhGraphicBatch::instance()->flush();
+
+	if(!_uploaded)
+		upload();
+	if(_peopleColorsChanged)
+		uploadPeopleColors();
+
+	// Split the strip time the same way as the vertices time
+	PhTime high = timeHigh(frame.stripTimeIn);
+
+	_program->bind();
+	_program->setUniformValue("atlas", 0);
+	_program->setUniformValue("peopleColors", 1);
+	_program->setUniformValue("peopleCount", (GLfloat)qMax(1, _peopleColors.count()));
+	_program->setUniformValue("selection", _selection ? 1.0f : 0.0f);
+	_program->setUniformValue("invertColor", frame.invertColor ? 1.0f : 0.0f);
+	_program->setUniformValue("stripTimeIn", (GLfloat)high, (GLfloat)(frame.stripTimeIn - high * PHSTRIPBUFFER_TIME_UNIT));
+	_program->setUniformValue("timePerPixel", (GLfloat)frame.timePerPixel);
+	_program->setUniformValue("origin", (GLfloat)frame.x, (GLfloat)frame.y);
+	_program->setUniformValue("stripHeight", (GLfloat)frame.height);
+
+	_functions.glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, _peopleTexture);
+	_functions.glActiveTexture(GL_TEXTURE0);
+
+	_functions.glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+	_program->enableAttributeArray("time");
+	_program->enableAttributeArray("position");
+	_program->enableAttributeArray("texCoord");
+	_program->enableAttributeArray("people");
+	_program->setAttributeBuffer("time", GL_FLOAT, offsetof(Vertex, timeHigh), 2, sizeof(Vertex));
+	_program->setAttributeBuffer("position", GL_FLOAT, offsetof(Vertex, pixelX), 3, sizeof(Vertex));
+	_program->setAttributeBuffer("texCoord", GL_FLOAT, offsetof(Vertex, u), 2, sizeof(Vertex));
+	_program->setAttributeBuffer("people", GL_FLOAT, offsetof(Vertex, people), 1, sizeof(Vertex));
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	int count = drawLayer(ShapeLayer, frame, NULL);
+	count += drawLayer(TextLayer, frame, frame.textFont);
+	count += drawLayer(HudLayer, frame, frame.hudFont);
+
+	glDisable(GL_BLEND);
+	_program->disableAttributeArray("people");
+	_program->disableAttributeArray("texCoord");
+	_program->disableAttributeArray("position");
+	_program->disableAttributeArray("time");
+	_functions.glBindBuffer(GL_ARRAY_BUFFER, 0);
+	_program->release();
+
+	return count;
+}
+
+int PhGraphicStripBuffer::drawLayer(Layer layer, const Frame &frame, PhFont *font)
+{
+	const LayerData &data = _layers[layer];
+	if(data.objects.isEmpty())
+		return 0;
+
+	// The objects drawn away from their time may still be visible
+	PhTime margin = (data.maxPixelX + data.maxHeightX * frame.height + 1) * frame.timePerPixel;
+	PhTime timeIn = frame.stripTimeIn - margin;
+	PhTime timeOut = frame.stripTimeIn + frame.width * frame.timePerPixel + margin;
+
+	QVector<Object>::const_iterator first = std::lower_bound(data.objects.constBegin(), data.objects.constEnd(),
+	                                                          timeIn - data.maxDuration,
+	                                                          [](const Object &object, PhTime time) {
+		return object.timeIn < time;
+	});
+	QVector<Object>::const_iterator last = std::upper_bound(first, data.objects.constEnd(),
+	                                                         timeOut,
+	                                                         [](PhTime time, const Object &object) {
+		return time < object.timeIn;
+	});
+	if(first == last)
+		return 0;
+
+	if(font) {
+		// The texture is updated before binding it since the glyphs may have been rasterized meanwhile
+		glBindTexture(GL_TEXTURE_2D, font->texture());
+		_program->setUniformValue("textured", 1.0f);
+		_program->setUniformValue("distanceField", font->distanceField() ? 1.0f : 0.0f);
+		if(font->distanceField()) {
+			PhGraphicBatch::DistanceField distanceField = font->distanceFieldParameters();
+			_program->setUniformValue("threshold", distanceField.threshold);
+			_program->setUniformValue("outlineWidth", distanceField.outlineWidth);
+			_program->setUniformValue("outlineColor", distanceField.outlineColor);
+		}
+	}
+	else {
+		_program->setUniformValue("textured", 0.0f);
+		_program->setUniformValue("distanceField", 0.0f);
+	}
+
+	int firstVertex = first->firstVertex;
+	int lastVertex = (last == data.objects.constEnd()) ? data.vertices.count() : last->firstVertex;
+	glDrawArrays(GL_TRIANGLES, data.firstVertex + firstVertex, lastVertex - firstVertex);
+
+	return last - first;
+}
@@ -0,0 +1,220 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef PHGRAPHICSTRIPBUFFER_H
+#define PHGRAPHICSTRIPBUFFER_H
+
+#include <QVector>
+#include <QGLFunctions>
+#include <QGLShaderProgram>
+
+#include "PhSync/PhTime.h"
+#include "PhGraphic/PhFont.h"
+
+/**
+ * @brief The strip band content stored on the graphic card
+ *
+ * The strip objects are described once in a time based coordinate system:
+ * each vertex has a time, a horizontal offset in pixel and in strip height
+ * and a vertical position in strip height. The vertex shader converts them
+ * to screen coordinates from the strip time and geometry given as uniforms.
+ *
+ * The color of a vertex is given by a people index. The people colors and
+ * selection are stored in a small texture, and the shader applies the
+ * selection and the color inversion the same way PhGraphicStrip does.
+ *
+ * The objects are grouped by layer: the untextured shapes, the glyphs of the
+ * text font and the glyphs of the HUD font. In each layer, the objects are
+ * sorted by time so that only the visible range is drawn.
+ */
+class PhGraphicStripBuffer
+{
+public:
+	/**
+	 * @brief The layers of the band
+	 */
+	enum Layer {
+		/** The cuts, detects and loops */
+		ShapeLayer,
+		/** The texts glyphs */
+		TextLayer,
+		/** The people names and loop labels glyphs */
+		HudLayer,
+		/** The number of layers */
+		LayerCount
+	};
+
+	/**
+	 * @brief The special people indexes
+	 */
+	enum Color {
+		/** Black, or white when the colors are inverted */
+		InkColor = -1,
+		/** Gray, whatever the color mode */
+		GrayColor = -2
+	};
+
+	/**
+	 * @brief A corner of a quad
+	 */
+	struct Point {
+		/** The time */
+		PhTime time;
+		/** A horizontal offset in pixel */
+		float pixelX;
+		/** A horizontal offset in strip height */
+		float heightX;
+		/** The vertical position in strip height */
+		float track;
+		/** The horizontal texture coordinate */
+		float u;
+		/** The vertical texture coordinate */
+		float v;
+	};
+
+	/**
+	 * @brief The parameters of a draw
+	 */
+	struct Frame {
+		/** The left coordinate of the band */
+		int x;
+		/** The top coordinate of the band */
+		int y;
+		/** The band width */
+		int width;
+		/** The band height */
+		int height;
+		/** The time at the left of the band */
+		PhTime stripTimeIn;
+		/** The time per pixel */
+		int timePerPixel;
+		/** True if the colors are inverted */
+		bool invertColor;
+		/** The text font */
+		PhFont *textFont;
+		/** The HUD font */
+		PhFont *hudFont;
+	};
+
+	PhGraphicStripBuffer();
+
+	~PhGraphicStripBuffer();
+
+	/**
+	 * @brief Build a point
+	 * @param time The time
+	 * @param pixelX A horizontal offset in pixel
+	 * @param heightX A horizontal offset in strip height
+	 * @param track The vertical position in strip height
+	 * @param u The horizontal texture coordinate
+	 * @param v The vertical texture coordinate
+	 * @return A point
+	 */
+	static Point point(PhTime time, float pixelX, float heightX, float track, float u = 0, float v = 0);
+
+	/**
+	 * @brief Remove all the objects
+	 */
+	void clear();
+
+	/**
+	 * @brief Start a new object
+	 *
+	 * The object is used to find the visible range of its layer.
+	 * @param layer A layer
+	 * @param timeIn The time of the object
+	 * @param duration The duration of the object
+	 */
+	void beginObject(Layer layer, PhTime timeIn, PhTime duration);
+
+	/**
+	 * @brief Add a quad to the current object of a layer
+	 * @param layer A layer
+	 * @param people A people index or a special color
+	 * @param p1 The first corner
+	 * @param p2 The second corner
+	 * @param p3 The third corner
+	 * @param p4 The fourth corner
+	 */
+	void addQuad(Layer layer, int people, const Point &p1, const Point &p2, const Point &p3, const Point &p4);
+
+	/**
+	 * @brief Add a triangle to the current object of a layer
+	 * @param layer A layer
+	 * @param people A people index or a special color
+	 * @param p1 The first corner
+	 * @param p2 The second corner
+	 * @param p3 The third corner
+	 */
+	void addTriangle(Layer layer, int people, const Point &p1, const Point &p2, const Point &p3);
+
+	/**
+	 * @brief Set the people colors
+	 *
+	 * The alpha channel tells if the people is selected.
+	 * @param colors The color of each people index
+	 * @param selection True if some peoples are selected
+	 */
+	void setPeopleColors(const QVector<QColor> &colors, bool selection);
+
+	/**
+	 * @brief Draw the visible objects
+	 *
+	 * The objects added since the last draw are sent to the graphic card first.
+	 * @param frame The draw parameters
+	 * @return The number of drawn objects
+	 */
+	int draw(const Frame &frame);
+
+	/**
+	 * @brief The number of vertices stored
+	 * @return An integer value
+	 */
+	int vertexCount() const;
+
+private:
+	struct Vertex {
+		GLfloat timeHigh, timeLow;
+		GLfloat pixelX, heightX, track;
+		GLfloat u, v;
+		GLfloat people;
+	};
+
+	struct Object {
+		PhTime timeIn;
+		PhTime duration;
+		int firstVertex;
+		int vertexCount;
+	};
+
+	struct LayerData {
+		QVector<Object> objects;
+		QVector<Vertex> vertices;
+		PhTime maxDuration;
+		float maxPixelX;
+		float maxHeightX;
+		int firstVertex;
+	};
+
+	bool init();
+	void upload();
+	void uploadPeopleColors();
+	void append(Layer layer, int people, const Point &p);
+	int drawLayer(Layer layer, const Frame &frame, PhFont *font);
+
+	LayerData _layers[LayerCount];
+	bool _uploaded;
+
+	QGLFunctions _functions;
+	QGLShaderProgram *_program;
+	GLuint _buffer;
+	GLuint _peopleTexture;
+	QVector<QColor> _peopleColors;
+	bool _peopleColorsChanged;
+	bool _selection;
+};
+
+#endif // PHGRAPHICSTRIPBUFFER_H
@@ -55,6 +55,21 @@ public:
 	 * @return A integer value from 0 to 5
 	 */
 	virtual int textBoldness() = 0;
+	/**
+	 * @brief Render the strip text as a distance field
+	 * @return True if the distance field mode is used, false otherwise
+	 */
+	virtual bool textDistanceField() = 0;
+	/**
+	 * @brief Render the strip band in cached offscreen tiles
+	 * @return True if the tiles are used, false otherwise
+	 */
+	virtual bool tiledStrip() = 0;
+	/**
+	 * @brief Compute the strip objects position on the graphic card
+	 * @return True if the strip objects are stored on the graphic card, false otherwise
+	 */
+	virtual bool gpuStrip() = 0;
 	/**
 	 * @brief Display the strip in test mode
 	 *
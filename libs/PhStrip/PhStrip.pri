@@ -11,7 +11,8 @@ SOURCES += \
 	$$PWD/PhStripLoop.cpp \
 	$$PWD/PhPeople.cpp \
     $$PWD/PhStripPeopleObject.cpp \
-    $$PWD/PhStripDetect.cpp
+    $$PWD/PhStripDetect.cpp \
+    $$PWD/PhStripStore.cpp
 
 HEADERS += \
 	$$PWD/PhStripDoc.h \
@@ -21,5 +22,7 @@ HEADERS += \
 	$$PWD/PhStripLoop.h \
 	$$PWD/PhPeople.h \
     $$PWD/PhStripPeopleObject.h \
-    $$PWD/PhStripDetect.h
+    $$PWD/PhStripDetect.h \
+    $$PWD/PhStripIndex.h \
+    $$PWD/PhStripStore.h
 
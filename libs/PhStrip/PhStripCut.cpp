@@ -6,7 +6,10 @@
 
 #include "PhStripCut.h"
 
-PhStripCut::PhStripCut(PhTime time, PhStripCut::PhCutType type) : PhStripObject(time)
+PhStripCut::PhStripCut(PhTime time, PhStripCut::PhCutType type) : PhStripObject(time, time, NULL, 0, 0, type, QString())
+{
+}
+
+PhStripCut::PhStripCut(PhStripStore *store, int slot) : PhStripObject(store, slot)
 {
-	_type = type;
 }
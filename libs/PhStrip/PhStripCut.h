@@ -15,6 +15,7 @@
  * It can be simple (one frame change) or progressive (fade).
  */
 class PhStripCut : public PhStripObject {
+	friend class PhStripStore;
 
 public:
 	/**
@@ -31,13 +32,16 @@ public:
 	 */
 	PhStripCut(PhTime time, PhStripCut::PhCutType type);
 
-
-private:
 	/**
-	 * Type of cut.
+	 * @brief The type of cut
+	 * @return A cut type
 	 */
-	PhCutType _type;
+	PhCutType type() {
+		return (PhCutType)_store->type(_slot);
+	}
 
+private:
+	PhStripCut(PhStripStore *store, int slot);
 };
 
 
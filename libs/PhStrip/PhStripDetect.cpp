@@ -7,8 +7,11 @@
 #include "PhStripDetect.h"
 
 PhStripDetect::PhStripDetect(PhDetectType type, PhTime timeIn, PhPeople *people, PhTime timeOut, float y)
-	: PhStripPeopleObject(timeIn, people, timeOut, y),
-	_type(type)
+	: PhStripPeopleObject(timeIn, people, timeOut, y, 0.25f, type, QString())
 {
 
 }
+
+PhStripDetect::PhStripDetect(PhStripStore *store, int slot) : PhStripPeopleObject(store, slot)
+{
+}
@@ -16,6 +16,8 @@
  */
 class PhStripDetect : public PhStripPeopleObject
 {
+	friend class PhStripStore;
+
 public:
 	/**
 	 * @brief The various type of detect
@@ -54,11 +56,11 @@ public:
 	 * @return True if out of the picture, false otherwise
 	 */
 	PhDetectType type() {
-		return _type;
+		return (PhDetectType)_store->type(_slot);
 	}
 
 private:
-	PhDetectType _type;
+	PhStripDetect(PhStripStore *store, int slot);
 };
 
 #endif // PHSTRIPDETECT_H
@@ -35,6 +35,228 @@ bool PhStripDoc::importDetXFile(QString fileName)
 		return false;
 	}
 
+	QXmlStreamReader xml(&xmlFile);
+	if(!xml.readNextStartElement()) {
+		PHDEBUG << "The XML document seems to be bad formed " << fileName;
+		return false;
+	}
+
+	if(xml.name() != "detx") {
+		PHDEBUG << "Bad root element :" << xml.name().toString();
+		return false;
+	}
+
+	reset();
+
+	_generator = "Cappella";
+
+	QMap<QString, PhPeople*> peopleMap;
+
+	while(xml.readNextStartElement()) {
+		if(xml.name() == "header")
+			readDetXHeader(xml, fileName);
+		else if(xml.name() == "roles")
+			readDetXRoles(xml, peopleMap);
+		else if(xml.name() == "body")
+			readDetXBody(xml, peopleMap);
+		else
+			xml.skipCurrentElement();
+	}
+
+	if(xml.hasError()) {
+		PHDEBUG << "Unable to stream" << fileName << "line" << xml.lineNumber() << ":" << xml.errorString();
+		xmlFile.close();
+		return importDetXDomFile(fileName);
+	}
+
+	xmlFile.close();
+
+	buildIndexes();
+	emit this->changed();
+
+	return true;
+}
+
+void PhStripDoc::readDetXHeader(QXmlStreamReader &xml, QString fileName)
+{
+	//With DetX files, fps is always 25 no drop
+	PhTimeCodeType tcType = PhTimeCodeType25;
+
+	// Only the first element of each name is read, at any depth of the header
+	QSet<QString> names;
+	int depth = 0;
+	while(xml.readNext() != QXmlStreamReader::Invalid) {
+		if(xml.isEndElement()) {
+			if(depth == 0)
+				break;
+			depth--;
+			continue;
+		}
+		if(!xml.isStartElement())
+			continue;
+
+		QString name = xml.name().toString();
+		if(names.contains(name)) {
+			depth++;
+			continue;
+		}
+		names.insert(name);
+
+		QXmlStreamAttributes attributes = xml.attributes();
+		// Read the Cappella version
+		if(name == "cappella")
+			_generator += " v" + attributes.value("version").toString();
+		// Reading the title
+		else if(name == "title")
+			_title = xml.readElementText(QXmlStreamReader::IncludeChildElements);
+		// Reading the translated title
+		else if(name == "title2")
+			_translatedTitle = xml.readElementText(QXmlStreamReader::IncludeChildElements);
+		// Reading the episode info
+		else if(name == "episode") {
+			_episode = attributes.value("number").toString();
+			_season = attributes.value("season").toString();
+		}
+		// Reading the video path and time in
+		else if(name == "videofile") {
+			// The attributes are not valid anymore once the text is read
+			_videoTimeIn = PhTimeCode::timeFromString(attributes.value("timestamp").toString(), tcType);
+			_videoTimeCodeType = tcType;
+			_videoPath = xml.readElementText(QXmlStreamReader::IncludeChildElements);
+		}
+		// Reading the last position
+		else if(name == "last_position")
+			_lastTime = PhTimeCode::timeFromString(attributes.value("timecode").toString(), tcType);
+		// Reading the author name
+		else if(name == "author")
+			_authorName = attributes.value("firstname").toString() + " " + attributes.value("name").toString();
+		// Reading other meta informations
+		else if(name == "production") {
+			_metaInformation["Producteur"] = attributes.value("producer").toString();
+			_metaInformation["Année de production"] = attributes.value("year").toString();
+			_metaInformation["Distributeur"] = attributes.value("distributor").toString();
+			_metaInformation["Réalisateur"] = attributes.value("director").toString();
+			_metaInformation["Diffuseur"] = attributes.value("diffuser").toString();
+			_metaInformation["Pays d'origine"] = attributes.value("country").toString();
+		}
+
+		// readElementText() stops on the end element
+		if(!xml.isEndElement())
+			depth++;
+	}
+
+	if(!names.contains("title"))
+		_title = QFileInfo(fileName).baseName();
+}
+
+void PhStripDoc::readDetXRoles(QXmlStreamReader &xml, QMap<QString, PhPeople *> &peopleMap)
+{
+	while(xml.readNextStartElement()) {
+		if(xml.name() == "role") {
+			QXmlStreamAttributes attributes = xml.attributes();
+			PhPeople *people = new PhPeople(attributes.value("name").toString(), attributes.value("color").toString());
+
+			//Currently using id as key instead of name
+			peopleMap[attributes.value("id").toString()] = people;
+			_peoples.append(people);
+		}
+		// The role image is skipped without being stored
+		xml.skipCurrentElement();
+	}
+}
+
+void PhStripDoc::readDetXBody(QXmlStreamReader &xml, const QMap<QString, PhPeople *> &peopleMap)
+{
+	PhTimeCodeType tcType = PhTimeCodeType25;
+	int loopNumber = 1;
+
+	while(xml.readNextStartElement()) {
+		QXmlStreamAttributes attributes = xml.attributes();
+		// Reading loops
+		if(xml.name() == "loop") {
+			PhTime timeIn = PhTimeCode::timeFromString(attributes.value("timecode").toString(), tcType);
+			_loops.append(_store.createLoop(timeIn, QString::number(loopNumber++)));
+			xml.skipCurrentElement();
+		}
+		// Reading cuts
+		else if(xml.name() == "shot") {
+			PhTime timeIn = PhTimeCode::timeFromString(attributes.value("timecode").toString(), tcType);
+			_cuts.append(_store.createCut(timeIn, PhStripCut::Simple));
+			xml.skipCurrentElement();
+		}
+		else if(xml.name() == "line") {
+			PhPeople *people = peopleMap.value(attributes.value("role").toString(), NULL);
+			float y = attributes.value("track").toInt() / 4.0;
+			PhStripDetect::PhDetectType type = PhStripDetect::On;
+			if(attributes.value("voice") == "off")
+				type = PhStripDetect::Off;
+			readDetXLine(xml, people, y, type);
+		}
+		else
+			xml.skipCurrentElement();
+	}
+}
+
+void PhStripDoc::readDetXLine(QXmlStreamReader &xml, PhPeople *people, float y, PhStripDetect::PhDetectType type)
+{
+	PhTimeCodeType tcType = PhTimeCodeType25;
+	PhTime timeIn = -1;
+	PhTime lastTime = -1;
+	PhTime lastLinkedTime = -1;
+	QString currentText = "";
+
+	while(xml.readNextStartElement()) {
+		if(xml.name() == "lipsync") {
+			QXmlStreamAttributes attributes = xml.attributes();
+			lastTime = PhTimeCode::timeFromString(attributes.value("timecode").toString(), tcType);
+			if(timeIn < 0)
+				timeIn = lastTime;
+			if(attributes.value("link") != "off") {
+				if(currentText.length()) {
+					_texts1.append(_store.createText(lastLinkedTime, people, lastTime, y, currentText, 0.25f));
+					currentText = "";
+				}
+				lastLinkedTime = lastTime;
+			}
+			xml.skipCurrentElement();
+		}
+		else if(xml.name() == "text")
+			currentText += xml.readElementText(QXmlStreamReader::IncludeChildElements);
+		else
+			xml.skipCurrentElement();
+	}
+
+	// The line is ignored when the file is broken inside
+	if(xml.hasError())
+		return;
+
+	// Handling line with no lipsync out
+	if(currentText.length()) {
+		PhTime time = lastLinkedTime + currentText.length() * 1000;
+		PHDEBUG << currentText;
+		_texts1.append(_store.createText(lastLinkedTime, people, time, y, currentText, 0.25f));
+		lastTime = lastLinkedTime = time;
+	}
+	_detects.append(_store.createDetect(type, timeIn, people, lastTime, y));
+}
+
+bool PhStripDoc::importDetXDomFile(QString fileName)
+{
+	PHDEBUG << fileName;
+	if (!QFile(fileName).exists()) {
+		PHDEBUG << "The file doesn't exists" << fileName;
+		return false;
+	}
+
+	_filePath = fileName;
+
+	// Opening the XML file
+	QFile xmlFile(fileName);
+	if(!xmlFile.open(QIODevice::ReadOnly)) {
+		PHDEBUG << "Unable to open" << fileName;
+		return false;
+	}
+
 	// Loading the DOM (document object model)
 	QDomDocument *domDoc = new QDomDocument();
 	if (!domDoc->setContent(&xmlFile)) {
@@ -145,10 +367,10 @@ bool PhStripDoc::importDetXFile(QString fileName)
 				PhTime timeIn = PhTimeCode::timeFromString(elem.attribute("timecode"), tcType);
 				// Reading loops
 				if(elem.tagName() == "loop")
-					_loops.append(new PhStripLoop(timeIn, QString::number(loopNumber++)));
+					_loops.append(_store.createLoop(timeIn, QString::number(loopNumber++)));
 				// Reading cuts
 				else if(elem.tagName() == "shot")
-					_cuts.append(new PhStripCut(timeIn, PhStripCut::Simple));
+					_cuts.append(_store.createCut(timeIn, PhStripCut::Simple));
 				else if(elem.tagName() == "line") {
 					timeIn = -1;
 					PhTime lastTime = -1;
@@ -165,7 +387,7 @@ bool PhStripDoc::importDetXFile(QString fileName)
 									timeIn = lastTime;
 								if(lineElem.attribute("link") != "off") {
 									if(currentText.length()) {
-										_texts1.append(new PhStripText(lastLinkedTime, people, lastTime, y, currentText, 0.25f));
+										_texts1.append(_store.createText(lastLinkedTime, people, lastTime, y, currentText, 0.25f));
 										currentText = "";
 									}
 									lastLinkedTime = lastTime;
@@ -179,13 +401,13 @@ bool PhStripDoc::importDetXFile(QString fileName)
 					if(currentText.length()) {
 						PhTime time = lastLinkedTime + currentText.length() * 1000;
 						PHDEBUG << currentText;
-						_texts1.append(new PhStripText(lastLinkedTime, people, time, y, currentText, 0.25f));
+						_texts1.append(_store.createText(lastLinkedTime, people, time, y, currentText, 0.25f));
 						lastTime = lastLinkedTime = time;
 					}
 					PhStripDetect::PhDetectType type = PhStripDetect::On;
 					if(elem.attribute("voice") == "off")
 						type = PhStripDetect::Off;
-					_detects.append(new PhStripDetect(type, timeIn, people, lastTime, y));
+					_detects.append(_store.createDetect(type, timeIn, people, lastTime, y));
 				}
 			}
 		}
@@ -194,6 +416,7 @@ bool PhStripDoc::importDetXFile(QString fileName)
 	xmlFile.close();
 	delete domDoc;
 
+	buildIndexes();
 	emit this->changed();
 
 	return true;
@@ -234,7 +457,7 @@ PhStripText* PhStripDoc::readMosText(QFile &f, PhTimeCodeType tcType, int textLe
 	PhTime timeIn = _videoTimeIn + readMosTime(f, tcType, internLevel);
 	PhTime timeOut = _videoTimeIn + readMosTime(f, tcType, internLevel);
 
-	PhStripText* text = new PhStripText(timeIn, NULL, timeOut, 0, content, 0.2f);
+	PhStripText* text = _store.createText(timeIn, NULL, timeOut, 0, content, 0.2f);
 
 	PhFileTool::readInt(f, internLevel, "text");
 	PhFileTool::readInt(f, internLevel, "text");
@@ -321,7 +544,7 @@ PhStripDetect *PhStripDoc::readMosDetect(QFile &f, PhTimeCodeType tcType, int de
 	                   << detectType3
 	                   << "type:"
 	                   << type;
-	return new PhStripDetect(type, timeIn, NULL, timeOut, 0);
+	return _store.createDetect(type, timeIn, NULL, timeOut, 0);
 }
 
 bool PhStripDoc::readMosProperties(QFile &f, int level)
@@ -501,6 +724,10 @@ bool PhStripDoc::modified() const
 void PhStripDoc::setModified(bool modified)
 {
 	_modified = modified;
+	// The document content has been edited (people colors, texts, ...).
+	// Saving it changes nothing to draw.
+	if(modified)
+		emit this->changed();
 }
 
 
@@ -669,7 +896,7 @@ bool PhStripDoc::importMosFile(const QString &fileName)
 				return false;
 			PhTime cutTime = _videoTimeIn + readMosTime(f, tcType, internLevel);
 			PHDBG(cutLevel) << "cut:" << PhTimeCode::stringFromTime(cutTime, tcType);
-			_cuts.append(new PhStripCut(cutTime, PhStripCut::Simple));
+			_cuts.append(_store.createCut(cutTime, PhStripCut::Simple));
 		}
 	}
 
@@ -713,7 +940,7 @@ bool PhStripDoc::importMosFile(const QString &fileName)
 				label = "off";
 			else if(label.isEmpty())
 				label = QString::number(number);
-			_loops.append(new PhStripLoop(loopTime, label));
+			_loops.append(_store.createLoop(loopTime, label));
 		}
 	}
 
@@ -747,6 +974,7 @@ bool PhStripDoc::importMosFile(const QString &fileName)
 	qSort(_cuts.begin(), _cuts.end(), PhStripObject::dtcomp);
 	qSort(_loops.begin(), _loops.end(), PhStripObject::dtcomp);
 
+	buildIndexes();
 	emit this->changed();
 
 	return true;
@@ -821,10 +1049,10 @@ bool PhStripDoc::importDrbFile(const QString &fileName)
 		QString type = loopElement.elementsByTagName("Type").at(0).toElement().text();
 		PhTime timeIn = ComputeDrbTime1(offset, loopElement.elementsByTagName("Debut").at(0).toElement().text().toLongLong(), tcType);
 		if(type == "BOUCLE") {
-			_loops.append(new PhStripLoop(timeIn, QString::number(loopNumber++)));
+			_loops.append(_store.createLoop(timeIn, QString::number(loopNumber++)));
 		}
 		else if (type == "PLAN") {
-			_cuts.append(new PhStripCut(timeIn, PhStripCut::PhCutType::Simple));
+			_cuts.append(_store.createCut(timeIn, PhStripCut::PhCutType::Simple));
 		}
 	}
 
@@ -906,7 +1134,7 @@ bool PhStripDoc::importDrbFile(const QString &fileName)
 					QString content = textElement.elementsByTagName("VALUE").at(0).toElement().text();
 
 					PHDEBUG << PhTimeCode::stringFromTime(timeIn, tcType) << PhTimeCode::stringFromTime(timeOut, tcType) << content;
-					_texts1.append(new PhStripText(timeIn, people, timeOut, y, content, height));
+					_texts1.append(_store.createText(timeIn, people, timeOut, y, content, height));
 				}
 			}
 			else {
@@ -920,6 +1148,9 @@ bool PhStripDoc::importDrbFile(const QString &fileName)
 		}
 	}
 
+	buildIndexes();
+	emit this->changed();
+
 	return result;
 }
 
@@ -988,10 +1219,10 @@ bool PhStripDoc::importSyn6File(const QString &fileName)
 			PhTime time = ComputeDrbTime2(offset, query.value(2).toLongLong(), tcType);
 			switch(query.value(1).toInt()) {
 			case 2:
-				_cuts.append(new PhStripCut(time, PhStripCut::Simple));
+				_cuts.append(_store.createCut(time, PhStripCut::Simple));
 				break;
 			case 7:
-				_loops.append(new PhStripLoop(time, QString::number(query.value(4).toInt())));
+				_loops.append(_store.createLoop(time, QString::number(query.value(4).toInt())));
 				break;
 			}
 		}
@@ -1015,13 +1246,16 @@ bool PhStripDoc::importSyn6File(const QString &fileName)
 			float y = y1 / 150.0f;
 			float height = (y2 - y1) / 150.0f;
 			QString content = query.value(7).toString();
-			_texts1.append(new PhStripText(timeIn, people, timeOut, y, content, height));
+			_texts1.append(_store.createText(timeIn, people, timeOut, y, content, height));
 			PHDEBUG << timeIn << timeOut << content;
 		}
 	}
 
 	db.close();
 
+	buildIndexes();
+	emit this->changed();
+
 	return true;
 }
 
@@ -1109,6 +1343,8 @@ bool PhStripDoc::openStripFile(const QString &fileName)
 			}
 		}
 
+		emit this->changed();
+
 		delete domDoc;
 
 	}
@@ -1233,7 +1469,7 @@ void PhStripDoc::generate(QString content, int loopCount, int peopleCount, PhTim
 		PhTime timeIn = time;
 		PhTime timeOut = timeIn + content.length() * 1000;
 
-		_texts1.append(new PhStripText(timeIn, people, timeOut, i % trackCount / 4, content, 0.25f));
+		_texts1.append(_store.createText(timeIn, people, timeOut, i % trackCount / 4, content, 0.25f));
 
 		// So the texts are all one after the other
 		time += spaceBetweenText;
@@ -1241,8 +1477,9 @@ void PhStripDoc::generate(QString content, int loopCount, int peopleCount, PhTim
 
 	// Add a loop per minute
 	for(int i = 0; i < loopCount; i++)
-		_loops.append(new PhStripLoop(_videoTimeIn + i * 24000 * 60, QString::number(i)));
+		_loops.append(_store.createLoop(_videoTimeIn + i * 24000 * 60, QString::number(i)));
 
+	buildIndexes();
 	emit changed();
 }
 
@@ -1251,17 +1488,15 @@ void PhStripDoc::reset()
 	/* Note: clearing a QList does not free its elements. */
 	qDeleteAll(_peoples);
 	_peoples.clear();
-	qDeleteAll(_cuts);
 	_cuts.clear();
-	qDeleteAll(_detects);
 	_detects.clear();
 	_lastTime = 0;
-	qDeleteAll(_loops);
 	_loops.clear();
-	qDeleteAll(_texts1);
 	_texts1.clear();
-	qDeleteAll(_texts2);
 	_texts2.clear();
+	buildIndexes();
+	// The store owns the strip objects
+	_store.clear();
 
 	_title = "";
 	_translatedTitle = "";
@@ -1282,20 +1517,36 @@ void PhStripDoc::reset()
 
 void PhStripDoc::addObject(PhStripObject *object)
 {
-	if(dynamic_cast<PhStripCut*>(object)) {
-		this->_cuts.append(dynamic_cast<PhStripCut*>(object));
+	if(!_store.adopt(object)) {
+		PHDEBUG << "The object belongs to another document";
+		return;
+	}
+
+	PhStripCut *cut = dynamic_cast<PhStripCut*>(object);
+	PhStripLoop *loop = dynamic_cast<PhStripLoop*>(object);
+	PhStripDetect *detect = dynamic_cast<PhStripDetect*>(object);
+	PhStripText *text = dynamic_cast<PhStripText*>(object);
+
+	if(cut) {
+		this->_cuts.append(cut);
+		_cutIndex.insert(cut);
 		PHDEBUG << "Added a cut";
 	}
-	else if(dynamic_cast<PhStripLoop*>(object)) {
-		this->_loops.append(dynamic_cast<PhStripLoop*>(object));
+	else if(loop) {
+		this->_loops.append(loop);
+		_loopIndex.insert(loop);
 		PHDEBUG << "Added a loop";
 	}
-	else if(dynamic_cast<PhStripDetect*>(object)) {
-		this->_detects.append(dynamic_cast<PhStripDetect*>(object));
+	else if(detect) {
+		this->_detects.append(detect);
+		_detectIndex.insert(detect);
+		_peopleDetectIndexes[detect->people()].insert(detect);
 		PHDEBUG << "Added a detect!";
 	}
-	else if(dynamic_cast<PhStripText*>(object)) {
-		this->_texts1.append(dynamic_cast<PhStripText*>(object));
+	else if(text) {
+		this->_texts1.append(text);
+		_textIndex.insert(text);
+		_peopleTextIndexes[text->people()].insert(text);
 		PHDEBUG << "Added a text!";
 	}
 	else {
@@ -1305,9 +1556,40 @@ void PhStripDoc::addObject(PhStripObject *object)
 
 }
 
+void PhStripDoc::buildIndexes()
+{
+	_textIndex.build(_texts1);
+	_cutIndex.build(_cuts);
+	_loopIndex.build(_loops);
+	_detectIndex.build(_detects);
+
+	QHash<PhPeople *, QList<PhStripText *> > peopleTexts;
+	foreach(PhStripText *text, _texts1)
+		peopleTexts[text->people()].append(text);
+	_peopleTextIndexes.clear();
+	foreach(PhPeople *people, peopleTexts.keys())
+		_peopleTextIndexes[people].build(peopleTexts.value(people));
+
+	QHash<PhPeople *, QList<PhStripDetect *> > peopleDetects;
+	foreach(PhStripDetect *detect, _detects)
+		peopleDetects[detect->people()].append(detect);
+	_peopleDetectIndexes.clear();
+	foreach(PhPeople *people, peopleDetects.keys())
+		_peopleDetectIndexes[people].build(peopleDetects.value(people));
+
+	// The first people of a name is returned as before the index
+	_peopleByName.clear();
+	foreach(PhPeople *people, _peoples) {
+		if(people && !_peopleByName.contains(people->name()))
+			_peopleByName[people->name()] = people;
+	}
+}
+
 void PhStripDoc::addPeople(PhPeople *people)
 {
 	this->_peoples.append(people);
+	if(people && !_peopleByName.contains(people->name()))
+		_peopleByName[people->name()] = people;
 	PHDEBUG << "Added a people";
 	emit changed();
 
@@ -1315,83 +1597,46 @@ void PhStripDoc::addPeople(PhPeople *people)
 
 PhPeople *PhStripDoc::peopleByName(QString name)
 {
-	foreach(PhPeople* people, _peoples) {
-		if(people && people->name() == name)
-			return people;
-	}
-	return NULL;
+	return _peopleByName.value(name, NULL);
 }
 
 PhStripText *PhStripDoc::nextText(PhTime time)
 {
-	PhStripText * result = NULL;
-	foreach(PhStripText* text, this->texts()) {
-		if(text->timeIn() > time) {
-			if(!result || (text->timeIn() < result->timeIn()) )
-				result = text;
-		}
-	}
-	return result;
+	return _textIndex.next(time);
 }
 
 PhStripText *PhStripDoc::nextText(PhPeople *people, PhTime time)
 {
-	PhStripText * result = NULL;
-	foreach(PhStripText* text, this->texts()) {
-		if((text->people() == people) && (text->timeIn() > time)) {
-			if(!result || (text->timeIn() < result->timeIn()) )
-				result = text;
-		}
-	}
-	return result;
+	QHash<PhPeople *, PhStripIndex<PhStripText> >::const_iterator it = _peopleTextIndexes.constFind(people);
+	if(it == _peopleTextIndexes.constEnd())
+		return NULL;
+	return it->next(time);
 }
 
 PhStripText *PhStripDoc::nextText(QList<PhPeople *> peopleList, PhTime time)
 {
 	PhStripText * result = NULL;
-	foreach(PhStripText* text, this->texts()) {
-		if(peopleList.contains(text->people()) && (text->timeIn() > time)) {
-			if(!result || (text->timeIn() < result->timeIn()) )
-				result = text;
-		}
+	foreach(PhPeople *people, peopleList) {
+		PhStripText *text = nextText(people, time);
+		if(text && (!result || (text->timeIn() < result->timeIn())))
+			result = text;
 	}
 	return result;
 }
 
 PhTime PhStripDoc::previousTextTime(PhTime time)
 {
-	PhTime previousTextTime = PHTIMEMIN;
-
-	foreach(PhStripText* text, this->texts()) {
-		if((text->timeIn() < time) && (text->timeIn() > previousTextTime) )
-			previousTextTime = text->timeIn();
-	}
-
-	return previousTextTime;
+	return _textIndex.previousTime(time);
 }
 
 PhTime PhStripDoc::previousLoopTime(PhTime time)
 {
-	PhTime previousLoopTime = PHTIMEMIN;
-
-	foreach(PhStripLoop* loop, _loops) {
-		if((loop->timeIn() < time) && (loop->timeIn() > previousLoopTime) )
-			previousLoopTime = loop->timeIn();
-	}
-
-	return previousLoopTime;
+	return _loopIndex.previousTime(time);
 }
 
 PhTime PhStripDoc::previousCutTime(PhTime time)
 {
-	PhTime previousCutTime = PHTIMEMIN;
-
-	foreach(PhStripCut* cut, _cuts) {
-		if((cut->timeIn() < time) && (cut->timeIn() > previousCutTime) )
-			previousCutTime = cut->timeIn();
-	}
-
-	return previousCutTime;
+	return _cutIndex.previousTime(time);
 }
 
 PhTime PhStripDoc::previousElementTime(PhTime time)
@@ -1409,44 +1654,17 @@ PhTime PhStripDoc::previousElementTime(PhTime time)
 
 PhTime PhStripDoc::nextTextTime(PhTime time)
 {
-	PhTime nextTextTime = PHTIMEMAX;
-
-	foreach(PhStripText* text, this->texts()) {
-		if((text->timeIn() > time) && (text->timeIn() < nextTextTime) )
-			nextTextTime = text->timeIn();
-		else if(text->timeIn() > nextTextTime)
-			return nextTextTime;
-	}
-
-	return nextTextTime;
+	return _textIndex.nextTime(time);
 }
 
 PhTime PhStripDoc::nextLoopTime(PhTime time)
 {
-	PhTime nextLoopTime = PHTIMEMAX;
-
-	foreach(PhStripLoop* loop, _loops) {
-		if((loop->timeIn() > time) && (loop->timeIn() < nextLoopTime) )
-			nextLoopTime = loop->timeIn();
-		else if(loop->timeIn() > nextLoopTime)
-			return nextLoopTime;
-	}
-
-	return nextLoopTime;
+	return _loopIndex.nextTime(time);
 }
 
 PhTime PhStripDoc::nextCutTime(PhTime time)
 {
-	PhTime nextCutTime = PHTIMEMAX;
-
-	foreach(PhStripCut* cut, _cuts) {
-		if((cut->timeIn() > time) && (cut->timeIn() < nextCutTime) )
-			nextCutTime = cut->timeIn();
-		else if(cut->timeIn() > nextCutTime)
-			return nextCutTime;
-	}
-
-	return nextCutTime;
+	return _cutIndex.nextTime(time);
 }
 
 PhTime PhStripDoc::nextElementTime(PhTime time)
@@ -1474,22 +1692,12 @@ PhTime PhStripDoc::timeOut()
 
 PhStripLoop *PhStripDoc::nextLoop(PhTime time)
 {
-	foreach(PhStripLoop* loop, _loops) {
-		if(loop->timeIn() > time)
-			return loop;
-	}
-	return NULL;
+	return _loopIndex.next(time);
 }
 
 PhStripLoop *PhStripDoc::previousLoop(PhTime time)
 {
-	int i = _loops.count() - 1;
-	while(i >= 0) {
-		if(_loops.at(i)->timeIn() < time)
-			return _loops.at(i);
-		i--;
-	}
-	return NULL;
+	return _loopIndex.previous(time);
 }
 
 QString PhStripDoc::filePath()
@@ -1577,12 +1785,7 @@ QList<PhStripText *> PhStripDoc::texts(bool alternate)
 
 QList<PhStripText *> PhStripDoc::texts(PhPeople *people)
 {
-	QList<PhStripText*> result;
-	foreach(PhStripText *text, this->texts()) {
-		if(text->people() == people)
-			result.append(text);
-	}
-	return result;
+	return _peopleTextIndexes.value(people).objects();
 }
 
 QList<PhStripLoop *> PhStripDoc::loops()
@@ -1592,23 +1795,15 @@ QList<PhStripLoop *> PhStripDoc::loops()
 
 QList<PhStripDetect *> PhStripDoc::detects(PhTime timeIn, PhTime timeOut)
 {
-	QList<PhStripDetect*> result;
-	foreach(PhStripDetect *detect, this->_detects) {
-		if((detect->timeIn() >= timeIn) && (detect->timeOut() < timeOut))
-			result.append(detect);
-	}
+	if((timeIn == PHTIMEMIN) && (timeOut == PHTIMEMAX))
+		return _detects;
 
-	return result;
+	return _detectIndex.within(timeIn, timeOut);
 }
 
 QList<PhStripDetect *> PhStripDoc::peopleDetects(PhPeople *people, PhTime timeIn, PhTime timeOut)
 {
-	QList<PhStripDetect *> result;
-	foreach(PhStripDetect *detect, this->detects(timeIn, timeOut)) {
-		if(detect->people() == people)
-			result.append(detect);
-	}
-	return result;
+	return _peopleDetectIndexes.value(people).within(timeIn, timeOut);
 }
 
 void PhStripDoc::setTitle(QString title)
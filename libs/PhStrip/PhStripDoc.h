@@ -7,6 +7,9 @@
 #ifndef PHSTRIPDOC_H
 #define PHSTRIPDOC_H
 
+#include <QHash>
+#include <QXmlStreamReader>
+
 #include "PhTools/PhData.h"
 #include "PhSync/PhTimeCode.h"
 
@@ -16,6 +19,8 @@
 #include "PhStripObject.h"
 #include "PhStripText.h"
 #include "PhStripDetect.h"
+#include "PhStripIndex.h"
+#include "PhStripStore.h"
 
 /**
  * @brief The joker document class
@@ -148,7 +153,7 @@ public:
 	/**
 	 * @brief The list of texts affected to a people
 	 * @param people A people
-	 * @return A list of texts
+	 * @return A list of texts sorted by time in
 	 */
 	QList<PhStripText *> texts(PhPeople *people);
 
@@ -176,10 +181,45 @@ public:
 	 * @param people The people
 	 * @param timeIn The range starting time
 	 * @param timeOut The range ending time
-	 * @return A list of detects
+	 * @return A list of detects sorted by time in
 	 */
 	QList<PhStripDetect *> peopleDetects(PhPeople *people, PhTime timeIn = PHTIMEMIN, PhTime timeOut = PHTIMEMAX);
 
+	/**
+	 * @brief The texts sorted by time in
+	 *
+	 * The positions of the texts visible in a time range are given by
+	 * PhStripIndex::overlappingPositions().
+	 * @return A text index
+	 */
+	const PhStripIndex<PhStripText> &textIndex() const {
+		return _textIndex;
+	}
+
+	/**
+	 * @brief The loops sorted by time in
+	 * @return A loop index
+	 */
+	const PhStripIndex<PhStripLoop> &loopIndex() const {
+		return _loopIndex;
+	}
+
+	/**
+	 * @brief The cuts sorted by time in
+	 * @return A cut index
+	 */
+	const PhStripIndex<PhStripCut> &cutIndex() const {
+		return _cutIndex;
+	}
+
+	/**
+	 * @brief The detects sorted by time in
+	 * @return A detect index
+	 */
+	const PhStripIndex<PhStripDetect> &detectIndex() const {
+		return _detectIndex;
+	}
+
 	/**
 	 * @brief Set the title property
 	 * @param title A string
@@ -213,10 +253,22 @@ public:
 	void setTimeScale(int timeScale);
 	/**
 	 * @brief Import a DetX file
+	 *
+	 * The file is read in a single pass with a QXmlStreamReader. The files
+	 * the stream reader refuses (a few Cappella versions write an attribute
+	 * twice) are imported with importDetXDomFile().
 	 * @param fileName The path to the DetX file
 	 * @return True if the doc opened well, false otherwise
 	 */
 	bool importDetXFile(QString fileName);
+	/**
+	 * @brief Import a DetX file from a DOM document
+	 *
+	 * It loads the whole file in memory and is slower than importDetXFile().
+	 * @param fileName The path to the DetX file
+	 * @return True if the doc opened well, false otherwise
+	 */
+	bool importDetXDomFile(QString fileName);
 	/**
 	 * @brief Import a Mos file
 	 * @param fileName The path to the Mos file
@@ -381,10 +433,17 @@ public:
 
 	/**
 	 * @brief Add a PhGraphicObjet to the doc
+	 *
+	 * The object is inserted in the time indexes. If the document is drawn
+	 * by a render thread, hold the view render mutex while calling it.
+	 * The document takes the ownership of the object.
+	 * @param object the new object
 	 */
 	void addObject(PhStripObject *object);
 	/**
 	 * @brief Add a PhPeople to the doc
+	 *
+	 * Like addObject(), it updates the indexes read while drawing.
 	 * @param people the new poeple
 	 */
 	void addPeople(PhPeople * people);
@@ -396,7 +455,9 @@ public:
 	bool modified() const;
 	/**
 	 * @brief setModified
-	 * @param modified
+	 *
+	 * Marking the document as modified emits changed().
+	 * @param modified True after an edit of the content, false after a save
 	 */
 	void setModified(bool modified);
 
@@ -448,6 +509,11 @@ private:
 	 */
 	QList<PhPeople *> _peoples;
 
+	/**
+	 * The properties of the strip objects and the objects themselves
+	 */
+	PhStripStore _store;
+
 	QList<PhStripText *> _texts1, _texts2;
 
 	/**
@@ -465,6 +531,26 @@ private:
 	 */
 	QList<PhStripDetect *> _detects;
 
+	/**
+	 * The texts, cuts, loops and detects sorted by time for the navigation
+	 * and the time range queries. They are rebuilt at the end of the imports.
+	 */
+	PhStripIndex<PhStripText> _textIndex;
+	PhStripIndex<PhStripCut> _cutIndex;
+	PhStripIndex<PhStripLoop> _loopIndex;
+	PhStripIndex<PhStripDetect> _detectIndex;
+
+
+	/**
+	 * The texts and detects of each people sorted by time and the people
+	 * by name for the queries depending on the selected peoples.
+	 */
+	QHash<PhPeople *, PhStripIndex<PhStripText> > _peopleTextIndexes;
+	QHash<PhPeople *, PhStripIndex<PhStripDetect> > _peopleDetectIndexes;
+	QHash<QString, PhPeople *> _peopleByName;
+
+	void buildIndexes();
+
 	PhTime ComputeDrbTime1(PhTime offset, PhTime value, PhTimeCodeType tcType);
 	PhTime ComputeDrbTime2(PhTime offset, PhTime value, PhTimeCodeType tcType);
 
@@ -490,6 +576,11 @@ private:
 	unsigned short _mosNextTag;
 	QMap<unsigned short, MosTag> _mosTagMap;
 
+	void readDetXHeader(QXmlStreamReader &xml, QString fileName);
+	void readDetXRoles(QXmlStreamReader &xml, QMap<QString, PhPeople *> &peopleMap);
+	void readDetXBody(QXmlStreamReader &xml, const QMap<QString, PhPeople *> &peopleMap);
+	void readDetXLine(QXmlStreamReader &xml, PhPeople *people, float y, PhStripDetect::PhDetectType type);
+
 	bool checkMosTag2(QFile &f, int level, QString expected);
 	bool checkMosTag(QFile &f, int level, MosTag expectedTag);
 	PhTime readMosTime(QFile &f, PhTimeCodeType tcType, int level);
@@ -0,0 +1,343 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef PHSTRIPINDEX_H
+#define PHSTRIPINDEX_H
+
+#include <algorithm>
+
+#include <QVector>
+#include <QList>
+
+#include "PhStripPeopleObject.h"
+
+/** The duration above which an object is long for a PhStripIndex (10 seconds) */
+#define PHSTRIPINDEX_LONG_DURATION 240000
+
+/**
+ * @brief The end of a strip object without duration
+ * @param object A strip object
+ * @return Its time in
+ */
+inline PhTime PhStripIndexTimeOut(PhStripObject *object)
+{
+	return object->timeIn();
+}
+
+/**
+ * @brief The end of a strip object with a duration
+ * @param object A strip object
+ * @return Its time out
+ */
+inline PhTime PhStripIndexTimeOut(PhStripPeopleObject *object)
+{
+	return object->timeOut();
+}
+
+/**
+ * @brief A range of positions in a PhStripIndex
+ */
+struct PhStripIndexRange
+{
+	/** The first position */
+	int first;
+	/** The position following the last one */
+	int last;
+};
+
+/**
+ * @brief A list of strip objects sorted by time in
+ *
+ * The objects with the same time in keep the order in which they were added.
+ * The objects overlapping a time range are found with a binary search
+ * instead of a scan of the whole document: an object ending after the range
+ * start begins at most the longest duration before it. The few objects
+ * lasting more than PHSTRIPINDEX_LONG_DURATION are listed apart and tested
+ * one by one, so that a single long object doesn't widen every search.
+ *
+ * The times are copied in arrays beside the object pointers: the searches
+ * and the range filters read contiguous memory instead of each object.
+ *
+ * Adding the objects in time order is cheap. Elsewhere the following entries
+ * are moved: a large number of objects is better added with build().
+ *
+ * The index does not own the objects. It must be rebuilt when their times
+ * are modified.
+ */
+template <class T>
+class PhStripIndex
+{
+public:
+	/**
+	 * @brief PhStripIndex constructor
+	 */
+	PhStripIndex() : _maxShortDuration(0) {
+	}
+
+	/**
+	 * @brief Replace the content of the index
+	 * @param objects A list of objects in any order
+	 */
+	void build(const QList<T *> &objects) {
+		QVector<Entry> entries;
+		entries.reserve(objects.count());
+		foreach(T *object, objects) {
+			Entry entry = {object->timeIn(), PhStripIndexTimeOut(object), object};
+			entries.append(entry);
+		}
+		std::stable_sort(entries.begin(), entries.end(), entryLessThan);
+
+		clear();
+		_objects.reserve(entries.count());
+		_timeIns.reserve(entries.count());
+		_timeOuts.reserve(entries.count());
+		foreach(const Entry &entry, entries) {
+			if(isLong(entry.timeIn, entry.timeOut))
+				_longPositions.append(_objects.count());
+			else
+				_maxShortDuration = qMax(_maxShortDuration, entry.timeOut - entry.timeIn);
+			_objects.append(entry.object);
+			_timeIns.append(entry.timeIn);
+			_timeOuts.append(entry.timeOut);
+		}
+	}
+
+	/**
+	 * @brief Add an object after the ones with the same time in
+	 * @param object A strip object
+	 */
+	void insert(T *object) {
+		PhTime timeIn = object->timeIn();
+		PhTime timeOut = PhStripIndexTimeOut(object);
+		int i = upperBound(timeIn);
+		_objects.insert(i, object);
+		_timeIns.insert(i, timeIn);
+		_timeOuts.insert(i, timeOut);
+
+		// The long objects following the new one are shifted
+		int l = std::lower_bound(_longPositions.constBegin(), _longPositions.constEnd(), i) - _longPositions.constBegin();
+		for(int j = l; j < _longPositions.count(); j++)
+			_longPositions[j]++;
+		if(isLong(timeIn, timeOut))
+			_longPositions.insert(l, i);
+		else
+			_maxShortDuration = qMax(_maxShortDuration, timeOut - timeIn);
+	}
+
+	/**
+	 * @brief Remove all the objects
+	 */
+	void clear() {
+		_objects.clear();
+		_timeIns.clear();
+		_timeOuts.clear();
+		_longPositions.clear();
+		_maxShortDuration = 0;
+	}
+
+	/**
+	 * @brief The object count
+	 * @return An integer
+	 */
+	int count() const {
+		return _objects.count();
+	}
+
+	/**
+	 * @brief An object of the index
+	 * @param i A position between 0 and count()
+	 * @return The object
+	 */
+	T *at(int i) const {
+		return _objects.at(i);
+	}
+
+	/**
+	 * @brief The time in of an object of the index
+	 * @param i A position between 0 and count()
+	 * @return A time value
+	 */
+	PhTime timeIn(int i) const {
+		return _timeIns.at(i);
+	}
+
+	/**
+	 * @brief The time out of an object of the index
+	 *
+	 * The objects without duration end at their time in.
+	 * @param i A position between 0 and count()
+	 * @return A time value
+	 */
+	PhTime timeOut(int i) const {
+		return _timeOuts.at(i);
+	}
+
+	/**
+	 * @brief All the objects
+	 * @return The objects sorted by time in
+	 */
+	QList<T *> objects() const {
+		QList<T *> result;
+		result.reserve(_objects.count());
+		foreach(T *object, _objects)
+			result.append(object);
+		return result;
+	}
+
+	/**
+	 * @brief The position of the first object starting at or after a time
+	 * @param time A time value
+	 * @return A position between 0 and count()
+	 */
+	int lowerBound(PhTime time) const {
+		return std::lower_bound(_timeIns.constBegin(), _timeIns.constEnd(), time) - _timeIns.constBegin();
+	}
+
+	/**
+	 * @brief The position of the first object starting after a time
+	 * @param time A time value
+	 * @return A position between 0 and count()
+	 */
+	int upperBound(PhTime time) const {
+		return std::upper_bound(_timeIns.constBegin(), _timeIns.constEnd(), time) - _timeIns.constBegin();
+	}
+
+	/**
+	 * @brief The first object starting after a time
+	 * @param time A time value
+	 * @return An object or NULL
+	 */
+	T *next(PhTime time) const {
+		int i = upperBound(time);
+		return i < count() ? _objects.at(i) : NULL;
+	}
+
+	/**
+	 * @brief The last object starting before a time
+	 * @param time A time value
+	 * @return An object or NULL
+	 */
+	T *previous(PhTime time) const {
+		int i = lowerBound(time);
+		return i > 0 ? _objects.at(i - 1) : NULL;
+	}
+
+	/**
+	 * @brief The time in of the first object starting after a time
+	 * @param time A time value
+	 * @return A time value or PHTIMEMAX
+	 */
+	PhTime nextTime(PhTime time) const {
+		int i = upperBound(time);
+		return i < count() ? _timeIns.at(i) : PHTIMEMAX;
+	}
+
+	/**
+	 * @brief The time in of the last object starting before a time
+	 * @param time A time value
+	 * @return A time value or PHTIMEMIN
+	 */
+	PhTime previousTime(PhTime time) const {
+		int i = lowerBound(time);
+		return i > 0 ? _timeIns.at(i - 1) : PHTIMEMIN;
+	}
+
+	/**
+	 * @brief The positions of the objects starting in a time range
+	 * @param timeIn The range start, included
+	 * @param timeOut The range end, included
+	 * @return A range of positions
+	 */
+	PhStripIndexRange startingRange(PhTime timeIn, PhTime timeOut) const {
+		PhStripIndexRange range = {lowerBound(timeIn), upperBound(timeOut)};
+		range.last = qMax(range.first, range.last);
+		return range;
+	}
+
+	/**
+	 * @brief The positions of the objects overlapping a time range
+	 *
+	 * Only the objects starting in the range or at most the longest duration
+	 * before it are read, besides the long ones.
+	 * @param timeIn The range start, included
+	 * @param timeOut The range end, included
+	 * @return The positions in ascending order
+	 */
+	QVector<int> overlappingPositions(PhTime timeIn, PhTime timeOut) const {
+		QVector<int> result;
+		PhTime start = (timeIn > PHTIMEMIN + _maxShortDuration) ? timeIn - _maxShortDuration : PHTIMEMIN;
+		int first = lowerBound(start);
+		int last = upperBound(timeOut);
+
+		// The long objects starting before the searched positions
+		foreach(int i, _longPositions) {
+			if(i >= first)
+				break;
+			if(_timeOuts.at(i) >= timeIn)
+				result.append(i);
+		}
+
+		for(int i = first; i < last; i++) {
+			if(_timeOuts.at(i) >= timeIn)
+				result.append(i);
+		}
+		return result;
+	}
+
+	/**
+	 * @brief The objects included in a time range
+	 * @param timeIn The range start, included
+	 * @param timeOut The range end, excluded
+	 * @return The objects sorted by time in
+	 */
+	QList<T *> within(PhTime timeIn, PhTime timeOut) const {
+		QList<T *> result;
+		PhStripIndexRange range = startingRange(timeIn, timeOut);
+		for(int i = range.first; i < range.last; i++) {
+			if(_timeOuts.at(i) < timeOut)
+				result.append(_objects.at(i));
+		}
+		return result;
+	}
+
+	/**
+	 * @brief The objects overlapping a time range, bounds included
+	 * @param timeIn The range start
+	 * @param timeOut The range end
+	 * @return The objects sorted by time in
+	 */
+	QList<T *> overlapping(PhTime timeIn, PhTime timeOut) const {
+		QList<T *> result;
+		foreach(int i, overlappingPositions(timeIn, timeOut))
+			result.append(_objects.at(i));
+		return result;
+	}
+
+private:
+	struct Entry {
+		PhTime timeIn;
+		PhTime timeOut;
+		T *object;
+	};
+
+	static bool entryLessThan(const Entry &e1, const Entry &e2) {
+		return e1.timeIn < e2.timeIn;
+	}
+
+	static bool isLong(PhTime timeIn, PhTime timeOut) {
+		return timeOut - timeIn > PHSTRIPINDEX_LONG_DURATION;
+	}
+
+	QVector<T *> _objects;
+	QVector<PhTime> _timeIns;
+	QVector<PhTime> _timeOuts;
+	// The positions of the objects longer than PHSTRIPINDEX_LONG_DURATION
+	QVector<int> _longPositions;
+	// The longest duration of the other objects
+	PhTime _maxShortDuration;
+};
+
+#endif // PHSTRIPINDEX_H
@@ -7,7 +7,10 @@
 
 #include "PhStripLoop.h"
 
-PhStripLoop::PhStripLoop(PhTime timeIn, QString label) : PhStripObject(timeIn)
+PhStripLoop::PhStripLoop(PhTime timeIn, QString label) : PhStripObject(timeIn, timeIn, NULL, 0, 0, 0, label)
+{
+}
+
+PhStripLoop::PhStripLoop(PhStripStore *store, int slot) : PhStripObject(store, slot)
 {
-	_label = label;
 }
@@ -19,6 +19,8 @@
  */
 class PhStripLoop : public PhStripObject
 {
+	friend class PhStripStore;
+
 public:
 	/**
 	 * @brief PhStripLoop constructor
@@ -35,10 +37,10 @@ public:
 	 * \return A string value
 	 */
 	QString label() {
-		return _label;
+		return _store->string(_slot);
 	}
 private:
-	QString _label;
+	PhStripLoop(PhStripStore *store, int slot);
 };
 
 
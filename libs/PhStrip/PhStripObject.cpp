@@ -7,15 +7,34 @@
 
 #include "PhStripObject.h"
 
-PhStripObject::PhStripObject(PhTime timeIn) : _timeIn(timeIn)
+PhStripObject::PhStripObject(PhTime timeIn) :
+	_store(new PhStripStore()),
+	_slot(_store->append(timeIn, timeIn, NULL, 0, 0, 0, QString())),
+	_ownsStore(true)
 {
 }
 
-PhTime PhStripObject::timeIn() {
-	return _timeIn;
+PhStripObject::PhStripObject(PhTime timeIn, PhTime timeOut, PhPeople *people, float y, float height, int type, const QString &string) :
+	_store(new PhStripStore()),
+	_slot(_store->append(timeIn, timeOut, people, y, height, type, string)),
+	_ownsStore(true)
+{
+}
+
+PhStripObject::PhStripObject(PhStripStore *store, int slot) :
+	_store(store),
+	_slot(slot),
+	_ownsStore(false)
+{
+}
+
+PhStripObject::~PhStripObject()
+{
+	if(_ownsStore)
+		delete _store;
 }
 
 bool PhStripObject::dtcomp(PhStripObject *a, PhStripObject *b)
 {
-	return a->_timeIn < b->_timeIn;
+	return a->timeIn() < b->timeIn();
 }
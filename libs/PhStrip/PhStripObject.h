@@ -9,18 +9,18 @@
 
 #include "PhSync/PhClock.h"
 
+#include "PhStripStore.h"
+
 /**
  * @brief Generic object of a rythmo strip (loop, cut, text, ...).
  *
  * Its only property is timeIn.
+ *
+ * The properties are not stored in the object but in a slot of a PhStripStore.
  */
 class PhStripObject {
+	friend class PhStripStore;
 
-private:
-	/**
-	 * Starting time of the object.
-	 */
-	PhTime _timeIn;
 public:
 	/**
 	 * @brief PhStripObject constructor
@@ -30,13 +30,14 @@ public:
 	/**
 	 * @brief ~PhStripObject
 	 */
-	virtual ~PhStripObject() {
-	}
+	virtual ~PhStripObject();
 	/**
 	 * @brief The time in
 	 * @return A PhTime
 	 */
-	PhTime timeIn();
+	PhTime timeIn() {
+		return _store->timeIn(_slot);
+	}
 
 	/**
 	 * @brief Compare two strip object based on the time in
@@ -46,6 +47,38 @@ public:
 	 * @return True if "a" has a stricly lower time in than "b", false otherwise.
 	 */
 	static bool dtcomp(PhStripObject *a, PhStripObject *b);
+
+protected:
+	/**
+	 * @brief Construct an object in a store of its own
+	 * @param timeIn The time in
+	 * @param timeOut The time out
+	 * @param people The people
+	 * @param y The vertical position
+	 * @param height The height
+	 * @param type The detect or cut type
+	 * @param string The content or the label
+	 */
+	PhStripObject(PhTime timeIn, PhTime timeOut, PhPeople *people, float y, float height, int type, const QString &string);
+
+	/**
+	 * @brief Construct a view on the slot of a store
+	 * @param store The store
+	 * @param slot The slot
+	 */
+	PhStripObject(PhStripStore *store, int slot);
+
+	/**
+	 * The store holding the properties.
+	 */
+	PhStripStore *_store;
+	/**
+	 * The slot of the properties in the store.
+	 */
+	int _slot;
+
+private:
+	bool _ownsStore;
 };
 
 #endif // PHSTRIPOBJECT_H
@@ -7,19 +7,28 @@
 #include "PhStrip/PhStripPeopleObject.h"
 
 
-PhStripPeopleObject::PhStripPeopleObject(PhTime timeIn, PhPeople *people, PhTime timeOut, float y, float height) : PhStripObject(timeIn),
-	_timeOut(timeOut), _people(people), _y(y), _height(height)
+PhStripPeopleObject::PhStripPeopleObject(PhTime timeIn, PhPeople *people, PhTime timeOut, float y, float height) :
+	PhStripObject(timeIn, timeOut, people, y, height, 0, QString())
+{
+}
+
+PhStripPeopleObject::PhStripPeopleObject(PhTime timeIn, PhPeople *people, PhTime timeOut, float y, float height, int type, const QString &string) :
+	PhStripObject(timeIn, timeOut, people, y, height, type, string)
+{
+}
+
+PhStripPeopleObject::PhStripPeopleObject(PhStripStore *store, int slot) : PhStripObject(store, slot)
 {
 }
 
 float PhStripPeopleObject::height() const
 {
-	return _height;
+	return _store->height(_slot);
 }
 
 void PhStripPeopleObject::setHeight(float height)
 {
-	_height = height;
+	_store->setHeight(_slot, height);
 }
 
 
@@ -33,42 +33,42 @@ public:
 	 * @return _people the corresponding PhPeople
 	 */
 	PhPeople * people() {
-		return _people;
+		return _store->people(_slot);
 	}
 	/**
 	 * @brief The object track
 	 * @return _y An integer
 	 */
 	float y() {
-		return _y;
+		return _store->y(_slot);
 	}
 	/**
 	 * @brief The time out
 	 * @return A time value
 	 */
 	PhTime timeOut() {
-		return _timeOut;
+		return _store->timeOut(_slot);
 	}
 	/**
 	 * @brief Affect a people
 	 * @param people
 	 */
 	void setPeople(PhPeople * people) {
-		_people = people;
+		_store->setPeople(_slot, people);
 	}
 	/**
 	 * @brief Set the y position of the text on the strip
 	 * @param y An float between 0 and 1
 	 */
 	void setY(float y) {
-		_y = y;
+		_store->setY(_slot, y);
 	}
 	/**
 	 * @brief Set the time out
 	 * @param timeOut A time
 	 */
 	void setTimeOut(PhTime timeOut) {
-		_timeOut = timeOut;
+		_store->setTimeOut(_slot, timeOut);
 	}
 	/**
 	 * @brief Height of the text
@@ -81,24 +81,25 @@ public:
 	 */
 	void setHeight(float height);
 
-private:
+protected:
 	/**
-	 * Indicate the end of the PhText. The text content is stretch between timeIn and timeOut
+	 * @brief Construct an object in a store of its own
+	 * @param timeIn The time in
+	 * @param people The people
+	 * @param timeOut The time out
+	 * @param y The track
+	 * @param height The track height
+	 * @param type The detect type
+	 * @param string The text content
 	 */
-	PhTime _timeOut;
+	PhStripPeopleObject(PhTime timeIn, PhPeople *people, PhTime timeOut, float y, float height, int type, const QString &string);
 
 	/**
-	 * Reference to the PhPeople who is affected to the PhStripPeopleObject
+	 * @brief Construct a view on the slot of a store
+	 * @param store The store
+	 * @param slot The slot
 	 */
-	PhPeople *_people;
-
-	/**
-	 * @brief _track
-	 * Track of the text, 0 is on top of the strip
-	 */
-	float _y;
-
-	float _height;
+	PhStripPeopleObject(PhStripStore *store, int slot);
 };
 
 #endif // PHSTRIPPEOPLEOBJECT_H
@@ -0,0 +1,166 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include <new>
+
+#include "PhStripStore.h"
+#include "PhStripCut.h"
+#include "PhStripDetect.h"
+#include "PhStripLoop.h"
+#include "PhStripText.h"
+
+PhStripStore::PhStripStore() : _blockUsed(0)
+{
+}
+
+PhStripStore::~PhStripStore()
+{
+	clear();
+}
+
+PhStripText *PhStripStore::createText(PhTime timeIn, PhPeople *people, PhTime timeOut, float y, const QString &content, float height)
+{
+	int slot = append(timeIn, timeOut, people, y, height, 0, content);
+	return new (allocate(sizeof(PhStripText))) PhStripText(this, slot);
+}
+
+PhStripDetect *PhStripStore::createDetect(int type, PhTime timeIn, PhPeople *people, PhTime timeOut, float y)
+{
+	int slot = append(timeIn, timeOut, people, y, 0.25f, type, QString());
+	return new (allocate(sizeof(PhStripDetect))) PhStripDetect(this, slot);
+}
+
+PhStripCut *PhStripStore::createCut(PhTime time, int type)
+{
+	int slot = append(time, time, NULL, 0, 0, type, QString());
+	return new (allocate(sizeof(PhStripCut))) PhStripCut(this, slot);
+}
+
+PhStripLoop *PhStripStore::createLoop(PhTime timeIn, const QString &label)
+{
+	int slot = append(timeIn, timeIn, NULL, 0, 0, 0, label);
+	return new (allocate(sizeof(PhStripLoop))) PhStripLoop(this, slot);
+}
+
+bool PhStripStore::adopt(PhStripObject *object)
+{
+	if(object->_store == this)
+		return true;
+	if(!object->_ownsStore)
+		return false;
+
+	PhStripStore *store = object->_store;
+	int slot = object->_slot;
+	object->_slot = append(store->timeIn(slot), store->timeOut(slot), store->people(slot),
+	                       store->y(slot), store->height(slot), store->type(slot), store->string(slot));
+	object->_store = this;
+	object->_ownsStore = false;
+	delete store;
+
+	_adoptedObjects.append(object);
+	return true;
+}
+
+void PhStripStore::clear()
+{
+	// The objects allocated in the blocks own nothing: their memory is released with the blocks.
+	qDeleteAll(_adoptedObjects);
+	_adoptedObjects.clear();
+	foreach(char *block, _blocks)
+		delete[] block;
+	_blocks.clear();
+	_blockUsed = 0;
+
+	_timeIns.clear();
+	_timeOuts.clear();
+	_ys.clear();
+	_heights.clear();
+	_peopleIndexes.clear();
+	_types.clear();
+	_stringIndexes.clear();
+
+	_peoples.clear();
+	_peopleIndexByPeople.clear();
+	_strings.clear();
+	_stringIndexByString.clear();
+}
+
+PhPeople *PhStripStore::people(int slot) const
+{
+	int index = _peopleIndexes.at(slot);
+	if(index < 0)
+		return NULL;
+	return _peoples.at(index);
+}
+
+QString PhStripStore::string(int slot) const
+{
+	int index = _stringIndexes.at(slot);
+	if(index < 0)
+		return QString();
+	return _strings.at(index);
+}
+
+void PhStripStore::setPeople(int slot, PhPeople *people)
+{
+	_peopleIndexes[slot] = peopleIndex(people);
+}
+
+int PhStripStore::append(PhTime timeIn, PhTime timeOut, PhPeople *people, float y, float height, int type, const QString &string)
+{
+	_timeIns.append(timeIn);
+	_timeOuts.append(timeOut);
+	_ys.append(y);
+	_heights.append(height);
+	_peopleIndexes.append(peopleIndex(people));
+	_types.append(type);
+	_stringIndexes.append(stringIndex(string));
+	return _timeIns.count() - 1;
+}
+
+void *PhStripStore::allocate(int size)
+{
+	// Keep the objects aligned on the pointer size
+	int alignment = sizeof(void *);
+	size = (size + alignment - 1) / alignment * alignment;
+
+	if(_blocks.isEmpty() || (_blockUsed + size > PHSTRIPSTORE_BLOCK_SIZE)) {
+		_blocks.append(new char[PHSTRIPSTORE_BLOCK_SIZE]);
+		_blockUsed = 0;
+	}
+
+	void *result = _blocks.last() + _blockUsed;
+	_blockUsed += size;
+	return result;
+}
+
+int PhStripStore::peopleIndex(PhPeople *people)
+{
+	if(people == NULL)
+		return -1;
+
+	QHash<PhPeople *, int>::const_iterator it = _peopleIndexByPeople.constFind(people);
+	if(it != _peopleIndexByPeople.constEnd())
+		return it.value();
+
+	_peoples.append(people);
+	_peopleIndexByPeople.insert(people, _peoples.count() - 1);
+	return _peoples.count() - 1;
+}
+
+int PhStripStore::stringIndex(const QString &string)
+{
+	if(string.isNull())
+		return -1;
+
+	QHash<QString, int>::const_iterator it = _stringIndexByString.constFind(string);
+	if(it != _stringIndexByString.constEnd())
+		return it.value();
+
+	_strings.append(string);
+	_stringIndexByString.insert(string, _strings.count() - 1);
+	return _strings.count() - 1;
+}
@@ -0,0 +1,259 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef PHSTRIPSTORE_H
+#define PHSTRIPSTORE_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include "PhSync/PhClock.h"
+
+/** The size of the memory blocks in which a PhStripStore allocates its objects */
+#define PHSTRIPSTORE_BLOCK_SIZE 65536
+
+class PhPeople;
+class PhStripObject;
+class PhStripText;
+class PhStripDetect;
+class PhStripCut;
+class PhStripLoop;
+
+/**
+ * @brief The storage of the strip objects of a document
+ *
+ * The properties of the objects are kept in parallel arrays indexed by a slot:
+ * time in, time out, vertical position, height, people, type and string.
+ * The people are stored as an index in a table of the store and the text
+ * contents and loop labels as an index in a pool where each string is kept once.
+ *
+ * The strip objects are views on a slot. The store allocates them one after
+ * another in large blocks and releases all of them with clear().
+ * An object created outside the store keeps its properties in a store of its
+ * own until adopt() moves them to a document.
+ */
+class PhStripStore
+{
+public:
+	/**
+	 * @brief PhStripStore constructor
+	 */
+	PhStripStore();
+
+	~PhStripStore();
+
+	/**
+	 * @brief Create a text
+	 * @param timeIn The time in
+	 * @param people The people
+	 * @param timeOut The time out
+	 * @param y The vertical position
+	 * @param content The content
+	 * @param height The height
+	 * @return A text owned by the store
+	 */
+	PhStripText *createText(PhTime timeIn, PhPeople *people, PhTime timeOut, float y, const QString &content, float height);
+
+	/**
+	 * @brief Create a detect
+	 * @param type The detect type
+	 * @param timeIn The time in
+	 * @param people The people
+	 * @param timeOut The time out
+	 * @param y The vertical position
+	 * @return A detect owned by the store
+	 */
+	PhStripDetect *createDetect(int type, PhTime timeIn, PhPeople *people, PhTime timeOut, float y);
+
+	/**
+	 * @brief Create a cut
+	 * @param time The cut time
+	 * @param type The cut type
+	 * @return A cut owned by the store
+	 */
+	PhStripCut *createCut(PhTime time, int type);
+
+	/**
+	 * @brief Create a loop
+	 * @param timeIn The loop time
+	 * @param label The loop label
+	 * @return A loop owned by the store
+	 */
+	PhStripLoop *createLoop(PhTime timeIn, const QString &label);
+
+	/**
+	 * @brief Take the ownership of an object created outside the store
+	 *
+	 * The properties of the object are moved to the store and the object
+	 * becomes a view on them. It is deleted by clear().
+	 * @param object A strip object created with new
+	 * @return True if the object belongs to the store, false if it belongs to another one
+	 */
+	bool adopt(PhStripObject *object);
+
+	/**
+	 * @brief Delete all the objects and their properties
+	 */
+	void clear();
+
+	/**
+	 * @brief The number of slots
+	 * @return An integer value
+	 */
+	int count() const {
+		return _timeIns.count();
+	}
+
+	/**
+	 * @brief The number of strings in the pool
+	 * @return An integer value
+	 */
+	int stringCount() const {
+		return _strings.count();
+	}
+
+	/**
+	 * @brief The number of memory blocks holding the objects
+	 * @return An integer value
+	 */
+	int blockCount() const {
+		return _blocks.count();
+	}
+
+	/**
+	 * @brief The time in of a slot
+	 * @param slot A slot
+	 * @return A time value
+	 */
+	PhTime timeIn(int slot) const {
+		return _timeIns.at(slot);
+	}
+
+	/**
+	 * @brief The time out of a slot
+	 * @param slot A slot
+	 * @return A time value
+	 */
+	PhTime timeOut(int slot) const {
+		return _timeOuts.at(slot);
+	}
+
+	/**
+	 * @brief The vertical position of a slot
+	 * @param slot A slot
+	 * @return A float value
+	 */
+	float y(int slot) const {
+		return _ys.at(slot);
+	}
+
+	/**
+	 * @brief The height of a slot
+	 * @param slot A slot
+	 * @return A float value
+	 */
+	float height(int slot) const {
+		return _heights.at(slot);
+	}
+
+	/**
+	 * @brief The type of a slot
+	 * @param slot A slot
+	 * @return A detect or cut type
+	 */
+	int type(int slot) const {
+		return _types.at(slot);
+	}
+
+	/**
+	 * @brief The people of a slot
+	 * @param slot A slot
+	 * @return A people or NULL
+	 */
+	PhPeople *people(int slot) const;
+
+	/**
+	 * @brief The string of a slot
+	 * @param slot A slot
+	 * @return The content of a text or the label of a loop
+	 */
+	QString string(int slot) const;
+
+	/**
+	 * @brief Set the time out of a slot
+	 * @param slot A slot
+	 * @param timeOut A time value
+	 */
+	void setTimeOut(int slot, PhTime timeOut) {
+		_timeOuts[slot] = timeOut;
+	}
+
+	/**
+	 * @brief Set the vertical position of a slot
+	 * @param slot A slot
+	 * @param y A float value
+	 */
+	void setY(int slot, float y) {
+		_ys[slot] = y;
+	}
+
+	/**
+	 * @brief Set the height of a slot
+	 * @param slot A slot
+	 * @param height A float value
+	 */
+	void setHeight(int slot, float height) {
+		_heights[slot] = height;
+	}
+
+	/**
+	 * @brief Set the people of a slot
+	 * @param slot A slot
+	 * @param people A people or NULL
+	 */
+	void setPeople(int slot, PhPeople *people);
+
+	/**
+	 * @brief Add a slot
+	 * @param timeIn The time in
+	 * @param timeOut The time out
+	 * @param people The people
+	 * @param y The vertical position
+	 * @param height The height
+	 * @param type The detect or cut type
+	 * @param string The content or the label
+	 * @return The new slot
+	 */
+	int append(PhTime timeIn, PhTime timeOut, PhPeople *people, float y, float height, int type, const QString &string);
+
+private:
+	Q_DISABLE_COPY(PhStripStore)
+
+	void *allocate(int size);
+	int peopleIndex(PhPeople *people);
+	int stringIndex(const QString &string);
+
+	QVector<PhTime> _timeIns;
+	QVector<PhTime> _timeOuts;
+	QVector<float> _ys;
+	QVector<float> _heights;
+	QVector<int> _peopleIndexes;
+	QVector<int> _types;
+	QVector<int> _stringIndexes;
+
+	QVector<PhPeople *> _peoples;
+	QHash<PhPeople *, int> _peopleIndexByPeople;
+	QVector<QString> _strings;
+	QHash<QString, int> _stringIndexByString;
+
+	QList<char *> _blocks;
+	int _blockUsed;
+	QList<PhStripObject *> _adoptedObjects;
+};
+
+#endif // PHSTRIPSTORE_H
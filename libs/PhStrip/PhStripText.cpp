@@ -9,12 +9,16 @@
 
 
 PhStripText::PhStripText(PhTime timeIn, PhPeople *people, PhTime timeOut, float track, QString content, float height) :
-	PhStripPeopleObject(timeIn, people, timeOut, track, height), _content(content)
+	PhStripPeopleObject(timeIn, people, timeOut, track, height, 0, content)
+{
+}
+
+PhStripText::PhStripText(PhStripStore *store, int slot) : PhStripPeopleObject(store, slot)
 {
 }
 
 QString PhStripText::content()
 {
-	return _content;
+	return _store->string(_slot);
 }
 
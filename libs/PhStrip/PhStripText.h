@@ -16,6 +16,7 @@
  * Its property is content.
  */
 class PhStripText : public PhStripPeopleObject {
+	friend class PhStripStore;
 
 public:
 
@@ -36,11 +37,7 @@ public:
 	QString content();
 
 private:
-
-/**
- * Text string of Sentence or part of a sentence.
- */
-	QString _content;
+	PhStripText(PhStripStore *store, int slot);
 };
 
 #endif // PHSTRIPTEXT_H
@@ -19,18 +19,24 @@ PhClock::PhClock() :
 
 void PhClock::setTime(qint64 time)
 {
-	if (_time != time) {
+	{
+		QMutexLocker locker(&_mutex);
+		if (_time == time)
+			return;
 		_time = time;
-		emit timeChanged(time);
 	}
+	emit timeChanged(time);
 }
 
 void PhClock::setRate(PhRate rate)
 {
-	if (_rate != rate) {
+	{
+		QMutexLocker locker(&_mutex);
+		if (_rate == rate)
+			return;
 		_rate = rate;
-		emit rateChanged(rate);
 	}
+	emit rateChanged(rate);
 }
 
 void PhClock::setMillisecond(PhTime ms)
@@ -40,7 +46,7 @@ void PhClock::setMillisecond(PhTime ms)
 
 PhTime PhClock::milliSecond()
 {
-	return _time / 24;
+	return time() / 24;
 }
 
 void PhClock::setFrame(PhFrame frame, PhTimeCodeType tcType)
@@ -50,7 +56,7 @@ void PhClock::setFrame(PhFrame frame, PhTimeCodeType tcType)
 
 PhFrame PhClock::frame(PhTimeCodeType tcType) const
 {
-	return _time / PhTimeCode::timePerFrame(tcType);
+	return time() / PhTimeCode::timePerFrame(tcType);
 }
 
 void PhClock::setTimeCode(QString tc, PhTimeCodeType tcType)
@@ -60,11 +66,20 @@ void PhClock::setTimeCode(QString tc, PhTimeCodeType tcType)
 
 QString PhClock::timeCode(PhTimeCodeType tcType)
 {
-	return PhTimeCode::stringFromTime(_time, tcType);
+	return PhTimeCode::stringFromTime(time(), tcType);
 }
 
 void PhClock::elapse(PhTime elapsedTime)
 {
-	this->setTime(_time + elapsedTime * _rate);
+	// The time may be changed by another thread meanwhile
+	PhTime time;
+	{
+		QMutexLocker locker(&_mutex);
+		time = _time + elapsedTime * _rate;
+		if(time == _time)
+			return;
+		_time = time;
+	}
+	emit timeChanged(time);
 }
 
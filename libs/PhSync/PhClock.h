@@ -7,6 +7,8 @@
 #ifndef PHCLOCK_H
 #define PHCLOCK_H
 
+#include <QMutex>
+
 #include "PhTools/PhGeneric.h"
 
 #include "PhTimeCode.h"
@@ -16,6 +18,10 @@
  *
  * It can be synchronized through an external signal.
  * It emit a signal when its time and rate value changes.
+ *
+ * The clock can be read and changed from several threads (for example
+ * by the GUI and a render thread): the signals are then emitted from
+ * the thread changing the clock.
  */
 class PhClock : public QObject
 {
@@ -58,6 +64,7 @@ public:
 	 * @return The PhTime of the clock
 	 */
 	PhTime time() const {
+		QMutexLocker locker(&_mutex);
 		return _time;
 	}
 	/**
@@ -65,6 +72,7 @@ public:
 	 * @return The clock PhRate
 	 */
 	PhRate rate() const {
+		QMutexLocker locker(&_mutex);
 		return _rate;
 	}
 	/**
@@ -106,6 +114,7 @@ public slots:
 	void elapse(PhTime elapsedTime);
 
 private:
+	mutable QMutex _mutex;
 	PhTime _time;
 	PhRate _rate;
 };
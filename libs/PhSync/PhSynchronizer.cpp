@@ -12,6 +12,7 @@ PhSynchronizer::PhSynchronizer()
 	_stripClock(NULL),
 	_videoClock(NULL),
 	_syncClock(NULL),
+	_mutex(QMutex::Recursive),
 	_settingStripTime(false),
 	_settingVideoTime(false),
 	_settingSonyTime(false),
@@ -25,8 +26,10 @@ void PhSynchronizer::setStripClock(PhClock *clock)
 {
 	_stripClock = clock;
 	if(clock) {
-		connect(_stripClock, &PhClock::timeChanged, this, &PhSynchronizer::onStripTimeChanged);
-		connect(_stripClock, &PhClock::rateChanged, this, &PhSynchronizer::onStripRateChanged);
+		// The strip clock may be elapsed by a render thread: the video clock follows it
+		// without waiting for the GUI thread.
+		connect(_stripClock, &PhClock::timeChanged, this, &PhSynchronizer::onStripTimeChanged, Qt::DirectConnection);
+		connect(_stripClock, &PhClock::rateChanged, this, &PhSynchronizer::onStripRateChanged, Qt::DirectConnection);
 	}
 }
 
@@ -34,8 +37,8 @@ void PhSynchronizer::setVideoClock(PhClock *clock)
 {
 	_videoClock = clock;
 	if(clock) {
-		connect(_videoClock, &PhClock::timeChanged, this, &PhSynchronizer::onVideoTimeChanged);
-		connect(_videoClock, &PhClock::rateChanged, this, &PhSynchronizer::onVideoRateChanged);
+		connect(_videoClock, &PhClock::timeChanged, this, &PhSynchronizer::onVideoTimeChanged, Qt::DirectConnection);
+		connect(_videoClock, &PhClock::rateChanged, this, &PhSynchronizer::onVideoRateChanged, Qt::DirectConnection);
 	}
 }
 
@@ -51,6 +54,7 @@ void PhSynchronizer::setSyncClock(PhClock *clock, SyncType type)
 
 void PhSynchronizer::onStripTimeChanged(PhTime time)
 {
+	QMutexLocker locker(&_mutex);
 	if(!_settingStripTime) {
 		PHDBG(2) << time;
 		if(_syncClock) {
@@ -76,6 +80,7 @@ void PhSynchronizer::onStripTimeChanged(PhTime time)
 
 void PhSynchronizer::onStripRateChanged(PhRate rate)
 {
+	QMutexLocker locker(&_mutex);
 	if(!_settingStripRate) {
 		PHDEBUG << rate;
 		if(_syncClock) {
@@ -101,6 +106,7 @@ void PhSynchronizer::onVideoRateChanged(PhRate)
 
 void PhSynchronizer::onSyncTimeChanged(PhTime time)
 {
+	QMutexLocker locker(&_mutex);
 	if(!_settingSonyTime) {
 		PHDBG(3) << time;
 		if(_syncType != LTC) {
@@ -124,6 +130,7 @@ void PhSynchronizer::onSyncTimeChanged(PhTime time)
 
 void PhSynchronizer::onSyncRateChanged(PhRate rate)
 {
+	QMutexLocker locker(&_mutex);
 	if(!_settingSonyRate) {
 		PHDEBUG << rate;
 		_settingStripRate = true;
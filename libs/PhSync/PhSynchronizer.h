@@ -7,12 +7,19 @@
 #ifndef PHSYNCHRONIZER_H
 #define PHSYNCHRONIZER_H
 
+#include <QMutex>
+
 #include "PhTools/PhGeneric.h"
 
 #include "PhSync/PhClock.h"
 
 /**
  * @brief Provide a synchronisation system between the strip, the video and the external sync signal
+ *
+ * The strip clock may be elapsed by a render thread while the GUI thread
+ * changes the rate or the sync clock changes the time. The slots are
+ * serialized by a mutex so that the flags preventing the feedback loops
+ * are only seen by the thread propagating a change.
  */
 class PhSynchronizer : public QObject
 {
@@ -85,6 +92,8 @@ private:
 	PhClock * _stripClock;
 	PhClock * _videoClock;
 	PhClock * _syncClock;
+	// Recursive: setting a clock calls the slots again from the same thread
+	QMutex _mutex;
 	bool _settingStripTime;
 	bool _settingVideoTime;
 	bool _settingSonyTime;
@@ -26,10 +26,43 @@ PhFrame PhTimeCode::frameFromString(QString string, PhTimeCodeType type) {
 		sign = -1;
 		string = string.remove(0, 1);
 	}
-	QStringList list = string.split(':');
 	unsigned int hhmmssff[4];
 	memset(hhmmssff, 0, 4 * sizeof(unsigned int));
 
+	// The usual digits and colons are read in place: the importers convert
+	// a timecode for every object of the document.
+	unsigned int fields[4];
+	int fieldCount = 0;
+	unsigned int value = 0;
+	int digitCount = 0;
+	bool simple = true;
+	const QChar *data = string.constData();
+	for(int i = 0; i <= string.length(); i++) {
+		ushort c = (i < string.length()) ? data[i].unicode() : ':';
+		if(c == ':') {
+			if(fieldCount < 4)
+				fields[fieldCount] = value;
+			fieldCount++;
+			value = 0;
+			digitCount = 0;
+		}
+		else if((c >= '0') && (c <= '9') && (digitCount < 9)) {
+			value = 10 * value + (c - '0');
+			digitCount++;
+		}
+		else {
+			simple = false;
+			break;
+		}
+	}
+	if(simple) {
+		int shift = (fieldCount < 4) ? 4 - fieldCount : 0;
+		for(int i = 0; i < std::min(4, fieldCount); i++)
+			hhmmssff[i + shift] = fields[i];
+		return sign * frameFromHhMmSsFf(hhmmssff, type);
+	}
+
+	QStringList list = string.split(':');
 	for (int i = 0; i < std::min(4, list.count()); i++) {
 		int k = i;
 		if(list.count() < 4)
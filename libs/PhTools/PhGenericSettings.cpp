@@ -11,16 +11,19 @@ PhGenericSettings::PhGenericSettings(bool clear) : _settings(ORG_NAME, APP_NAME)
 
 void PhGenericSettings::clear()
 {
+	QMutexLocker locker(&_mutex);
 	_settings.clear();
 }
 
 void PhGenericSettings::setIntValue(QString name, int value)
 {
+	QMutexLocker locker(&_mutex);
 	_settings.setValue(name, value);
 }
 
 int PhGenericSettings::intValue(QString name, int defaultValue)
 {
+	QMutexLocker locker(&_mutex);
 	return _settings.value(name, defaultValue).toInt();
 }
 
@@ -35,36 +38,43 @@ int PhGenericSettings::intValueWithAlias(QString name, QString alias)
 
 void PhGenericSettings::setBoolValue(QString name, bool value)
 {
+	QMutexLocker locker(&_mutex);
 	_settings.setValue(name, value);
 }
 
 bool PhGenericSettings::boolValue(QString name, bool defaultValue)
 {
+	QMutexLocker locker(&_mutex);
 	return _settings.value(name, defaultValue).toBool();
 }
 
 void PhGenericSettings::setFloatValue(QString name, float value)
 {
+	QMutexLocker locker(&_mutex);
 	_settings.setValue(name, value);
 }
 
 float PhGenericSettings::floatValue(QString name, float defaultValue)
 {
+	QMutexLocker locker(&_mutex);
 	return _settings.value(name, defaultValue).toFloat();
 }
 
 void PhGenericSettings::setStringValue(QString name, QString value)
 {
+	QMutexLocker locker(&_mutex);
 	_settings.setValue(name, value);
 }
 
 QString PhGenericSettings::stringValue(QString name, QString defaultValue)
 {
+	QMutexLocker locker(&_mutex);
 	return _settings.value(name, defaultValue).toString();
 }
 
 void PhGenericSettings::setStringList(QString name, QStringList list)
 {
+	QMutexLocker locker(&_mutex);
 	_settings.remove(name);
 	_settings.beginWriteArray(name);
 	for(int i = 0; i < list.size(); i++) {
@@ -76,6 +86,7 @@ void PhGenericSettings::setStringList(QString name, QStringList list)
 
 QStringList PhGenericSettings::stringList(QString name, QStringList defaultValue)
 {
+	QMutexLocker locker(&_mutex);
 	QStringList list;
 	int size = _settings.beginReadArray(name);
 	if(size == 0)
@@ -93,10 +104,12 @@ QStringList PhGenericSettings::stringList(QString name, QStringList defaultValue
 
 void PhGenericSettings::setByteArray(QString name, QByteArray array)
 {
+	QMutexLocker locker(&_mutex);
 	_settings.setValue(name, array);
 }
 
 QByteArray PhGenericSettings::byteArray(QString name)
 {
+	QMutexLocker locker(&_mutex);
 	return _settings.value(name).toByteArray();
 }
@@ -1,6 +1,8 @@
 #ifndef PHGENERICSETTINGS_H
 #define PHGENERICSETTINGS_H
 
+#include <QMutex>
+
 #include "PhTools/PhData.h"
 
 /** Implement the integer setter and getter for a PhGenericSettings */
@@ -109,6 +111,8 @@ public: \
  * behaviour.
  * The main interest is to centralize the default value of each settings
  * and to insure settings name unicity and homogeneity.
+ *
+ * The settings can be accessed from several threads.
  */
 class PhGenericSettings
 {
@@ -219,6 +223,9 @@ protected:
 	 * @brief The QSettings object
 	 */
 	QSettings _settings;
+
+private:
+	QMutex _mutex;
 };
 
 #endif // PHGENERICSETTINGS_H
@@ -5,9 +5,17 @@
 
 HEADERS += \
     $$PWD/PhVideoEngine.h \
-    $$PWD/PhVideoSettings.h
+    $$PWD/PhVideoSettings.h \
+    $$PWD/PhVideoBuffer.h \
+    $$PWD/PhVideoPool.h \
+    $$PWD/PhVideoDecoder.h \
+    $$PWD/PhVideoIndex.h
 SOURCES += \
-    $$PWD/PhVideoEngine.cpp
+    $$PWD/PhVideoEngine.cpp \
+    $$PWD/PhVideoBuffer.cpp \
+    $$PWD/PhVideoPool.cpp \
+    $$PWD/PhVideoDecoder.cpp \
+    $$PWD/PhVideoIndex.cpp
 
 # Windows specific
 win32{
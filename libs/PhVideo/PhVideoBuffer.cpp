@@ -0,0 +1,76 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include "PhVideoBuffer.h"
+
+PhVideoBuffer::PhVideoBuffer() :
+	_format(BGRA),
+	_data(NULL),
+	_size(0),
+	_width(0),
+	_height(0),
+	_chromaWidth(0),
+	_chromaHeight(0),
+	_bitDepth(8),
+	_fullRange(false),
+	_bt709(false),
+	_frame(PHFRAMEMIN),
+	_time(PHTIMEMIN),
+	_generation(0),
+	_lastUse(0)
+{
+	_planeOffset[0] = _planeOffset[1] = _planeOffset[2] = 0;
+}
+
+PhVideoBuffer::~PhVideoBuffer()
+{
+	if(_data)
+		delete[] _data;
+}
+
+void PhVideoBuffer::reuse(int width, int height)
+{
+	allocate(width * height * 4);
+	_format = BGRA;
+	_width = width;
+	_height = height;
+	_chromaWidth = 0;
+	_chromaHeight = 0;
+	_planeOffset[0] = _planeOffset[1] = _planeOffset[2] = 0;
+	_bitDepth = 8;
+	_frame = PHFRAMEMIN;
+	_time = PHTIMEMIN;
+}
+
+void PhVideoBuffer::reuseYUV(int width, int height, int chromaWidth, int chromaHeight, int bitDepth)
+{
+	int bytesPerSample = (bitDepth > 8) ? 2 : 1;
+	int lumaSize = width * height * bytesPerSample;
+	int chromaSize = chromaWidth * chromaHeight * bytesPerSample;
+	allocate(lumaSize + 2 * chromaSize);
+
+	_format = YUV;
+	_width = width;
+	_height = height;
+	_chromaWidth = chromaWidth;
+	_chromaHeight = chromaHeight;
+	_planeOffset[0] = 0;
+	_planeOffset[1] = lumaSize;
+	_planeOffset[2] = lumaSize + chromaSize;
+	_bitDepth = bitDepth;
+	_frame = PHFRAMEMIN;
+	_time = PHTIMEMIN;
+}
+
+void PhVideoBuffer::allocate(int size)
+{
+	if(size > _size) {
+		if(_data)
+			delete[] _data;
+		_data = new uint8_t[size];
+		_size = size;
+	}
+}
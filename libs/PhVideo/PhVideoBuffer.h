@@ -0,0 +1,255 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef PHVIDEOBUFFER_H
+#define PHVIDEOBUFFER_H
+
+#include <stdint.h>
+#include <QtGlobal>
+
+#include "PhSync/PhTime.h"
+
+/**
+ * @brief A decoded and converted video frame
+ *
+ * The buffer hold the picture of a single frame and the information
+ * needed to identify it: its frame number and its time relative to the
+ * beginning of the video file.
+ *
+ * The picture is either a packed BGRA picture or three tightly packed
+ * Y, U and V planes which are converted to RGB by the graphic card.
+ * The buffers are allocated once and recycled by the PhVideoPool.
+ */
+class PhVideoBuffer
+{
+public:
+	/**
+	 * @brief The picture format
+	 */
+	enum Format {
+		BGRA,
+		YUV,
+	};
+
+	/**
+	 * @brief PhVideoBuffer constructor
+	 */
+	PhVideoBuffer();
+
+	~PhVideoBuffer();
+
+	/**
+	 * @brief Prepare the buffer to receive a new picture
+	 *
+	 * The memory is only reallocated if the picture size grows.
+	 * @param width The picture width
+	 * @param height The picture height
+	 */
+	void reuse(int width, int height);
+
+	/**
+	 * @brief Prepare the buffer to receive a new planar YUV picture
+	 *
+	 * The memory is only reallocated if the picture size grows.
+	 * @param width The luma plane width
+	 * @param height The luma plane height
+	 * @param chromaWidth The chroma planes width
+	 * @param chromaHeight The chroma planes height
+	 * @param bitDepth The number of significant bits per sample (8 or 10)
+	 */
+	void reuseYUV(int width, int height, int chromaWidth, int chromaHeight, int bitDepth);
+
+	/**
+	 * @brief The picture format
+	 * @return A format value
+	 */
+	Format format() {
+		return _format;
+	}
+
+	/**
+	 * @brief The picture data
+	 * @return A BGRA buffer
+	 */
+	uint8_t *rgb() {
+		return _data;
+	}
+
+	/**
+	 * @brief The data of a plane of a YUV picture
+	 * @param index 0 for Y, 1 for U, 2 for V
+	 * @return A buffer
+	 */
+	uint8_t *plane(int index) {
+		return _data + _planeOffset[index];
+	}
+
+	/**
+	 * @brief The width of a plane of a YUV picture
+	 * @param index 0 for Y, 1 for U, 2 for V
+	 * @return A value in pixel
+	 */
+	int planeWidth(int index) {
+		return index ? _chromaWidth : _width;
+	}
+
+	/**
+	 * @brief The height of a plane of a YUV picture
+	 * @param index 0 for Y, 1 for U, 2 for V
+	 * @return A value in pixel
+	 */
+	int planeHeight(int index) {
+		return index ? _chromaHeight : _height;
+	}
+
+	/**
+	 * @brief The number of significant bits per sample of a YUV picture
+	 *
+	 * The samples are stored on 16 bits if this value is greater than 8.
+	 * @return An integer value
+	 */
+	int bitDepth() {
+		return _bitDepth;
+	}
+
+	/**
+	 * @brief The number of bytes per sample of a YUV picture
+	 * @return 1 or 2
+	 */
+	int bytesPerSample() {
+		return (_bitDepth > 8) ? 2 : 1;
+	}
+
+	/**
+	 * @brief Check if the YUV samples use the full range
+	 * @return True for full range (JPEG), false for video range
+	 */
+	bool fullRange() {
+		return _fullRange;
+	}
+
+	/**
+	 * @brief Set the YUV samples range
+	 * @param fullRange True for full range (JPEG), false for video range
+	 */
+	void setFullRange(bool fullRange) {
+		_fullRange = fullRange;
+	}
+
+	/**
+	 * @brief Check if the YUV picture use the ITU-R BT.709 (HD) color matrix
+	 * @return True for BT.709, false for BT.601
+	 */
+	bool bt709() {
+		return _bt709;
+	}
+
+	/**
+	 * @brief Set the YUV color matrix
+	 * @param bt709 True for BT.709, false for BT.601
+	 */
+	void setBT709(bool bt709) {
+		_bt709 = bt709;
+	}
+
+	/**
+	 * @brief The picture width
+	 * @return A value in pixel
+	 */
+	int width() {
+		return _width;
+	}
+
+	/**
+	 * @brief The picture height
+	 * @return A value in pixel
+	 */
+	int height() {
+		return _height;
+	}
+
+	/**
+	 * @brief The frame number of the picture
+	 * @return A frame value relative to the beginning of the file
+	 */
+	PhFrame frame() {
+		return _frame;
+	}
+
+	/**
+	 * @brief Set the frame number of the picture
+	 * @param frame A frame value
+	 */
+	void setFrame(PhFrame frame) {
+		_frame = frame;
+	}
+
+	/**
+	 * @brief The decoded timestamp of the picture
+	 * @return A time value relative to the beginning of the file
+	 */
+	PhTime time() {
+		return _time;
+	}
+
+	/**
+	 * @brief Set the decoded timestamp of the picture
+	 * @param time A time value
+	 */
+	void setTime(PhTime time) {
+		_time = time;
+	}
+
+	/**
+	 * @brief The pool generation the buffer was filled for
+	 * @return An integer value
+	 */
+	int generation() {
+		return _generation;
+	}
+
+	/**
+	 * @brief Set the pool generation
+	 * @param generation An integer value
+	 */
+	void setGeneration(int generation) {
+		_generation = generation;
+	}
+
+	/**
+	 * @brief The last time the pool gave access to the buffer
+	 * @return A counter value (higher is more recent)
+	 */
+	quint64 lastUse() {
+		return _lastUse;
+	}
+
+	/**
+	 * @brief Set the last time the pool gave access to the buffer
+	 * @param lastUse A counter value
+	 */
+	void setLastUse(quint64 lastUse) {
+		_lastUse = lastUse;
+	}
+
+private:
+	void allocate(int size);
+
+	Format _format;
+	uint8_t *_data;
+	int _size;
+	int _width, _height;
+	int _chromaWidth, _chromaHeight;
+	int _planeOffset[3];
+	int _bitDepth;
+	bool _fullRange, _bt709;
+	PhFrame _frame;
+	PhTime _time;
+	int _generation;
+	quint64 _lastUse;
+};
+
+#endif // PHVIDEOBUFFER_H
@@ -0,0 +1,794 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include "PhTools/PhGeneric.h"
+#include "PhTools/PhDebug.h"
+#include "PhGraphic/PhGraphicProfiler.h"
+
+#include "PhVideoDecoder.h"
+
+/** Rate above which the non reference frames are skipped */
+#define PHVIDEO_SKIP_NONREF_RATE 2
+/** Rate above which only the keyframes are decoded */
+#define PHVIDEO_SKIP_NONKEY_RATE 8
+
+/**
+ * @brief The layout of the YUV pixel formats supported by PhVideoBuffer
+ * @param format A pixel format
+ * @param chromaShiftX The horizontal chroma subsampling (log2)
+ * @param chromaShiftY The vertical chroma subsampling (log2)
+ * @param bitDepth The number of bits per sample
+ * @param fullRange Set to true for the JPEG formats
+ * @return False if the format is not supported
+ */
+static bool yuvLayout(AVPixelFormat format, int &chromaShiftX, int &chromaShiftY, int &bitDepth, bool &fullRange)
+{
+	switch (format) {
+	case AV_PIX_FMT_YUVJ420P:
+		fullRange = true;
+		// fall through
+	case AV_PIX_FMT_YUV420P:
+		chromaShiftX = 1;
+		chromaShiftY = 1;
+		bitDepth = 8;
+		return true;
+	case AV_PIX_FMT_YUVJ422P:
+		fullRange = true;
+		// fall through
+	case AV_PIX_FMT_YUV422P:
+		chromaShiftX = 1;
+		chromaShiftY = 0;
+		bitDepth = 8;
+		return true;
+	case AV_PIX_FMT_YUVJ444P:
+		fullRange = true;
+		// fall through
+	case AV_PIX_FMT_YUV444P:
+		chromaShiftX = 0;
+		chromaShiftY = 0;
+		bitDepth = 8;
+		return true;
+	case AV_PIX_FMT_YUV420P10LE:
+		chromaShiftX = 1;
+		chromaShiftY = 1;
+		bitDepth = 10;
+		return true;
+	case AV_PIX_FMT_YUV422P10LE:
+		chromaShiftX = 1;
+		chromaShiftY = 0;
+		bitDepth = 10;
+		return true;
+	case AV_PIX_FMT_YUV444P10LE:
+		chromaShiftX = 0;
+		chromaShiftY = 0;
+		bitDepth = 10;
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief Record a decoding stage which just ended in the frame profiler
+ * @param stage The stage
+ * @param duration The stage duration in nanoseconds
+ */
+static void addProfilerSample(PhGraphicProfiler::Stage stage, qint64 duration)
+{
+	PhGraphicProfiler *profiler = PhGraphicProfiler::instance();
+	if(profiler->enabled())
+		profiler->addSample(stage, profiler->now() - duration, duration);
+}
+
+PhVideoDecoder::PhVideoDecoder(PhVideoPool *pool) :
+	_pool(pool),
+	_tcType(PhTimeCodeType25),
+	_timeIn(0),
+	_formatContext(NULL),
+	_videoStream(NULL),
+	_videoFrame(NULL),
+	_swsContext(NULL),
+	_currentTime(PHTIMEMIN),
+	_useAudio(false),
+	_audioStream(NULL),
+	_audioFrame(NULL),
+	_deinterlace(false),
+	_yuvOutput(true),
+	_threadCount(0),
+	_threadType(AutoThreading),
+	_rate(0),
+	_decodeMode(DecodeAllFrames),
+	_preloadFrame(0),
+	_lastPreloadFrame(-1),
+	_decodingRequested(0),
+	_decodeRate(0),
+	_pictureSize(0)
+{
+	// The threading is set through a queued connection by the engine
+	qRegisterMetaType<PhVideoDecoder::ThreadType>("PhVideoDecoder::ThreadType");
+	resetStatistics();
+	av_register_all();
+	avcodec_register_all();
+}
+
+PhVideoDecoder::~PhVideoDecoder()
+{
+	close();
+}
+
+bool PhVideoDecoder::ready()
+{
+	return (_formatContext && _videoStream && _videoFrame);
+}
+
+bool PhVideoDecoder::open(QString fileName)
+{
+	close();
+	PHDEBUG << fileName;
+
+	_currentTime = PHTIMEMIN;
+
+	if(avformat_open_input(&_formatContext, fileName.toStdString().c_str(), NULL, NULL) < 0)
+		return false;
+
+	PHDEBUG << "Retrieve stream information";
+	if (avformat_find_stream_info(_formatContext, NULL) < 0)
+		return false; // Couldn't find stream information
+
+	av_dump_format(_formatContext, 0, fileName.toStdString().c_str(), 0);
+
+	// Find video stream :
+	for(int i = 0; i < (int)_formatContext->nb_streams; i++) {
+		AVMediaType streamType = _formatContext->streams[i]->codec->codec_type;
+		PHDEBUG << i << ":" << streamType;
+		switch(streamType) {
+		case AVMEDIA_TYPE_VIDEO:
+			_videoStream = _formatContext->streams[i];
+			PHDEBUG << "\t=> video";
+			break;
+		case AVMEDIA_TYPE_AUDIO:
+			if(_useAudio && (_audioStream == NULL))
+				_audioStream = _formatContext->streams[i];
+			PHDEBUG << "\t=> audio";
+			break;
+		default:
+			PHDEBUG << "\t=> unknown";
+			break;
+		}
+	}
+
+	// The packets of the unused streams are not even demuxed
+	for(int i = 0; i < (int)_formatContext->nb_streams; i++) {
+		AVStream *stream = _formatContext->streams[i];
+		if((stream != _videoStream) && (stream != _audioStream))
+			stream->discard = AVDISCARD_ALL;
+	}
+
+	if(_videoStream == NULL)
+		return false;
+
+	// Looking for timecode type
+	_tcType = PhTimeCode::computeTimeCodeType(this->framePerSecond());
+
+	// Reading timestamp :
+	AVDictionaryEntry *tag = av_dict_get(_formatContext->metadata, "timecode", NULL, AV_DICT_IGNORE_SUFFIX);
+	if(tag == NULL)
+		tag = av_dict_get(_videoStream->metadata, "timecode", NULL, AV_DICT_IGNORE_SUFFIX);
+
+	if(tag) {
+		PHDEBUG << "Found timestamp:" << tag->value;
+		_timeIn = PhTimeCode::timeFromString(tag->value, _tcType);
+	}
+
+	PHDEBUG << "size : " << _videoStream->codec->width << "x" << _videoStream->codec->height;
+	AVCodec * videoCodec = avcodec_find_decoder(_videoStream->codec->codec_id);
+	if(videoCodec == NULL) {
+		PHDEBUG << "Unable to find the codec:" << _videoStream->codec->codec_id;
+		return false;
+	}
+
+	_videoStream->codec->thread_count = _threadCount;
+	switch(_threadType) {
+	case FrameThreading:
+		_videoStream->codec->thread_type = FF_THREAD_FRAME;
+		break;
+	case SliceThreading:
+		_videoStream->codec->thread_type = FF_THREAD_SLICE;
+		break;
+	case AutoThreading:
+		_videoStream->codec->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+		break;
+	}
+
+	if (avcodec_open2(_videoStream->codec, videoCodec, NULL) < 0) {
+		PHDEBUG << "Unable to open the codec:" << _videoStream->codec;
+		return false;
+	}
+
+	PHDEBUG << "threads:" << _videoStream->codec->thread_count
+	        << "frame:" << ((_videoStream->codec->active_thread_type & FF_THREAD_FRAME) != 0)
+	        << "slice:" << ((_videoStream->codec->active_thread_type & FF_THREAD_SLICE) != 0);
+
+	resetStatistics();
+
+	_videoFrame = av_frame_alloc();
+
+	PHDEBUG << "length:" << this->length();
+	PHDEBUG << "fps:" << this->framePerSecond();
+
+	if(_audioStream) {
+		AVCodec* audioCodec = avcodec_find_decoder(_audioStream->codec->codec_id);
+		if(audioCodec) {
+			if(avcodec_open2(_audioStream->codec, audioCodec, NULL) < 0) {
+				PHDEBUG << "Unable to open audio codec.";
+				_audioStream = NULL;
+			}
+			else {
+				_audioFrame = av_frame_alloc();
+				PHDEBUG << "Audio OK.";
+			}
+		}
+		else {
+			PHDEBUG << "Unable to find codec for audio.";
+			_audioStream = NULL;
+		}
+	}
+
+	applyDecodeMode();
+	updatePictureSize();
+
+	_index.build(fileName);
+
+	return true;
+}
+
+void PhVideoDecoder::close()
+{
+	_index.clear();
+
+	if (_swsContext) {
+		sws_freeContext(_swsContext);
+		_swsContext = NULL;
+	}
+
+	if(_formatContext) {
+		PHDEBUG << "Close the media context.";
+		if(_videoStream)
+			avcodec_close(_videoStream->codec);
+		if(_audioStream)
+			avcodec_close(_audioStream->codec);
+		avformat_close_input(&_formatContext);
+	}
+
+	if (_videoFrame) {
+		av_frame_free(&_videoFrame);
+		_videoFrame = NULL;
+	}
+
+	if (_audioFrame) {
+		av_frame_free(&_audioFrame);
+		_audioFrame = NULL;
+	}
+
+	_tcType = PhTimeCodeType25;
+	_timeIn = 0;
+	_formatContext = NULL;
+	_videoStream = NULL;
+	_audioStream = NULL;
+	_currentTime = PHTIMEMIN;
+	_preloadFrame = 0;
+	_lastPreloadFrame = -1;
+	updatePictureSize();
+}
+
+void PhVideoDecoder::setDeinterlace(bool deinterlace)
+{
+	PHDEBUG << deinterlace;
+	_deinterlace = deinterlace;
+	updatePictureSize();
+}
+
+void PhVideoDecoder::setThreading(int threadCount, PhVideoDecoder::ThreadType threadType)
+{
+	PHDEBUG << threadCount << threadType;
+	_threadCount = threadCount;
+	_threadType = threadType;
+}
+
+PhVideoDecoder::DecodeMode PhVideoDecoder::decodeMode(PhRate rate)
+{
+	if(qAbs(rate) > PHVIDEO_SKIP_NONKEY_RATE)
+		return DecodeKeyframes;
+	if(qAbs(rate) > PHVIDEO_SKIP_NONREF_RATE)
+		return DecodeReferenceFrames;
+	return DecodeAllFrames;
+}
+
+void PhVideoDecoder::setRate(PhRate rate)
+{
+	_rate = rate;
+	DecodeMode mode = decodeMode(rate);
+	if(mode != _decodeMode) {
+		PHDBG(24) << rate << mode;
+		_decodeMode = mode;
+		applyDecodeMode();
+	}
+
+	if(rate == 0)
+		requestDecoding();
+}
+
+void PhVideoDecoder::applyDecodeMode()
+{
+	if(!ready())
+		return;
+
+	switch(_decodeMode) {
+	case DecodeAllFrames:
+		_videoStream->codec->skip_frame = AVDISCARD_DEFAULT;
+		break;
+	case DecodeReferenceFrames:
+		_videoStream->codec->skip_frame = AVDISCARD_NONREF;
+		break;
+	case DecodeKeyframes:
+		_videoStream->codec->skip_frame = AVDISCARD_NONKEY;
+		break;
+	}
+
+	if(_audioStream)
+		_audioStream->discard = (_decodeMode == DecodeAllFrames) ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+}
+
+void PhVideoDecoder::preload(PhFrame first, PhFrame last)
+{
+	PHDBG(24) << first << last;
+	_preloadFrame = first;
+	_lastPreloadFrame = last;
+	requestDecoding();
+}
+
+void PhVideoDecoder::requestDecoding()
+{
+	// Only one pending call in the event queue
+	if(_decodingRequested.testAndSetOrdered(0, 1))
+		QMetaObject::invokeMethod(this, "decodeWantedFrames", Qt::QueuedConnection);
+}
+
+void PhVideoDecoder::decodeWantedFrames()
+{
+	_decodingRequested.store(0);
+
+	if(!ready())
+		return;
+
+	// Going back to the event loop between each frame let the latest request be considered
+	PhFrame frame = _pool->nextMissingFrame();
+	if(frame != PHFRAMEMIN) {
+		if(!decodeFrame(frame) && (_pool->nextMissingFrame() == frame)) {
+			// The frame can't be decoded (end of file, corrupted data...)
+			PHDBG(24) << "unable to decode" << frame;
+			return;
+		}
+		requestDecoding();
+		return;
+	}
+
+	// Interleaving the preloading with the playback would cause a seek for each frame.
+	// It is resumed by setRate(0).
+	if(_rate != 0)
+		return;
+
+	while((_preloadFrame <= _lastPreloadFrame) && _pool->contains(_preloadFrame))
+		_preloadFrame++;
+
+	if(_preloadFrame <= _lastPreloadFrame) {
+		if(decodeFrame(_preloadFrame))
+			_preloadFrame++;
+		requestDecoding();
+	}
+}
+
+void PhVideoDecoder::resetStatistics()
+{
+	_statistics.seekCount = 0;
+	_statistics.seekTime = 0;
+	_statistics.decodeCount = 0;
+	_statistics.decodeTime = 0;
+	_statistics.convertCount = 0;
+	_statistics.convertTime = 0;
+}
+
+bool PhVideoDecoder::isStale(PhFrame frame)
+{
+	if(!_pool->isWanted(frame))
+		return true;
+	PhFrame urgentFrame = _pool->nextMissingFrame();
+	return (urgentFrame != PHFRAMEMIN) && (urgentFrame != frame);
+}
+
+void PhVideoDecoder::setYUVOutput(bool yuvOutput)
+{
+	PHDEBUG << yuvOutput;
+	_yuvOutput = yuvOutput;
+	updatePictureSize();
+}
+
+PhTime PhVideoDecoder::length()
+{
+	if(_videoStream)
+		return AVTimestamp_to_PhTime(_videoStream->duration);
+	return 0;
+}
+
+int PhVideoDecoder::width()
+{
+	if(_videoStream)
+		return _videoStream->codec->width;
+	return 0;
+}
+
+int PhVideoDecoder::height()
+{
+	if(_videoStream)
+		return _videoStream->codec->height;
+	return 0;
+}
+
+void PhVideoDecoder::updatePictureSize()
+{
+	if(_videoStream == NULL) {
+		_pictureSize.store(0);
+		return;
+	}
+
+	int lineStep = _deinterlace ? 2 : 1;
+	int width = _videoStream->codec->width;
+	int height = _videoStream->codec->height / lineStep;
+
+	int chromaShiftX, chromaShiftY, bitDepth;
+	bool fullRange;
+	if(_yuvOutput && yuvLayout(_videoStream->codec->pix_fmt, chromaShiftX, chromaShiftY, bitDepth, fullRange)) {
+		int chromaWidth = (width + (1 << chromaShiftX) - 1) >> chromaShiftX;
+		int chromaHeight = (height + (1 << chromaShiftY) - 1) >> chromaShiftY;
+		_pictureSize.store((width * height + 2 * chromaWidth * chromaHeight) * (bitDepth > 8 ? 2 : 1));
+	}
+	else
+		_pictureSize.store(width * height * 4);
+}
+
+double PhVideoDecoder::framePerSecond()
+{
+	// default is 25 fps.
+	// It will be used when loading a collection of image files (as it is done in the tests and specs),
+	// where ffmpeg framerate is undefined (avg_frame_rate.den is 0).
+	double result = 25.00f;
+
+	if(_videoStream && (_videoStream->avg_frame_rate.den != 0)) {
+		result =  av_q2d(_videoStream->avg_frame_rate);
+	}
+
+	return result;
+}
+
+QString PhVideoDecoder::codecName()
+{
+	if(_videoStream)
+		return _videoStream->codec->codec_descriptor->long_name;
+
+	return "";
+}
+
+bool PhVideoDecoder::decodeFrame(PhFrame frame)
+{
+	if(!ready()) {
+		PHDEBUG << "not ready";
+		return false;
+	}
+
+	// The engine may have moved since the request was sent
+	if(!_pool->isWanted(frame) || _pool->contains(frame))
+		return false;
+
+	PhTime time = frame * PhTimeCode::timePerFrame(_tcType);
+	if(time < 0)
+		time = 0;
+	if(time >= this->length())
+		time = this->length();
+
+	if(_decodeMode == DecodeKeyframes)
+		return decodeKeyframe(frame, time);
+
+	// We need to perform a frame seek if the requested frame is not the next frame in the stream
+	bool useIndex = _index.ready();
+	PhTime target = time;
+	PhTime seekTime = time;
+	// With frame threading, each seek costs one frame of latency per thread
+	// so it is cheaper to decode a few more frames forward.
+	int forwardFrames = 2;
+	if(_videoStream->codec->active_thread_type & FF_THREAD_FRAME)
+		forwardFrames += _videoStream->codec->thread_count;
+	// When skipping the non reference frames, decoding forward is cheap
+	if(_decodeMode == DecodeReferenceFrames)
+		forwardFrames += static_cast<int>(qAbs(_rate));
+	bool seek = (time <= _currentTime) || (time >= _currentTime + forwardFrames * frameDuration());
+	if(useIndex) {
+		// The exact time of the frame to reach and of the keyframe needed to decode it are known:
+		// no need to seek if the current position is already in the right GOP.
+		target = _index.frameTime(time);
+		seekTime = _index.keyframeTime(time);
+		seek = (target <= _currentTime) || (seekTime > _currentTime);
+	}
+
+	if(seek) {
+		// Seeking to the previous keyframe gives a correct picture with long GOP files
+		// and allows to keep the frames decoded on the way (see below).
+		PHDBG(24) << "seek:" << time << " " << _currentTime << " " << seekTime;
+		seekBackward(seekTime);
+	}
+
+	// Decode forward until reaching the frame which covers the requested time
+	while(readFrame()) {
+		bool reached;
+		if(useIndex)
+			reached = (_currentTime >= target);
+		else
+			reached = (_currentTime + frameDuration() > time);
+		if(reached) {
+			storeFrame(frame);
+			return true;
+		}
+
+		// When playing backward or stepping back, the engine wants the frames
+		// preceding the requested one: they are kept so that the GOP is decoded only once.
+		PhFrame decodedFrame = currentFrame();
+		if(_pool->isWanted(decodedFrame) && !_pool->contains(decodedFrame))
+			storeFrame(decodedFrame);
+
+		// Don't finish a GOP for a target the engine moved away from (slider scrubbing, cue jumps...):
+		// the next decoding starts directly from the latest request.
+		if(isStale(frame)) {
+			PHDBG(24) << "abandon" << frame;
+			return false;
+		}
+	}
+	return false;
+}
+
+bool PhVideoDecoder::decodeKeyframe(PhFrame frame, PhTime time)
+{
+	// The keyframe preceding the requested time is displayed instead of the exact frame
+	PhTime keyframeTime = time;
+	if(_index.ready()) {
+		keyframeTime = _index.keyframeTime(time);
+		// The last decoded picture is still available
+		if(keyframeTime == _currentTime) {
+			storeFrame(frame);
+			return true;
+		}
+	}
+
+	seekBackward(keyframeTime);
+	if(readFrame()) {
+		storeFrame(frame);
+		return true;
+	}
+	return false;
+}
+
+void PhVideoDecoder::seekBackward(PhTime time)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	av_seek_frame(_formatContext, _videoStream->index, PhTime_to_AVTimestamp(time), AVSEEK_FLAG_BACKWARD);
+	avcodec_flush_buffers(_videoStream->codec);
+
+	_statistics.seekCount++;
+	_statistics.seekTime += timer.nsecsElapsed();
+}
+
+void PhVideoDecoder::storeFrame(PhFrame frame)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	PhVideoBuffer *buffer = _pool->takeFreeBuffer();
+	if(convertFrame(buffer)) {
+		buffer->setFrame(frame);
+		buffer->setTime(_currentTime);
+		_pool->insert(buffer);
+		_statistics.convertCount++;
+		_statistics.convertTime += timer.nsecsElapsed();
+		addProfilerSample(PhGraphicProfiler::VideoConvertStage, timer.nsecsElapsed());
+	}
+	else
+		_pool->recycle(buffer);
+}
+
+PhFrame PhVideoDecoder::currentFrame()
+{
+	return qRound64(static_cast<double>(_currentTime) / PhTimeCode::timePerFrame(_tcType));
+}
+
+bool PhVideoDecoder::readFrame()
+{
+	AVPacket packet;
+	QElapsedTimer timer;
+	timer.start();
+
+	while(true) {
+		int error = av_read_frame(_formatContext, &packet);
+		if(error < 0) {
+			// The decoder may still hold the last frames of the stream
+			if(readDelayedFrame()) {
+				_statistics.decodeTime += timer.nsecsElapsed();
+				addProfilerSample(PhGraphicProfiler::VideoDecodeStage, timer.nsecsElapsed());
+				return true;
+			}
+
+			char errorStr[256];
+			av_strerror(error, errorStr, 256);
+			PHDEBUG << _currentTime << "error:" << errorStr;
+			return false;
+		}
+
+		bool frameFinished = false;
+		if(packet.stream_index == _videoStream->index) {
+			int finished = 0;
+			avcodec_decode_video2(_videoStream->codec, _videoFrame, &finished, &packet);
+			// if frame decode is not finished, let's read another packet.
+			frameFinished = (finished != 0);
+		}
+		else if(_audioStream && (packet.stream_index == _audioStream->index)) {
+			int ok = 0;
+			avcodec_decode_audio4(_audioStream->codec, _audioFrame, &ok, &packet);
+			if(ok) {
+				PHDEBUG << "audio:" << _audioFrame->nb_samples;
+			}
+		}
+
+		//Avoid memory leak
+		av_free_packet(&packet);
+
+		if(frameFinished) {
+			// update the current position of the decoder
+			// (Note that it is best not to do use '_currentTime = time' here, because the seeking operation may
+			// not be 100% accurate: the actual time may be different from the requested time. So a time drift
+			// could appear.)
+			_currentTime = AVTimestamp_to_PhTime(av_frame_get_best_effort_timestamp(_videoFrame));
+			_decodeCounter.tick();
+			_decodeRate.store(_decodeCounter.frequency());
+			_statistics.decodeCount++;
+			_statistics.decodeTime += timer.nsecsElapsed();
+			addProfilerSample(PhGraphicProfiler::VideoDecodeStage, timer.nsecsElapsed());
+			return true;
+		}
+	}
+}
+
+bool PhVideoDecoder::readDelayedFrame()
+{
+	// Sending an empty packet flushes the frames delayed by the
+	// frame threading or the frame reordering.
+	AVPacket packet;
+	av_init_packet(&packet);
+	packet.data = NULL;
+	packet.size = 0;
+	packet.stream_index = _videoStream->index;
+
+	int finished = 0;
+	avcodec_decode_video2(_videoStream->codec, _videoFrame, &finished, &packet);
+	if(!finished)
+		return false;
+
+	_currentTime = AVTimestamp_to_PhTime(av_frame_get_best_effort_timestamp(_videoFrame));
+	_decodeCounter.tick();
+	_decodeRate.store(_decodeCounter.frequency());
+	_statistics.decodeCount++;
+	return true;
+}
+
+bool PhVideoDecoder::convertFrame(PhVideoBuffer *buffer)
+{
+	if(_yuvOutput && copyYUVFrame(buffer))
+		return true;
+
+	int frameHeight = _videoFrame->height;
+	if(_deinterlace)
+		frameHeight = _videoFrame->height / 2;
+
+	// As the following formats are deprecated (see https://libav.org/doxygen/master/pixfmt_8h.html#a9a8e335cf3be472042bc9f0cf80cd4c5)
+	// we replace its with the new ones recommended by LibAv
+	// in order to get ride of the warnings
+	AVPixelFormat pixFormat;
+	switch (_videoStream->codec->pix_fmt) {
+	case AV_PIX_FMT_YUVJ420P:
+		pixFormat = AV_PIX_FMT_YUV420P;
+		break;
+	case AV_PIX_FMT_YUVJ422P:
+		pixFormat = AV_PIX_FMT_YUV422P;
+		break;
+	case AV_PIX_FMT_YUVJ444P:
+		pixFormat = AV_PIX_FMT_YUV444P;
+		break;
+	case AV_PIX_FMT_YUVJ440P:
+		pixFormat = AV_PIX_FMT_YUV440P;
+		break;
+	default:
+		pixFormat = _videoStream->codec->pix_fmt;
+		break;
+	}
+
+	/* Note: we output the frames in AV_PIX_FMT_BGRA rather than AV_PIX_FMT_RGB24,
+	 * because this format is native to most video cards and will avoid a conversion
+	 * in the video driver */
+	/* sws_getCachedContext will check if the context is valid for the given parameters. It the context is not valid,
+	 * it will be freed and a new one will be allocated. */
+	_swsContext = sws_getCachedContext(_swsContext, _videoFrame->width, _videoStream->codec->height, pixFormat,
+	                                   _videoStream->codec->width, frameHeight, AV_PIX_FMT_BGRA,
+	                                   SWS_POINT, NULL, NULL, NULL);
+
+	buffer->reuse(_videoFrame->width, frameHeight);
+	uint8_t *rgb = buffer->rgb();
+	int linesize = _videoFrame->width * 4;
+	return 0 <= sws_scale(_swsContext, (const uint8_t * const *) _videoFrame->data,
+	                      _videoFrame->linesize, 0, _videoStream->codec->height, &rgb,
+	                      &linesize);
+}
+
+bool PhVideoDecoder::copyYUVFrame(PhVideoBuffer *buffer)
+{
+	int chromaShiftX, chromaShiftY, bitDepth;
+	bool fullRange = (_videoStream->codec->color_range == AVCOL_RANGE_JPEG);
+	if(!yuvLayout(_videoStream->codec->pix_fmt, chromaShiftX, chromaShiftY, bitDepth, fullRange))
+		return false;
+
+	// The deinterlacing keeps one line out of two
+	int lineStep = _deinterlace ? 2 : 1;
+	int width = _videoFrame->width;
+	int height = _videoFrame->height / lineStep;
+	int chromaWidth = (width + (1 << chromaShiftX) - 1) >> chromaShiftX;
+	int chromaHeight = (height + (1 << chromaShiftY) - 1) >> chromaShiftY;
+
+	buffer->reuseYUV(width, height, chromaWidth, chromaHeight, bitDepth);
+	buffer->setFullRange(fullRange);
+	if(_videoStream->codec->colorspace == AVCOL_SPC_UNSPECIFIED)
+		buffer->setBT709(_videoFrame->height >= 720);
+	else
+		buffer->setBT709(_videoStream->codec->colorspace == AVCOL_SPC_BT709);
+
+	for(int i = 0; i < 3; i++) {
+		int lineSize = buffer->planeWidth(i) * buffer->bytesPerSample();
+		av_image_copy_plane(buffer->plane(i), lineSize,
+		                    _videoFrame->data[i], _videoFrame->linesize[i] * lineStep,
+		                    lineSize, buffer->planeHeight(i));
+	}
+
+	return true;
+}
+
+PhTime PhVideoDecoder::frameDuration()
+{
+	return static_cast<PhTime>(24000. / this->framePerSecond());
+}
+
+int64_t PhVideoDecoder::PhTime_to_AVTimestamp(PhTime time)
+{
+	int64_t timestamp = 0;
+	if(_videoStream) {
+		timestamp = static_cast<int64_t>(std::round(static_cast<double>(time) / 24000. / av_q2d(_videoStream->time_base)));
+	}
+	return timestamp;
+}
+
+PhTime PhVideoDecoder::AVTimestamp_to_PhTime(int64_t timestamp)
+{
+	PhTime time = 0;
+	if(_videoStream) {
+		time = static_cast<PhTime>(std::round(static_cast<double>(timestamp) * av_q2d(_videoStream->time_base) * 24000.));
+	}
+	return time;
+}
@@ -0,0 +1,357 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef PHVIDEODECODER_H
+#define PHVIDEODECODER_H
+
+extern "C" {
+#ifndef INT64_C
+/** see http://code.google.com/p/ffmpegsource/issues/detail?id=11#c13 */
+#define INT64_C(c) (c ## LL)
+/** and http://code.google.com/p/ffmpegsource/issues/detail?id=11#c23 */
+#define UINT64_C(c) (c ## ULL)
+#endif
+
+#include <libavformat/avformat.h>
+#include <libavutil/avutil.h>
+#include <libavcodec/avcodec.h>
+#include <libswscale/swscale.h>
+#include <libavutil/imgutils.h>
+}
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+
+#include "PhSync/PhTimeCode.h"
+#include "PhTools/PhTickCounter.h"
+
+#include "PhVideoPool.h"
+#include "PhVideoIndex.h"
+
+/**
+ * @brief The video decoder
+ *
+ * It reads the video file, decodes and converts the requested frames
+ * and store them into a PhVideoPool.
+ *
+ * The decoder is meant to live in its own thread: all its slots are called
+ * through queued connections by the PhVideoEngine so that the decoding
+ * never happens in the render thread.
+ *
+ * The properties (size, framerate, ...) are valid once open() returned
+ * and until close() is called.
+ *
+ * Once the PhVideoIndex of the file is available, the seeks go straight to
+ * the keyframe preceding the requested frame and the decoding stops exactly
+ * on it.
+ */
+class PhVideoDecoder : public QObject
+{
+	Q_OBJECT
+public:
+	/**
+	 * @brief The frames decoded depending on the playing rate
+	 */
+	enum DecodeMode {
+		/** Every frame is decoded (normal playback and slow shuttle) */
+		DecodeAllFrames,
+		/** The non reference frames are skipped (fast shuttle) */
+		DecodeReferenceFrames,
+		/** Only the keyframes are decoded (very fast shuttle) */
+		DecodeKeyframes,
+	};
+
+	/**
+	 * @brief The threading method of the codec
+	 */
+	enum ThreadType {
+		/** Frame and slice threading, the codec picks the one it supports */
+		AutoThreading,
+		/** Several frames decoded at once (one frame of latency per thread) */
+		FrameThreading,
+		/** Several slices of a frame decoded at once */
+		SliceThreading,
+	};
+
+	/**
+	 * @brief The time spent in each decoding stage
+	 *
+	 * The durations are cumulated in nanosecond since the file was opened
+	 * or since the last call to resetStatistics().
+	 */
+	struct Statistics {
+		/** Number of seeks */
+		int seekCount;
+		/** Time spent seeking and flushing the codec */
+		qint64 seekTime;
+		/** Number of decoded pictures */
+		int decodeCount;
+		/** Time spent reading the packets and decoding the pictures */
+		qint64 decodeTime;
+		/** Number of pictures stored into the pool */
+		int convertCount;
+		/** Time spent converting or copying the pictures into the pool buffers */
+		qint64 convertTime;
+	};
+
+	/**
+	 * @brief Get the decode mode used for a given rate
+	 * @param rate A rate value
+	 * @return A decode mode value
+	 */
+	static DecodeMode decodeMode(PhRate rate);
+
+	/**
+	 * @brief PhVideoDecoder constructor
+	 * @param pool The pool where the decoded frames are stored
+	 */
+	explicit PhVideoDecoder(PhVideoPool *pool);
+
+	~PhVideoDecoder();
+
+	/**
+	 * @brief Check if a video file is opened
+	 * @return True if ready, false otherwise
+	 */
+	bool ready();
+
+	/**
+	 * @brief The video timecode type
+	 * @return A timecode type value
+	 */
+	PhTimeCodeType timeCodeType() {
+		return _tcType;
+	}
+
+	/**
+	 * @brief The starting time read from the file metadata
+	 * @return A time value or 0 if the file has no timecode information
+	 */
+	PhTime timeIn() {
+		return _timeIn;
+	}
+
+	/**
+	 * @brief Get the video length
+	 * @return A time value
+	 */
+	PhTime length();
+
+	/**
+	 * @brief Get the width
+	 * @return A value in pixel
+	 */
+	int width();
+
+	/**
+	 * @brief Get the height
+	 * @return A value in pixel
+	 */
+	int height();
+
+	/**
+	 * @brief Get average number of frame per second
+	 * @return A double value.
+	 */
+	double framePerSecond();
+
+	/**
+	 * @brief The memory taken by a decoded picture
+	 *
+	 * It depends on the output: the YUV planes are usually smaller than
+	 * the BGRA picture (see setYUVOutput()).
+	 * This method can be called from any thread.
+	 * @return A value in byte
+	 */
+	int pictureSize() {
+		return _pictureSize.load();
+	}
+
+	/**
+	 * @brief Get the codec name
+	 * @return the codec name
+	 */
+	QString codecName();
+
+	/**
+	 * @brief The number of frames decoded during the last second
+	 *
+	 * This method can be called from any thread.
+	 * @return A frequency in frame per second
+	 */
+	int decodeRate() {
+		return _decodeRate.load();
+	}
+
+	/**
+	 * @brief Check if the keyframe index of the file is available
+	 *
+	 * Until then, the seeks are less accurate (see PhVideoIndex).
+	 * @return True if ready, false otherwise
+	 */
+	bool indexReady() {
+		return _index.ready();
+	}
+
+	/**
+	 * @brief Get the duration of the longest group of pictures of the file
+	 *
+	 * This method can be called from any thread.
+	 * @return A time value (0 until the index is ready)
+	 */
+	PhTime maxKeyframeInterval() {
+		return _index.maxKeyframeInterval();
+	}
+
+	/**
+	 * @brief Wake the decoder up after the pool window changed
+	 *
+	 * This method can be called from any thread. The calls are coalesced:
+	 * the decoder only considers the latest window of the pool when it
+	 * processes the request.
+	 */
+	void requestDecoding();
+
+	/**
+	 * @brief The decoding stages statistics
+	 *
+	 * This method must be called from the decoder thread.
+	 * @return A statistics structure
+	 */
+	Statistics statistics() {
+		return _statistics;
+	}
+
+	/**
+	 * @brief Reset the decoding stages statistics
+	 *
+	 * This method must be called from the decoder thread.
+	 */
+	void resetStatistics();
+
+public slots:
+	/**
+	 * @brief Set the threading options used for the next opened file
+	 * @param threadCount A number of threads or 0 for automatic
+	 * @param threadType A threading method
+	 */
+	void setThreading(int threadCount, PhVideoDecoder::ThreadType threadType);
+
+	/**
+	 * @brief Open a video file
+	 * @param fileName A video file path
+	 * @return True if the file was opened successfully, false otherwise
+	 */
+	bool open(QString fileName);
+
+	/**
+	 * @brief Close the video file, freeing all the decoding objects
+	 */
+	void close();
+
+	/**
+	 * @brief Set the video deinterlace mode
+	 * @param deinterlace True if deinterlace false otherwise
+	 */
+	void setDeinterlace(bool deinterlace);
+
+	/**
+	 * @brief Enable or disable the planar YUV output
+	 *
+	 * When enabled (the default), the YUV pictures are stored as is in the
+	 * buffers and converted to RGB by the graphic card. The other pixel formats
+	 * are always converted to BGRA.
+	 * @param yuvOutput True to enable the YUV output
+	 */
+	void setYUVOutput(bool yuvOutput);
+
+	/**
+	 * @brief Adapt the decoding to the playing rate
+	 *
+	 * When shuttling fast, the non reference frames or all the frames but
+	 * the keyframes are skipped so that the picture keeps up with the clock.
+	 * The audio stream is also discarded.
+	 * @param rate A rate value
+	 */
+	void setRate(PhRate rate);
+
+	/**
+	 * @brief Decode a range of frames in the background
+	 *
+	 * The frames are decoded one by one when the clock is paused, between
+	 * the frame requests. The range must be pinned in the pool.
+	 * @param first The first frame
+	 * @param last The last frame
+	 */
+	void preload(PhFrame first, PhFrame last);
+
+private slots:
+	void decodeWantedFrames();
+
+private:
+	/**
+	 * @brief Decode a frame and store it into the pool
+	 *
+	 * Nothing is done if the frame is already available or if it is not
+	 * wanted anymore by the engine. The decoding is abandoned as soon as
+	 * another frame becomes more urgent (see PhVideoPool::nextMissingFrame()).
+	 *
+	 * When a seek is needed, the decoding starts from the previous keyframe
+	 * and the wanted frames decoded on the way are stored too.
+	 * @param frame A frame value relative to the beginning of the file
+	 * @return True if the frame was decoded, false otherwise
+	 */
+	bool decodeFrame(PhFrame frame);
+
+	bool decodeKeyframe(PhFrame frame, PhTime time);
+	void seekBackward(PhTime time);
+	void applyDecodeMode();
+	void updatePictureSize();
+	bool isStale(PhFrame frame);
+	bool readFrame();
+	bool readDelayedFrame();
+	void storeFrame(PhFrame frame);
+	PhFrame currentFrame();
+	bool convertFrame(PhVideoBuffer *buffer);
+	bool copyYUVFrame(PhVideoBuffer *buffer);
+	PhTime frameDuration();
+	int64_t PhTime_to_AVTimestamp(PhTime time);
+	PhTime AVTimestamp_to_PhTime(int64_t timestamp);
+
+	PhVideoPool *_pool;
+	PhTimeCodeType _tcType;
+	PhTime _timeIn;
+
+	AVFormatContext * _formatContext;
+	AVStream *_videoStream;
+	AVFrame * _videoFrame;
+	struct SwsContext * _swsContext;
+	PhTime _currentTime;
+
+	bool _useAudio;
+	AVStream *_audioStream;
+	AVFrame * _audioFrame;
+
+	bool _deinterlace;
+	bool _yuvOutput;
+
+	int _threadCount;
+	ThreadType _threadType;
+	PhRate _rate;
+	DecodeMode _decodeMode;
+	PhFrame _preloadFrame, _lastPreloadFrame;
+	QAtomicInt _decodingRequested;
+	PhTickCounter _decodeCounter;
+	QAtomicInt _decodeRate;
+	// Updated by the decoder thread when the output changes (see pictureSize())
+	QAtomicInt _pictureSize;
+	Statistics _statistics;
+
+	PhVideoIndex _index;
+};
+
+#endif // PHVIDEODECODER_H
@@ -6,6 +6,7 @@
 
 #include "PhTools/PhGeneric.h"
 #include "PhTools/PhDebug.h"
+#include "PhGraphic/PhGraphicProfiler.h"
 
 #include "PhVideoEngine.h"
 
@@ -14,36 +15,70 @@ PhVideoEngine::PhVideoEngine(PhVideoSettings *settings) :
 	_fileName(""),
 	_tcType(PhTimeCodeType25),
 	_timeIn(0),
-	_formatContext(NULL),
-	_videoStream(NULL),
-	_videoFrame(NULL),
-	_swsContext(NULL),
-	_currentTime(PHTIMEMIN),
-	_useAudio(false),
-	_audioStream(NULL),
-	_audioFrame(NULL),
-	_deinterlace(false),
-	_rgb(NULL)
+	_length(0),
+	_width(0),
+	_height(0),
+	_framePerSecond(25.00f),
+	_codecName(""),
+	_ready(false),
+	// The clock signals may come back while the engine holds it (see open())
+	_mutex(QMutex::Recursive),
+	_decoder(NULL),
+	_requestedFrame(PHFRAMEMIN),
+	_displayedFrame(PHFRAMEMIN),
+	_pinnedTimeIn(0),
+	_pinnedTimeOut(-1),
+	_firstPinnedFrame(0),
+	_lastPinnedFrame(-1),
+	_cacheCapacity(0),
+	_pictureSize(0),
+	_groupFrameCount(0),
+	_yuvDisplayed(false),
+	_decodeMode(PhVideoDecoder::DecodeAllFrames),
+	_deinterlace(false)
 {
 	PHDEBUG << "Using FFMpeg widget for video playback.";
-	av_register_all();
-	avcodec_register_all();
+
+	_decoder = new PhVideoDecoder(&_pool);
+	_decoder->moveToThread(&_decoderThread);
+	// Names the decoder track of the profiler traces
+	_decoderThread.setObjectName("decoder");
+	connect(&_decoderThread, &QThread::finished, _decoder, &QObject::deleteLater);
+	// The clock may be driven by a render thread (see PhGraphicView::startRenderThread())
+	// and from the GUI thread at the same time: the slots lock the engine mutex.
+	connect(&_clock, &PhClock::timeChanged, this, &PhVideoEngine::onTimeChanged, Qt::DirectConnection);
+	connect(&_clock, &PhClock::rateChanged, this, &PhVideoEngine::onRateChanged, Qt::DirectConnection);
+
+	_decoderThread.start();
 }
 
-bool PhVideoEngine::ready()
+PhVideoEngine::~PhVideoEngine()
 {
-	return (_formatContext && _videoStream && _videoFrame);
+	close();
+
+	_decoderThread.quit();
+	_decoderThread.wait();
 }
 
 void PhVideoEngine::setDeinterlace(bool deinterlace)
 {
 	PHDEBUG << deinterlace;
+	QMutexLocker locker(&_mutex);
 	_deinterlace = deinterlace;
-	if(_rgb) {
-		delete[] _rgb;
-		_rgb = NULL;
+
+	// Blocking so that no frame decoded with the previous mode reach the pool after the clear
+	QMetaObject::invokeMethod(_decoder, "setDeinterlace", Qt::BlockingQueuedConnection, Q_ARG(bool, deinterlace));
+	_pool.clear();
+	_displayedFrame = PHFRAMEMIN;
+	_requestedFrame = PHFRAMEMIN;
+	if(_ready) {
+		// The deinterlaced pictures are half the size: the pinned range is computed again
+		updateCacheCapacity();
+		_firstPinnedFrame = 0;
+		_lastPinnedFrame = -1;
+		setPinnedRange(_pinnedTimeIn, _pinnedTimeOut);
 	}
-	_currentTime = PHTIMEMIN;
+	requestFrames();
 }
 
 bool PhVideoEngine::bilinearFiltering()
@@ -54,347 +89,312 @@ bool PhVideoEngine::bilinearFiltering()
 void PhVideoEngine::setBilinearFiltering(bool bilinear)
 {
 	_videoRect.setBilinearFiltering(bilinear);
+	_yuvRect.setBilinearFiltering(bilinear);
 }
 
 bool PhVideoEngine::open(QString fileName)
 {
+	QMutexLocker locker(&_mutex);
 	close();
 	PHDEBUG << fileName;
 
 	_clock.setTime(0);
 	_clock.setRate(0);
-	_currentTime = PHTIMEMIN;
 
-	if(avformat_open_input(&_formatContext, fileName.toStdString().c_str(), NULL, NULL) < 0)
-		return false;
+	QMetaObject::invokeMethod(_decoder, "setThreading", Qt::BlockingQueuedConnection,
+	                          Q_ARG(int, _settings->videoDecodeThreadCount()),
+	                          Q_ARG(PhVideoDecoder::ThreadType, static_cast<PhVideoDecoder::ThreadType>(_settings->videoDecodeThreadType())));
 
-	PHDEBUG << "Retrieve stream information";
-	if (avformat_find_stream_info(_formatContext, NULL) < 0)
-		return false; // Couldn't find stream information
-
-	av_dump_format(_formatContext, 0, fileName.toStdString().c_str(), 0);
-
-	// Find video stream :
-	for(int i = 0; i < (int)_formatContext->nb_streams; i++) {
-		AVMediaType streamType = _formatContext->streams[i]->codec->codec_type;
-		PHDEBUG << i << ":" << streamType;
-		switch(streamType) {
-		case AVMEDIA_TYPE_VIDEO:
-			_videoStream = _formatContext->streams[i];
-			PHDEBUG << "\t=> video";
-			break;
-		case AVMEDIA_TYPE_AUDIO:
-			if(_useAudio && (_audioStream == NULL))
-				_audioStream = _formatContext->streams[i];
-			PHDEBUG << "\t=> audio";
-			break;
-		default:
-			PHDEBUG << "\t=> unknown";
-			break;
-		}
-	}
-
-	if(_videoStream == NULL)
+	bool result = false;
+	QMetaObject::invokeMethod(_decoder, "open", Qt::BlockingQueuedConnection,
+	                          Q_RETURN_ARG(bool, result), Q_ARG(QString, fileName));
+	if(!result)
 		return false;
 
-	// Looking for timecode type
-	_tcType = PhTimeCode::computeTimeCodeType(this->framePerSecond());
+	// The decoder is idle until the first frame is requested
+	_tcType = _decoder->timeCodeType();
 	emit timeCodeTypeChanged(_tcType);
+	_timeIn = _decoder->timeIn();
+	_length = _decoder->length();
+	_width = _decoder->width();
+	_height = _decoder->height();
+	_framePerSecond = _decoder->framePerSecond();
+	_codecName = _decoder->codecName();
+
+	// Known once the index is built (see requestFrames())
+	_groupFrameCount = 0;
+	updateCacheCapacity();
+	_fileName = fileName;
+	_ready = true;
 
-	// Reading timestamp :
-	AVDictionaryEntry *tag = av_dict_get(_formatContext->metadata, "timecode", NULL, AV_DICT_IGNORE_SUFFIX);
-	if(tag == NULL)
-		tag = av_dict_get(_videoStream->metadata, "timecode", NULL, AV_DICT_IGNORE_SUFFIX);
-
-	if(tag) {
-		PHDEBUG << "Found timestamp:" << tag->value;
-		_timeIn = PhTimeCode::timeFromString(tag->value, _tcType);
-	}
-
+	requestFrames();
+	setPinnedRange(_pinnedTimeIn, _pinnedTimeOut);
 
-	PHDEBUG << "size : " << _videoStream->codec->width << "x" << _videoStream->codec->height;
-	AVCodec * videoCodec = avcodec_find_decoder(_videoStream->codec->codec_id);
-	if(videoCodec == NULL) {
-		PHDEBUG << "Unable to find the codec:" << _videoStream->codec->codec_id;
-		return false;
-	}
+	return true;
+}
 
+void PhVideoEngine::close()
+{
+	QMutexLocker locker(&_mutex);
+	PHDEBUG << _fileName;
+	_ready = false;
 
-	if (avcodec_open2(_videoStream->codec, videoCodec, NULL) < 0) {
-		PHDEBUG << "Unable to open the codec:" << _videoStream->codec;
-		return false;
-	}
+	QMetaObject::invokeMethod(_decoder, "close", Qt::BlockingQueuedConnection);
+	_pool.clear();
+	_firstPinnedFrame = 0;
+	_lastPinnedFrame = -1;
+	_pool.setPinnedRange(_firstPinnedFrame, _lastPinnedFrame);
 
-	_videoFrame = av_frame_alloc();
+	_timeIn = 0;
+	_length = 0;
+	_width = 0;
+	_height = 0;
+	_framePerSecond = 25.00f;
+	_codecName = "";
+	_requestedFrame = PHFRAMEMIN;
+	_displayedFrame = PHFRAMEMIN;
+	PHDEBUG << _fileName << "closed";
 
-	PHDEBUG << "length:" << this->length();
-	PHDEBUG << "fps:" << this->framePerSecond();
+	_fileName = "";
+}
 
-	if(_audioStream) {
-		AVCodec* audioCodec = avcodec_find_decoder(_audioStream->codec->codec_id);
-		if(audioCodec) {
-			if(avcodec_open2(_audioStream->codec, audioCodec, NULL) < 0) {
-				PHDEBUG << "Unable to open audio codec.";
-				_audioStream = NULL;
-			}
-			else {
-				_audioFrame = av_frame_alloc();
-				PHDEBUG << "Audio OK.";
+void PhVideoEngine::drawVideo(int x, int y, int w, int h)
+{
+	QMutexLocker locker(&_mutex);
+	if(_ready) {
+		requestFrames();
+
+		PhFrame frame = clockFrame();
+		if(frame != _displayedFrame) {
+			// If the frame is not decoded yet, the previous one stays on screen
+			PhVideoBuffer *buffer = _pool.acquire(frame);
+			if(buffer) {
+				PhGraphicProfilerScope scope(PhGraphicProfiler::VideoUploadStage);
+				if(uploadBuffer(buffer)) {
+					_displayedFrame = frame;
+					_videoFrameTickCounter.tick();
+				}
+				_pool.release(buffer);
 			}
 		}
-		else {
-			PHDEBUG << "Unable to find codec for audio.";
-			_audioStream = NULL;
-		}
 	}
 
-	decodeFrame(0);
-	_fileName = fileName;
-
-	return true;
+	if(_yuvDisplayed) {
+		_yuvRect.setRect(x, y, w, h);
+		_yuvRect.setZ(-10);
+		_yuvRect.draw();
+	}
+	else {
+		_videoRect.setRect(x, y, w, h);
+		_videoRect.setZ(-10);
+		_videoRect.draw();
+	}
 }
 
-void PhVideoEngine::close()
+bool PhVideoEngine::waitForFrame(int timeout)
 {
-	PHDEBUG << _fileName;
-	if(_rgb) {
-		delete[] _rgb;
-		_rgb = NULL;
+	PhFrame frame;
+	{
+		QMutexLocker locker(&_mutex);
+		if(!_ready)
+			return false;
+
+		requestFrames();
+		frame = clockFrame();
 	}
 
-	if (_swsContext) {
-		sws_freeContext(_swsContext);
-		_swsContext = NULL;
+	QElapsedTimer timer;
+	timer.start();
+	while(!_pool.contains(frame)) {
+		if(timer.elapsed() > timeout) {
+			PHDEBUG << "Timeout waiting for" << frame;
+			return false;
+		}
+		QThread::msleep(1);
 	}
+	return true;
+}
 
-	if(_formatContext) {
-		PHDEBUG << "Close the media context.";
-		if(_videoStream)
-			avcodec_close(_videoStream->codec);
-		if(_audioStream)
-			avcodec_close(_audioStream->codec);
-		avformat_close_input(&_formatContext);
+bool PhVideoEngine::uploadBuffer(PhVideoBuffer *buffer)
+{
+	if(buffer->format() == PhVideoBuffer::BGRA) {
+		_yuvDisplayed = false;
+		return _videoRect.createTextureFromBGRABuffer(buffer->rgb(), buffer->width(), buffer->height());
 	}
 
-	if (_videoFrame) {
-		av_frame_free(&_videoFrame);
-		_videoFrame = NULL;
+	_yuvRect.setBT709(buffer->bt709());
+	_yuvRect.setFullRange(buffer->fullRange());
+	if(_yuvRect.createTextureFromYUVPlanes(buffer->plane(0), buffer->plane(1), buffer->plane(2),
+	                                       buffer->width(), buffer->height(),
+	                                       buffer->planeWidth(1), buffer->planeHeight(1),
+	                                       buffer->bitDepth())) {
+		_yuvDisplayed = true;
+		return true;
 	}
 
-	_timeIn = 0;
-	_formatContext = NULL;
-	_videoStream = NULL;
-	_audioStream = NULL;
-	PHDEBUG << _fileName << "closed";
-
-	_fileName = "";
+	// Fallback to the conversion on the CPU if the shader is not supported
+	PHDEBUG << "Disabling the YUV output";
+	QMetaObject::invokeMethod(_decoder, "setYUVOutput", Qt::BlockingQueuedConnection, Q_ARG(bool, false));
+	_pool.clear();
+	_requestedFrame = PHFRAMEMIN;
+	// The BGRA pictures are bigger: the pinned range may have to be truncated
+	updateCacheCapacity();
+	_firstPinnedFrame = 0;
+	_lastPinnedFrame = -1;
+	setPinnedRange(_pinnedTimeIn, _pinnedTimeOut);
+	return false;
 }
 
-void PhVideoEngine::drawVideo(int x, int y, int w, int h)
+void PhVideoEngine::setPinnedRange(PhTime timeIn, PhTime timeOut)
 {
-	if(_videoStream) {
-		PhTime delay = static_cast<PhTime>(_settings->screenDelay() * _clock.rate() * 24000.);
-		decodeFrame(_clock.time() + delay);
+	QMutexLocker locker(&_mutex);
+	_pinnedTimeIn = timeIn;
+	_pinnedTimeOut = timeOut;
+	if(!_ready)
+		return;
+
+	PhTime timePerFrame = PhTimeCode::timePerFrame(_tcType);
+	PhFrame lastFrame = (_length - 1) / timePerFrame;
+	PhFrame first = 0;
+	PhFrame last = -1;
+	if(timeOut > timeIn) {
+		first = qBound(PhFrame(0), (timeIn - _timeIn) / timePerFrame, lastFrame);
+		last = qBound(PhFrame(0), (timeOut - _timeIn) / timePerFrame - 1, lastFrame);
+		if(last - first + 1 > _cacheCapacity) {
+			PHDEBUG << "The cache only holds" << _cacheCapacity << "of the" << last - first + 1
+			        << "frames of the range: increase the video cache size to"
+			        << (last - first + 1) * _pictureSize / (1024 * 1024) + 1 << "MB";
+			last = first + _cacheCapacity - 1;
+		}
 	}
-	_videoRect.setRect(x, y, w, h);
-	_videoRect.setZ(-10);
-	_videoRect.draw();
-}
 
-void PhVideoEngine::setTimeIn(PhTime timeIn)
-{
-	PHDEBUG << timeIn;
-	_timeIn = timeIn;
+	if((first == _firstPinnedFrame) && (last == _lastPinnedFrame))
+		return;
+
+	PHDEBUG << first << last;
+	_firstPinnedFrame = first;
+	_lastPinnedFrame = last;
+	_pool.setPinnedRange(first, last);
+	preloadPinnedFrames();
 }
 
-PhTime PhVideoEngine::length()
+void PhVideoEngine::updateCacheCapacity()
 {
-	if(_videoStream)
-		return AVTimestamp_to_PhTime(_videoStream->duration);
-	return 0;
+	// The decoded pictures are YUV planes, or BGRA if the shader is not supported
+	_pictureSize = _decoder->pictureSize();
+	_cacheCapacity = 0;
+	if(_pictureSize > 0)
+		_cacheCapacity = static_cast<int>(_settings->videoCacheSize() * 1024LL * 1024LL / _pictureSize);
+	PHDEBUG << "cache:" << _cacheCapacity << "frames of" << _pictureSize << "bytes";
+
+	// Playing backward decodes each group of pictures once if the pool holds it entirely
+	int poolSize = qMax(_settings->videoPoolSize(), _settings->videoReadhead() + 1);
+	if(_groupFrameCount > poolSize) {
+		PHDEBUG << "Raising the pool size from" << poolSize << "to" << _groupFrameCount << "frames for the groups of pictures";
+		poolSize = _groupFrameCount;
+	}
+	_pool.setCapacity(poolSize + _cacheCapacity);
 }
 
-PhVideoEngine::~PhVideoEngine()
+void PhVideoEngine::preloadPinnedFrames()
 {
-	close();
+	if(_lastPinnedFrame >= _firstPinnedFrame)
+		QMetaObject::invokeMethod(_decoder, "preload", Qt::QueuedConnection,
+		                          Q_ARG(PhFrame, _firstPinnedFrame), Q_ARG(PhFrame, _lastPinnedFrame));
 }
 
-int PhVideoEngine::width()
+void PhVideoEngine::setTimeIn(PhTime timeIn)
 {
-	if(_videoStream)
-		return _videoStream->codec->width;
-	return 0;
+	PHDEBUG << timeIn;
+	QMutexLocker locker(&_mutex);
+	_timeIn = timeIn;
+	requestFrames();
 }
 
-int PhVideoEngine::height()
+void PhVideoEngine::onTimeChanged(PhTime)
 {
-	if(_videoStream)
-		return _videoStream->codec->height;
-	return 0;
+	QMutexLocker locker(&_mutex);
+	requestFrames();
 }
 
-double PhVideoEngine::framePerSecond()
+void PhVideoEngine::onRateChanged(PhRate rate)
 {
-	// default is 25 fps.
-	// It will be used when loading a collection of image files (as it is done in the tests and specs),
-	// where ffmpeg framerate is undefined (avg_frame_rate.den is 0).
-	double result = 25.00f;
-
-	if(_videoStream && (_videoStream->avg_frame_rate.den != 0)) {
-		result =  av_q2d(_videoStream->avg_frame_rate);
+	QMutexLocker locker(&_mutex);
+	PhVideoDecoder::DecodeMode mode = PhVideoDecoder::decodeMode(rate);
+	if(mode == _decodeMode) {
+		QMetaObject::invokeMethod(_decoder, "setRate", Qt::QueuedConnection, Q_ARG(PhRate, rate));
+		return;
 	}
 
-	return result;
-}
-
-QString PhVideoEngine::codecName()
-{
-	if(_videoStream)
-		return _videoStream->codec->codec_descriptor->long_name;
+	// Blocking so that no skipped frames decoding is pending when clearing the pool
+	QMetaObject::invokeMethod(_decoder, "setRate", Qt::BlockingQueuedConnection, Q_ARG(PhRate, rate));
 
-	return "";
+	// The pictures stored while shuttling are approximations of the requested frames
+	if(_decodeMode != PhVideoDecoder::DecodeAllFrames) {
+		_pool.clear();
+		_displayedFrame = PHFRAMEMIN;
+		preloadPinnedFrames();
+	}
+	_decodeMode = mode;
+	_requestedFrame = PHFRAMEMIN;
+	requestFrames();
 }
 
-bool PhVideoEngine::decodeFrame(PhTime time)
+PhFrame PhVideoEngine::clockFrame()
 {
-	if(!ready()) {
-		PHDEBUG << "not ready";
-		return false;
-	}
+	PhTime delay = static_cast<PhTime>(_settings->screenDelay() * _clock.rate() * 24000.);
+	PhTime time = _clock.time() + delay - _timeIn;
+	PhTime timePerFrame = PhTimeCode::timePerFrame(_tcType);
 
-	if(time < _timeIn)
-		time = _timeIn;
-	if (time >= this->timeOut())
-		time = this->timeOut();
+	if(time >= _length)
+		time = _length - timePerFrame;
+	if(time < 0)
+		time = 0;
 
-	bool result = false;
-
-	// Stay with the same frame if the time has changed less than the time between two frames
-	// Note that av_seek_frame will seek to the _closest_ frame, sometimes a little bit in the "future",
-	// so it is necessary to use a little margin for the second comparison, otherwise a seek may
-	// be performed on each call to decodeFrame
-	if ((time < _currentTime + PhTimeCode::timePerFrame(_tcType))
-	    && (time > _currentTime - PhTimeCode::timePerFrame(_tcType)/2))
-		result = true;
-	else {
-		// we need to perform a frame seek if the requested frame is not the next frame in the stream
-		if((time >= _currentTime + 2*PhTimeCode::timePerFrame(_tcType))
-		   || (time < _currentTime)) {
-			int flags = AVSEEK_FLAG_ANY;
-			int64_t timestamp = PhTime_to_AVTimestamp(time - _timeIn);
-			PHDEBUG << "seek:" << time << " " << _currentTime << " " << _timeIn << " " << timestamp;
-			av_seek_frame(_formatContext, _videoStream->index, timestamp, flags);
-		}
-
-		AVPacket packet;
-
-		bool lookingForVideoFrame = true;
-		while(lookingForVideoFrame) {
-			int error = av_read_frame(_formatContext, &packet);
-			switch(error) {
-			case 0:
-				if(packet.stream_index == _videoStream->index) {
-					int frameFinished = 0;
-					avcodec_decode_video2(_videoStream->codec, _videoFrame, &frameFinished, &packet);
-					if(frameFinished) {
-
-						int frameHeight = _videoFrame->height;
-						if(_deinterlace)
-							frameHeight = _videoFrame->height / 2;
-
-						// As the following formats are deprecated (see https://libav.org/doxygen/master/pixfmt_8h.html#a9a8e335cf3be472042bc9f0cf80cd4c5)
-						// we replace its with the new ones recommended by LibAv
-						// in order to get ride of the warnings
-						AVPixelFormat pixFormat;
-						switch (_videoStream->codec->pix_fmt) {
-						case AV_PIX_FMT_YUVJ420P:
-							pixFormat = AV_PIX_FMT_YUV420P;
-							break;
-						case AV_PIX_FMT_YUVJ422P:
-							pixFormat = AV_PIX_FMT_YUV422P;
-							break;
-						case AV_PIX_FMT_YUVJ444P:
-							pixFormat = AV_PIX_FMT_YUV444P;
-							break;
-						case AV_PIX_FMT_YUVJ440P:
-							pixFormat = AV_PIX_FMT_YUV440P;
-						default:
-							pixFormat = _videoStream->codec->pix_fmt;
-							break;
-						}
-						/* Note: we output the frames in AV_PIX_FMT_BGRA rather than AV_PIX_FMT_RGB24,
-						 * because this format is native to most video cards and will avoid a conversion
-						 * in the video driver */
-						/* sws_getCachedContext will check if the context is valid for the given parameters. It the context is not valid,
-						 * it will be freed and a new one will be allocated. */
-						_swsContext = sws_getCachedContext(_swsContext, _videoFrame->width, _videoStream->codec->height, pixFormat,
-						                                   _videoStream->codec->width, frameHeight, AV_PIX_FMT_BGRA,
-						                                   SWS_POINT, NULL, NULL, NULL);
-
-						if(_rgb == NULL)
-							_rgb = new uint8_t[avpicture_get_size(AV_PIX_FMT_BGRA, _videoFrame->width, frameHeight)];
-						int linesize = _videoFrame->width * 4;
-						if (0 <= sws_scale(_swsContext, (const uint8_t * const *) _videoFrame->data,
-						                   _videoFrame->linesize, 0, _videoStream->codec->height, &_rgb,
-						                   &linesize)) {
-
-							_videoRect.createTextureFromBGRABuffer(_rgb, _videoFrame->width, frameHeight);
-
-
-							_videoFrameTickCounter.tick();
-							result = true;
-						}
-						lookingForVideoFrame = false;
-					} // if frame decode is not finished, let's read another packet.
-				}
-				else if(_audioStream && (packet.stream_index == _audioStream->index)) {
-					int ok = 0;
-					avcodec_decode_audio4(_audioStream->codec, _audioFrame, &ok, &packet);
-					if(ok) {
-						PHDEBUG << "audio:" << _audioFrame->nb_samples;
-					}
-				}
-				break;
-			case AVERROR_INVALIDDATA:
-			case AVERROR_EOF:
-			default:
-				{
-					char errorStr[256];
-					av_strerror(error, errorStr, 256);
-					PHDEBUG << time << "error:" << errorStr;
-					lookingForVideoFrame = false;
-					break;
-				}
-			}
-
-			// update the current position of the engine
-			// (Note that it is best not to do use '_currentTime = time' here, because the seeking operation may
-			// not be 100% accurate: the actual time may be different from the requested time. So a time drift
-			// could appear.)
-			_currentTime = _timeIn + AVTimestamp_to_PhTime(av_frame_get_best_effort_timestamp(_videoFrame));
-
-			//Avoid memory leak
-			av_free_packet(&packet);
-		}
-	}
-
-	return result;
+	return time / timePerFrame;
 }
 
-int64_t PhVideoEngine::PhTime_to_AVTimestamp(PhTime time)
+void PhVideoEngine::requestFrames()
 {
-	int64_t timestamp = 0;
-	if(_videoStream) {
-		timestamp = static_cast<int64_t>(std::round(static_cast<double>(time) / 24000. / av_q2d(_videoStream->time_base)));
+	if(!_ready)
+		return;
+
+	PhFrame frame = clockFrame();
+	if(frame == _requestedFrame)
+		return;
+	_requestedFrame = frame;
+
+	// The index provides the length of the groups of pictures once built
+	PhTime timePerFrame = PhTimeCode::timePerFrame(_tcType);
+	int groupFrameCount = static_cast<int>((_decoder->maxKeyframeInterval() + timePerFrame - 1) / timePerFrame) + 1;
+	if(groupFrameCount != _groupFrameCount) {
+		_groupFrameCount = groupFrameCount;
+		updateCacheCapacity();
 	}
-	return timestamp;
-}
 
-PhTime PhVideoEngine::AVTimestamp_to_PhTime(int64_t timestamp)
-{
-	PhTime time = 0;
-	if(_videoStream) {
-		time = static_cast<PhTime>(std::round(static_cast<double>(timestamp) * av_q2d(_videoStream->time_base) * 24000.));
+	int readhead = _settings->videoReadhead();
+	int capacity = _pool.capacity();
+
+	// When shuttling fast, the decoder skips frames so only the current one is requested
+	if(_decodeMode != PhVideoDecoder::DecodeAllFrames) {
+		_pool.setWindow(frame, frame, frame, frame);
+		_decoder->requestDecoding();
+		return;
 	}
-	return time;
+
+	PhFrame lastFrame = (_length - 1) / timePerFrame;
+
+	// The frames preceding the playhead are kept when playing backward
+	// or when paused (the operator often steps back and forth over a line).
+	// The current frame is decoded first, then the following ones in the playing direction.
+	// The window replaces the previous one: the decoder drops what the engine doesn't need anymore.
+	if(_clock.rate() > 0)
+		_pool.setWindow(frame, frame, frame + readhead, qMin(frame + readhead, lastFrame));
+	else if(_clock.rate() < 0)
+		_pool.setWindow(frame, frame - capacity + 1, frame, qMax(frame - readhead, static_cast<PhFrame>(0)));
+	else
+		_pool.setWindow(frame, frame - (capacity - readhead) / 2, frame + readhead, qMin(frame + readhead, lastFrame));
+
+	PHDBG(25) << frame;
+	_decoder->requestDecoding();
 }
@@ -7,30 +7,31 @@
 #ifndef PHVIDEOENGINE_H
 #define PHVIDEOENGINE_H
 
-extern "C" {
-#ifndef INT64_C
-/** see http://code.google.com/p/ffmpegsource/issues/detail?id=11#c13 */
-#define INT64_C(c) (c ## LL)
-/** and http://code.google.com/p/ffmpegsource/issues/detail?id=11#c23 */
-#define UINT64_C(c) (c ## ULL)
-#endif
-
-#include <libavformat/avformat.h>
-#include <libavutil/avutil.h>
-#include <libavcodec/avcodec.h>
-#include <libswscale/swscale.h>
-}
+#include <QThread>
+#include <QMutex>
 
 #include "PhSync/PhClock.h"
 #include "PhTools/PhTickCounter.h"
 #include "PhGraphic/PhGraphicTexturedRect.h"
+#include "PhGraphic/PhGraphicYUVRect.h"
 
 #include "PhVideoSettings.h"
+#include "PhVideoPool.h"
+#include "PhVideoDecoder.h"
 
 /**
  * @brief The video engine
  *
  * It provide engine which compute the video from a file to an openGL texture.
+ *
+ * The decoding is performed by a PhVideoDecoder running in a separate thread.
+ * Each time the clock changes, the engine requests the frame matching
+ * the clock and the following ones (see PhVideoSettings::videoReadhead())
+ * so that drawVideo() only has to upload an already decoded picture.
+ *
+ * The clock may be changed from the GUI thread while drawVideo() is called
+ * from a render thread (see PhGraphicView::startRenderThread()): the frame
+ * requests are serialized by a mutex of the engine.
  */
 class PhVideoEngine : public QObject
 {
@@ -95,28 +96,38 @@ public:
 	 * @brief Get the video length
 	 * @return A time value
 	 */
-	PhTime length();
+	PhTime length() {
+		return _length;
+	}
 
 	/**
 	 * @brief Get the codec name
 	 * @return the codec name
 	 */
-	QString codecName();
+	QString codecName() {
+		return _codecName;
+	}
 	/**
 	 * @brief Get the width
 	 * @return the PhVideoEngine width (not necessary the video width)
 	 */
-	int width();
+	int width() {
+		return _width;
+	}
 	/**
 	 * @brief Get the height
 	 * @return the PhVideoEngine height (not necessary the video height)
 	 */
-	int height();
+	int height() {
+		return _height;
+	}
 	/**
 	 * @brief Get average number of frame per second
 	 * @return A double value.
 	 */
-	double framePerSecond();
+	double framePerSecond() {
+		return _framePerSecond;
+	}
 	/**
 	 * @brief Get refreshRate
 	 * @return Return the refresh rate of the PhVideoEngine
@@ -125,6 +136,14 @@ public:
 		return _videoFrameTickCounter.frequency();
 	}
 
+	/**
+	 * @brief Get the decoding rate
+	 * @return The number of frames decoded during the last second
+	 */
+	int decodeRate() {
+		return _decoder->decodeRate();
+	}
+
 	// Methods
 	/**
 	 * @brief Open a video file
@@ -142,7 +161,9 @@ public:
 	 * @brief Prompt if the PhVideoEngine is ready
 	 * @return True if the PhVideoEngine is ready, false otherwise
 	 */
-	bool ready();
+	bool ready() {
+		return _ready;
+	}
 
 	/**
 	 * @brief Check if video shall be deinterlace
@@ -171,6 +192,18 @@ public:
 	 */
 	void setBilinearFiltering(bool bilinear);
 
+	/**
+	 * @brief Keep the frames of a time range in memory
+	 *
+	 * The frames are decoded in the background when the clock is paused and
+	 * kept in the cache (see PhVideoSettings::videoCacheSize()) so that going
+	 * back to the beginning of the range doesn't need any decoding.
+	 * The range is truncated if it doesn't fit in the cache.
+	 * @param timeIn The range starting time
+	 * @param timeOut The range ending time (lower than timeIn to unpin)
+	 */
+	void setPinnedRange(PhTime timeIn, PhTime timeOut);
+
 	/**
 	 * @brief draw the video depending on the parameters
 	 * @param x coordinates of the upperleft corner
@@ -180,6 +213,16 @@ public:
 	 */
 	void drawVideo(int x, int y, int w, int h);
 
+	/**
+	 * @brief Wait until the frame corresponding to the clock is decoded
+	 *
+	 * The next drawVideo() is then guaranteed to display it. This is intended
+	 * for the offscreen rendering where no refresh loop gives the decoder time.
+	 * @param timeout The maximum waiting duration in millisecond
+	 * @return True if the frame is available
+	 */
+	bool waitForFrame(int timeout = 1000);
+
 signals:
 	/**
 	 * @brief Signal sent upon a different timecode type message
@@ -187,33 +230,50 @@ signals:
 	 */
 	void timeCodeTypeChanged(PhTimeCodeType tcType);
 
+private slots:
+	void onTimeChanged(PhTime time);
+	void onRateChanged(PhRate rate);
+
 private:
-	bool decodeFrame(PhTime time);
-	int64_t PhTime_to_AVTimestamp(PhTime time);
-	PhTime AVTimestamp_to_PhTime(int64_t timestamp);
+	PhFrame clockFrame();
+	void requestFrames();
+	bool uploadBuffer(PhVideoBuffer *buffer);
+	void updateCacheCapacity();
+	void preloadPinnedFrames();
 
 	PhVideoSettings *_settings;
 	QString _fileName;
 	PhTimeCodeType _tcType;
 	PhClock _clock;
 	PhTime _timeIn;
+	PhTime _length;
+	int _width, _height;
+	double _framePerSecond;
+	QString _codecName;
+	bool _ready;
 
-	AVFormatContext * _formatContext;
-	AVStream *_videoStream;
-	AVFrame * _videoFrame;
-	struct SwsContext * _swsContext;
-	PhGraphicTexturedRect _videoRect;
-	PhTime _currentTime;
+	// Guards the request and cache state below
+	QMutex _mutex;
+	QThread _decoderThread;
+	PhVideoPool _pool;
+	PhVideoDecoder *_decoder;
+	PhFrame _requestedFrame;
+	PhFrame _displayedFrame;
+	PhTime _pinnedTimeIn, _pinnedTimeOut;
+	PhFrame _firstPinnedFrame, _lastPinnedFrame;
+	int _cacheCapacity;
+	// The memory taken by a decoded picture (in byte)
+	int _pictureSize;
+	// The frame count of the longest group of pictures
+	int _groupFrameCount;
 
+	PhGraphicTexturedRect _videoRect;
+	PhGraphicYUVRect _yuvRect;
+	bool _yuvDisplayed;
+	PhVideoDecoder::DecodeMode _decodeMode;
 	PhTickCounter _videoFrameTickCounter;
 
-	bool _useAudio;
-	AVStream *_audioStream;
-	AVFrame * _audioFrame;
-
 	bool _deinterlace;
-
-	uint8_t * _rgb;
 };
 
 #endif // PHVIDEOENGINE_H
@@ -0,0 +1,267 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+extern "C" {
+#ifndef INT64_C
+/** see http://code.google.com/p/ffmpegsource/issues/detail?id=11#c13 */
+#define INT64_C(c) (c ## LL)
+/** and http://code.google.com/p/ffmpegsource/issues/detail?id=11#c23 */
+#define UINT64_C(c) (c ## ULL)
+#endif
+
+#include <libavformat/avformat.h>
+}
+
+#include <QFileInfo>
+#include <QTime>
+#include <QDateTime>
+#include <QDir>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+
+#include "PhTools/PhGeneric.h"
+#include "PhTools/PhDebug.h"
+
+#include "PhVideoIndex.h"
+
+/** Magic number identifying the index cache files */
+#define PHVIDEOINDEX_MAGIC 0x50685649
+/** Version of the index cache files */
+#define PHVIDEOINDEX_VERSION 1
+
+PhVideoIndex::PhVideoIndex() :
+	_fileSize(0),
+	_fileDate(0),
+	_ready(false),
+	_abort(0),
+	_maxKeyframeInterval(0)
+{
+	av_register_all();
+}
+
+PhVideoIndex::~PhVideoIndex()
+{
+	clear();
+}
+
+void PhVideoIndex::build(QString fileName)
+{
+	clear();
+
+	_fileName = fileName;
+	QFileInfo info(fileName);
+	_fileSize = info.size();
+	_fileDate = info.lastModified().toMSecsSinceEpoch();
+
+	// Image sequences (such as "image_%03d.bmp") are not cached
+	if(info.exists() && load()) {
+		PHDEBUG << "Index loaded from" << cacheFileName(fileName);
+		return;
+	}
+
+	this->start(QThread::LowPriority);
+}
+
+void PhVideoIndex::clear()
+{
+	_abort.store(1);
+	this->wait();
+	_abort.store(0);
+
+	QMutexLocker locker(&_mutex);
+	_ready = false;
+	_frameTimes.clear();
+	_keyframeTimes.clear();
+	_maxKeyframeInterval = 0;
+}
+
+bool PhVideoIndex::ready()
+{
+	QMutexLocker locker(&_mutex);
+	return _ready;
+}
+
+int PhVideoIndex::frameCount()
+{
+	QMutexLocker locker(&_mutex);
+	return _frameTimes.count();
+}
+
+PhTime PhVideoIndex::frameTime(PhTime time)
+{
+	QMutexLocker locker(&_mutex);
+	return lookup(_frameTimes, time);
+}
+
+PhTime PhVideoIndex::keyframeTime(PhTime time)
+{
+	QMutexLocker locker(&_mutex);
+	return lookup(_keyframeTimes, time);
+}
+
+PhTime PhVideoIndex::maxKeyframeInterval()
+{
+	QMutexLocker locker(&_mutex);
+	return _maxKeyframeInterval;
+}
+
+QString PhVideoIndex::cacheFileName(QString fileName)
+{
+	QString path = QFileInfo(fileName).absoluteFilePath();
+	QString hash = QCryptographicHash::hash(path.toUtf8(), QCryptographicHash::Md5).toHex();
+	return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/index/" + hash + ".phindex";
+}
+
+void PhVideoIndex::run()
+{
+	PHDEBUG << "Building the index of" << _fileName;
+	QTime timer;
+	timer.start();
+
+	AVFormatContext *formatContext = NULL;
+	if(avformat_open_input(&formatContext, _fileName.toStdString().c_str(), NULL, NULL) < 0)
+		return;
+
+	if(avformat_find_stream_info(formatContext, NULL) < 0) {
+		avformat_close_input(&formatContext);
+		return;
+	}
+
+	AVStream *videoStream = NULL;
+	for(int i = 0; i < (int)formatContext->nb_streams; i++) {
+		if(formatContext->streams[i]->codec->codec_type == AVMEDIA_TYPE_VIDEO)
+			videoStream = formatContext->streams[i];
+		else
+			formatContext->streams[i]->discard = AVDISCARD_ALL;
+	}
+
+	if(videoStream == NULL) {
+		avformat_close_input(&formatContext);
+		return;
+	}
+
+	double timeBase = av_q2d(videoStream->time_base) * 24000.;
+	QVector<PhTime> frameTimes, keyframeTimes;
+
+	AVPacket packet;
+	int64_t lastTimestamp = AV_NOPTS_VALUE;
+	while(!_abort.load() && (av_read_frame(formatContext, &packet) >= 0)) {
+		if(packet.stream_index == videoStream->index) {
+			int64_t timestamp = (packet.pts != AV_NOPTS_VALUE) ? packet.pts : packet.dts;
+			// A packet without any timestamp follows the previous one
+			if((timestamp == AV_NOPTS_VALUE) && (lastTimestamp != AV_NOPTS_VALUE) && (packet.duration > 0))
+				timestamp = lastTimestamp + packet.duration;
+			if(timestamp == AV_NOPTS_VALUE) {
+				av_free_packet(&packet);
+				continue;
+			}
+			lastTimestamp = timestamp;
+			PhTime time = static_cast<PhTime>(std::round(timestamp * timeBase));
+			frameTimes.append(time);
+			if(packet.flags & AV_PKT_FLAG_KEY)
+				keyframeTimes.append(time);
+		}
+		av_free_packet(&packet);
+	}
+
+	avformat_close_input(&formatContext);
+
+	if(_abort.load())
+		return;
+
+	// The packets are stored in decoding order
+	qSort(frameTimes);
+	qSort(keyframeTimes);
+
+	PHDEBUG << frameTimes.count() << "frames and" << keyframeTimes.count() << "keyframes indexed in" << timer.elapsed() << "ms";
+
+	{
+		QMutexLocker locker(&_mutex);
+		_frameTimes = frameTimes;
+		_keyframeTimes = keyframeTimes;
+		_maxKeyframeInterval = maxInterval(frameTimes, keyframeTimes);
+		_ready = true;
+	}
+
+	if(QFileInfo(_fileName).exists())
+		save();
+}
+
+bool PhVideoIndex::load()
+{
+	QFile file(cacheFileName(_fileName));
+	if(!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream stream(&file);
+	quint32 magic, version;
+	qint64 fileSize, fileDate;
+	stream >> magic >> version >> fileSize >> fileDate;
+	if((magic != PHVIDEOINDEX_MAGIC) || (version != PHVIDEOINDEX_VERSION)) {
+		PHDEBUG << "Bad index file:" << file.fileName();
+		return false;
+	}
+
+	if((fileSize != _fileSize) || (fileDate != _fileDate)) {
+		PHDEBUG << "The index is outdated";
+		return false;
+	}
+
+	QVector<PhTime> frameTimes, keyframeTimes;
+	stream >> frameTimes >> keyframeTimes;
+	if(stream.status() != QDataStream::Ok)
+		return false;
+
+	QMutexLocker locker(&_mutex);
+	_frameTimes = frameTimes;
+	_keyframeTimes = keyframeTimes;
+	_maxKeyframeInterval = maxInterval(frameTimes, keyframeTimes);
+	_ready = true;
+
+	return true;
+}
+
+void PhVideoIndex::save()
+{
+	QString fileName = cacheFileName(_fileName);
+	QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+	QFile file(fileName);
+	if(!file.open(QIODevice::WriteOnly)) {
+		PHDEBUG << "Unable to write" << fileName;
+		return;
+	}
+
+	QDataStream stream(&file);
+	QMutexLocker locker(&_mutex);
+	stream << (quint32)PHVIDEOINDEX_MAGIC << (quint32)PHVIDEOINDEX_VERSION << _fileSize << _fileDate;
+	stream << _frameTimes << _keyframeTimes;
+}
+
+PhTime PhVideoIndex::lookup(const QVector<PhTime> &times, PhTime time)
+{
+	if(times.isEmpty())
+		return 0;
+
+	// First element strictly after the time
+	QVector<PhTime>::const_iterator it = qUpperBound(times.begin(), times.end(), time);
+	if(it == times.begin())
+		return *it;
+	return *(it - 1);
+}
+
+PhTime PhVideoIndex::maxInterval(const QVector<PhTime> &frameTimes, const QVector<PhTime> &keyframeTimes)
+{
+	if(frameTimes.isEmpty() || keyframeTimes.isEmpty())
+		return 0;
+
+	PhTime result = 0;
+	for(int i = 1; i < keyframeTimes.count(); i++)
+		result = qMax(result, keyframeTimes[i] - keyframeTimes[i - 1]);
+	// The last group of pictures ends with the last frame
+	return qMax(result, frameTimes.last() - keyframeTimes.last());
+}
@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef PHVIDEOINDEX_H
+#define PHVIDEOINDEX_H
+
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QVector>
+
+#include "PhSync/PhTime.h"
+
+/**
+ * @brief The timestamp and keyframe index of a video file
+ *
+ * The index is built by reading the packets of the video stream (without
+ * decoding them) in a separate thread. Once built it is saved in the cache
+ * directory and reused as long as the size and the modification date of the
+ * video file don't change.
+ *
+ * The times are relative to the beginning of the file, as the ones
+ * used by the PhVideoDecoder.
+ */
+class PhVideoIndex : public QThread
+{
+	Q_OBJECT
+public:
+	/**
+	 * @brief PhVideoIndex constructor
+	 */
+	PhVideoIndex();
+
+	~PhVideoIndex();
+
+	/**
+	 * @brief Load the index from the cache or start building it
+	 * @param fileName A video file path
+	 */
+	void build(QString fileName);
+
+	/**
+	 * @brief Stop the building and clear the index
+	 */
+	void clear();
+
+	/**
+	 * @brief Check if the index is available
+	 * @return True if the index is complete
+	 */
+	bool ready();
+
+	/**
+	 * @brief The number of frames of the video stream
+	 * @return An integer value
+	 */
+	int frameCount();
+
+	/**
+	 * @brief Get the time of the frame displayed at a given time
+	 * @param time A time value
+	 * @return The time of the last frame starting before or at the given time
+	 */
+	PhTime frameTime(PhTime time);
+
+	/**
+	 * @brief Get the time of the keyframe needed to decode a given time
+	 * @param time A time value
+	 * @return The time of the last keyframe starting before or at the given time
+	 */
+	PhTime keyframeTime(PhTime time);
+
+	/**
+	 * @brief Get the duration of the longest group of pictures
+	 *
+	 * Decoding any frame of the file requires at most this duration of
+	 * frames to be decoded from the previous keyframe.
+	 * @return A time value (0 if the index is not ready)
+	 */
+	PhTime maxKeyframeInterval();
+
+	/**
+	 * @brief Get the cache file path for a video file
+	 * @param fileName A video file path
+	 * @return A file path
+	 */
+	static QString cacheFileName(QString fileName);
+
+protected:
+	/**
+	 * @brief Scan the packets of the video file
+	 */
+	void run();
+
+private:
+	bool load();
+	void save();
+	PhTime lookup(const QVector<PhTime> &times, PhTime time);
+	static PhTime maxInterval(const QVector<PhTime> &frameTimes, const QVector<PhTime> &keyframeTimes);
+
+	QMutex _mutex;
+	QString _fileName;
+	qint64 _fileSize;
+	qint64 _fileDate;
+	bool _ready;
+	QAtomicInt _abort;
+
+	QVector<PhTime> _frameTimes;
+	QVector<PhTime> _keyframeTimes;
+	PhTime _maxKeyframeInterval;
+};
+
+#endif // PHVIDEOINDEX_H
@@ -0,0 +1,218 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include "PhTools/PhDebug.h"
+
+#include "PhVideoPool.h"
+
+PhVideoPool::PhVideoPool(int capacity) :
+	_capacity(capacity),
+	_generation(0),
+	_playhead(0),
+	_firstWanted(PHFRAMEMIN),
+	_lastWanted(PHFRAMEMAX),
+	_lastRequested(PHFRAMEMIN),
+	_firstPinned(0),
+	_lastPinned(-1),
+	_useCounter(0)
+{
+}
+
+PhVideoPool::~PhVideoPool()
+{
+	qDeleteAll(_buffers);
+}
+
+int PhVideoPool::capacity()
+{
+	QMutexLocker locker(&_mutex);
+	return _capacity;
+}
+
+void PhVideoPool::setCapacity(int capacity)
+{
+	QMutexLocker locker(&_mutex);
+	PHDBG(24) << capacity;
+	_capacity = capacity;
+	while(_decodedBuffers.count() > _capacity) {
+		if(!evict())
+			break;
+	}
+}
+
+int PhVideoPool::count()
+{
+	QMutexLocker locker(&_mutex);
+	return _decodedBuffers.count();
+}
+
+void PhVideoPool::setWindow(PhFrame playhead, PhFrame first, PhFrame last, PhFrame requestLast)
+{
+	QMutexLocker locker(&_mutex);
+	_playhead = playhead;
+	_firstWanted = first;
+	_lastWanted = last;
+	_lastRequested = requestLast;
+}
+
+PhFrame PhVideoPool::nextMissingFrame()
+{
+	QMutexLocker locker(&_mutex);
+	if(_lastRequested == PHFRAMEMIN)
+		return PHFRAMEMIN;
+
+	PhFrame direction = (_lastRequested < _playhead) ? -1 : 1;
+	for(PhFrame frame = _playhead; frame != _lastRequested + direction; frame += direction) {
+		if(!_decodedBuffers.contains(frame))
+			return frame;
+	}
+	return PHFRAMEMIN;
+}
+
+void PhVideoPool::setPinnedRange(PhFrame first, PhFrame last)
+{
+	QMutexLocker locker(&_mutex);
+	PHDBG(24) << first << last;
+	_firstPinned = first;
+	_lastPinned = last;
+}
+
+bool PhVideoPool::isWanted(PhFrame frame)
+{
+	QMutexLocker locker(&_mutex);
+	return ((frame >= _firstWanted) && (frame <= _lastWanted)) || isPinned(frame);
+}
+
+PhVideoBuffer *PhVideoPool::takeFreeBuffer()
+{
+	QMutexLocker locker(&_mutex);
+
+	// One extra buffer is being filled by the decoder and another one
+	// may be read by the engine.
+	if(_freeBuffers.isEmpty() && (_buffers.count() >= _capacity + 2))
+		evict();
+
+	PhVideoBuffer *buffer;
+	if(_freeBuffers.count())
+		buffer = _freeBuffers.takeFirst();
+	else {
+		buffer = new PhVideoBuffer();
+		_buffers.append(buffer);
+	}
+	buffer->setGeneration(_generation);
+
+	return buffer;
+}
+
+void PhVideoPool::recycle(PhVideoBuffer *buffer)
+{
+	QMutexLocker locker(&_mutex);
+	_freeBuffers.append(buffer);
+}
+
+void PhVideoPool::insert(PhVideoBuffer *buffer)
+{
+	QMutexLocker locker(&_mutex);
+
+	// Discard the frames decoded before a clear() and the duplicates
+	if((buffer->generation() != _generation) || _decodedBuffers.contains(buffer->frame())) {
+		_freeBuffers.append(buffer);
+		return;
+	}
+
+	buffer->setLastUse(++_useCounter);
+	_decodedBuffers[buffer->frame()] = buffer;
+
+	while(_decodedBuffers.count() > _capacity) {
+		if(!evict())
+			break;
+	}
+}
+
+bool PhVideoPool::contains(PhFrame frame)
+{
+	QMutexLocker locker(&_mutex);
+	return _decodedBuffers.contains(frame);
+}
+
+PhVideoBuffer *PhVideoPool::acquire(PhFrame frame)
+{
+	QMutexLocker locker(&_mutex);
+	PhVideoBuffer *buffer = _decodedBuffers.value(frame, NULL);
+	if(buffer) {
+		buffer->setLastUse(++_useCounter);
+		_usedBuffers.insert(buffer);
+	}
+	return buffer;
+}
+
+void PhVideoPool::release(PhVideoBuffer *buffer)
+{
+	QMutexLocker locker(&_mutex);
+	_usedBuffers.remove(buffer);
+
+	// The buffer may have been discarded while it was used
+	if(_decodedBuffers.value(buffer->frame(), NULL) != buffer)
+		_freeBuffers.append(buffer);
+}
+
+void PhVideoPool::clear()
+{
+	QMutexLocker locker(&_mutex);
+	PHDBG(24) << _decodedBuffers.count();
+
+	_generation++;
+	foreach(PhVideoBuffer *buffer, _decodedBuffers) {
+		// The used buffers will be recycled on release()
+		if(!_usedBuffers.contains(buffer))
+			_freeBuffers.append(buffer);
+	}
+	_decodedBuffers.clear();
+}
+
+bool PhVideoPool::evict()
+{
+	// Pick the buffer with the lowest priority then the highest score:
+	// 0: neither wanted nor pinned, the least recently used
+	// 1: in the wanted window, the farthest from the playhead
+	// 2: pinned, the farthest from the pinned range start
+	PhVideoBuffer *candidate = NULL;
+	int candidatePriority = 3;
+	qint64 candidateScore = 0;
+	foreach(PhVideoBuffer *buffer, _decodedBuffers) {
+		if(_usedBuffers.contains(buffer))
+			continue;
+
+		PhFrame frame = buffer->frame();
+		int priority;
+		qint64 score;
+		if(isPinned(frame)) {
+			priority = 2;
+			score = frame - _firstPinned;
+		}
+		else if((frame >= _firstWanted) && (frame <= _lastWanted)) {
+			priority = 1;
+			score = qAbs(frame - _playhead);
+		}
+		else {
+			priority = 0;
+			score = -static_cast<qint64>(buffer->lastUse());
+		}
+
+		if((priority < candidatePriority) || ((priority == candidatePriority) && (score > candidateScore))) {
+			candidate = buffer;
+			candidatePriority = priority;
+			candidateScore = score;
+		}
+	}
+
+	if(candidate == NULL)
+		return false;
+
+	_decodedBuffers.remove(candidate->frame());
+	_freeBuffers.append(candidate);
+	return true;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef PHVIDEOPOOL_H
+#define PHVIDEOPOOL_H
+
+#include <QMap>
+#include <QSet>
+#include <QMutex>
+
+#include "PhVideoBuffer.h"
+
+/**
+ * @brief A bounded and thread safe collection of decoded frames
+ *
+ * The pool is shared between the PhVideoDecoder, which fills it from
+ * its own thread, and the PhVideoEngine, which picks the frame to display
+ * from the render thread.
+ *
+ * The engine describes the range of frames it is interested in (the
+ * playhead and the look-ahead window) and may pin a range of frames (such
+ * as the loop being rehearsed) so that they stay in memory. When the pool
+ * is full, the least recently used frames out of these ranges are recycled
+ * first, then the frames of the window which are the farthest from the
+ * playhead and finally the end of the pinned range.
+ */
+class PhVideoPool
+{
+public:
+	/**
+	 * @brief PhVideoPool constructor
+	 * @param capacity The maximum number of decoded frames
+	 */
+	explicit PhVideoPool(int capacity = 16);
+
+	~PhVideoPool();
+
+	/**
+	 * @brief The maximum number of decoded frames
+	 * @return An integer value
+	 */
+	int capacity();
+
+	/**
+	 * @brief Set the maximum number of decoded frames
+	 * @param capacity An integer value
+	 */
+	void setCapacity(int capacity);
+
+	/**
+	 * @brief The number of decoded frames currently available
+	 * @return An integer value
+	 */
+	int count();
+
+	/**
+	 * @brief Set the range of frames the consumer is interested in
+	 *
+	 * Each call replaces the previous request: only the latest one matters.
+	 * @param playhead The frame currently displayed
+	 * @param first The first wanted frame
+	 * @param last The last wanted frame
+	 * @param requestLast The frames from the playhead to this one must be decoded
+	 */
+	void setWindow(PhFrame playhead, PhFrame first, PhFrame last, PhFrame requestLast);
+
+	/**
+	 * @brief Get the most urgent frame to decode
+	 *
+	 * The playhead first, then the following frames toward the end of the request.
+	 * @return A frame value or PHFRAMEMIN if all the requested frames are available
+	 */
+	PhFrame nextMissingFrame();
+
+	/**
+	 * @brief Set a range of frames to keep in memory
+	 * @param first The first pinned frame
+	 * @param last The last pinned frame (lower than first to unpin)
+	 */
+	void setPinnedRange(PhFrame first, PhFrame last);
+
+	/**
+	 * @brief Check if a frame is still in the wanted or pinned range
+	 * @param frame A frame value
+	 * @return True if the frame is wanted
+	 */
+	bool isWanted(PhFrame frame);
+
+	/**
+	 * @brief Get a buffer to fill with a new picture
+	 *
+	 * The buffer comes from the unused list or a frame far from the playhead
+	 * is recycled.
+	 * @return A buffer which must be given back with insert() or recycle()
+	 */
+	PhVideoBuffer *takeFreeBuffer();
+
+	/**
+	 * @brief Give back a buffer which could not be filled
+	 * @param buffer A buffer
+	 */
+	void recycle(PhVideoBuffer *buffer);
+
+	/**
+	 * @brief Add a decoded frame to the pool
+	 *
+	 * The buffer is discarded if the pool was cleared since it was taken.
+	 * @param buffer A buffer filled by the decoder
+	 */
+	void insert(PhVideoBuffer *buffer);
+
+	/**
+	 * @brief Check if a frame is available
+	 * @param frame A frame value
+	 * @return True if the frame is decoded
+	 */
+	bool contains(PhFrame frame);
+
+	/**
+	 * @brief Get a decoded frame for reading
+	 *
+	 * The buffer won't be recycled until it is released.
+	 * @param frame A frame value
+	 * @return A buffer or NULL if the frame is not available
+	 */
+	PhVideoBuffer *acquire(PhFrame frame);
+
+	/**
+	 * @brief Release a buffer obtained with acquire()
+	 * @param buffer A buffer
+	 */
+	void release(PhVideoBuffer *buffer);
+
+	/**
+	 * @brief Discard all the decoded frames
+	 *
+	 * The buffer being filled at the time of the call will also be
+	 * discarded when inserted.
+	 */
+	void clear();
+
+private:
+	bool evict();
+	bool isPinned(PhFrame frame) {
+		return (frame >= _firstPinned) && (frame <= _lastPinned);
+	}
+
+	QMutex _mutex;
+	int _capacity;
+	int _generation;
+	PhFrame _playhead, _firstWanted, _lastWanted, _lastRequested;
+	PhFrame _firstPinned, _lastPinned;
+	quint64 _useCounter;
+	QList<PhVideoBuffer*> _buffers;
+	QList<PhVideoBuffer*> _freeBuffers;
+	QMap<PhFrame, PhVideoBuffer*> _decodedBuffers;
+	QSet<PhVideoBuffer*> _usedBuffers;
+};
+
+#endif // PHVIDEOPOOL_H
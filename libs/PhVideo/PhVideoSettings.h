@@ -18,6 +18,62 @@ public:
 	 * @return A value in millisecond
 	 */
 	virtual int screenDelay() = 0;
+
+	/**
+	 * @brief Number of frames decoded ahead of the playhead
+	 * @return A number of frames
+	 */
+	virtual int videoReadhead() {
+		return 8;
+	}
+
+	/**
+	 * @brief Maximum number of decoded frames kept in memory
+	 *
+	 * When playing backward, the frames decoded from the previous keyframe
+	 * are kept up to this limit. Once the keyframe index is built, the pool
+	 * is enlarged to the longest group of pictures of the file if needed:
+	 * otherwise each step backward would decode the whole group again.
+	 * Long groups of pictures therefore cost more memory.
+	 * @return A number of frames
+	 */
+	virtual int videoPoolSize() {
+		return 32;
+	}
+
+	/**
+	 * @brief Memory used to cache the decoded frames
+	 *
+	 * The frames of the loop being rehearsed are kept in this cache.
+	 * They are stored as YUV planes: a 1080p 4:2:0 picture takes 3 MB,
+	 * so the default keeps about 27 seconds at 25 fps. A longer loop is
+	 * only partially kept.
+	 * @return A value in megabytes
+	 */
+	virtual int videoCacheSize() {
+		return 2048;
+	}
+
+	/**
+	 * @brief Number of threads used by the video decoder
+	 * @return A number of threads or 0 to use one thread per core
+	 */
+	virtual int videoDecodeThreadCount() {
+		return 0;
+	}
+
+	/**
+	 * @brief Threading method of the video decoder
+	 *
+	 * The frame threading is the fastest for sequential decoding but add
+	 * one frame of latency per thread after each seek. The slice threading
+	 * doesn't add latency but is not supported by all the codecs.
+	 * The VideoBenchmark compares the methods with --compare-threading.
+	 * @return A PhVideoDecoder::ThreadType value
+	 */
+	virtual int videoDecodeThreadType() {
+		return 0;
+	}
 };
 
 #endif // PHVIDEOSETTINGS_H
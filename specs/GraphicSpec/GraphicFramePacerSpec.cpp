@@ -0,0 +1,68 @@
+/**
+ * Copyright (C) 2012-2014 Phonations
+ * License: http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include "PhGraphic/PhGraphicFramePacer.h"
+
+#include "PhSpec.h"
+
+using namespace bandit;
+
+go_bandit([](){
+	describe("graphic_frame_pacer_test", [&](){
+		// 60 Hz in nanoseconds
+		const qint64 period = 16666666;
+
+		it("predict_one_period_when_not_synchronized", [&](){
+			PhGraphicFramePacer pacer(60);
+
+			AssertThat(pacer.displayTime(1000), Equals(1000 + period));
+		});
+
+		it("predict_steady_display_times", [&](){
+			PhGraphicFramePacer pacer(60);
+
+			// The swaps return with up to 0.2 ms of jitter
+			qint64 jitters[] = {0, 150000, -200000, 80000, -120000, 200000, -50000, 0};
+			for(int i = 0; i < 120; i++)
+				pacer.addSwap(i * period + jitters[i % 8]);
+
+			// The paint starting after the last swap is displayed on the next refresh
+			qint64 lastSwap = 119 * period;
+			qint64 first = pacer.displayTime(lastSwap + 2000000);
+			qint64 second = pacer.displayTime(lastSwap + period + 3000000);
+			AssertThat(qAbs(first - (lastSwap + period)), IsLessThan(100000));
+			AssertThat(qAbs(second - first - period), IsLessThan(50000));
+			AssertThat(pacer.missedCount(), Equals(0));
+		});
+
+		it("count_the_dropped_frames", [&](){
+			PhGraphicFramePacer pacer(60);
+
+			for(int i = 0; i < 10; i++)
+				pacer.addSwap(i * period);
+			pacer.addSwap(11 * period);
+
+			AssertThat(pacer.missedCount(), Equals(1));
+
+			// A paint late by one refresh is displayed two periods after the previous one
+			qint64 first = pacer.displayTime(11 * period + 1000000);
+			qint64 second = pacer.displayTime(13 * period + 1000000);
+			AssertThat(second - first, Equals(2 * period));
+		});
+
+		it("restart_when_the_synchronization_is_lost", [&](){
+			PhGraphicFramePacer pacer(60);
+
+			for(int i = 0; i < 10; i++)
+				pacer.addSwap(i * period);
+			// Far from the refresh grid
+			qint64 swap = 10 * period + period / 2 - 1000;
+			pacer.addSwap(swap);
+
+			AssertThat(pacer.period(), Equals(period));
+			AssertThat(pacer.displayTime(swap + 1000000), Equals(swap + period));
+		});
+	});
+});
@@ -0,0 +1,72 @@
+/**
+ * Copyright (C) 2012-2014 Phonations
+ * License: http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include <QFile>
+
+#include "PhTools/PhDebug.h"
+#include "PhGraphic/PhGraphicProfiler.h"
+
+#include "PhSpec.h"
+
+using namespace bandit;
+
+go_bandit([](){
+	describe("graphic_profiler_test", [&](){
+		PhGraphicProfiler *profiler;
+
+		before_each([&](){
+			PhDebug::disable();
+			profiler = PhGraphicProfiler::instance();
+		});
+
+		after_each([&](){
+			profiler->setEnabled(false);
+		});
+
+		it("record_nothing_when_disabled", [&](){
+			profiler->setEnabled(true);
+			profiler->setEnabled(false);
+			for(int i = 0; i < 70; i++) {
+				profiler->beginFrame();
+				profiler->addSample(PhGraphicProfiler::VideoDecodeStage, profiler->now(), 1000000);
+			}
+
+			profiler->setEnabled(true);
+			AssertThat(profiler->averageTime(PhGraphicProfiler::VideoDecodeStage, false), Equals(-1));
+		});
+
+		it("average_the_stage_time", [&](){
+			profiler->setEnabled(true);
+			for(int i = 0; i < 70; i++) {
+				profiler->beginFrame();
+				profiler->addSample(PhGraphicProfiler::VideoDecodeStage, profiler->now(), 1000000);
+				profiler->addSample(PhGraphicProfiler::VideoDecodeStage, profiler->now(), 2000000);
+				profiler->addSample(PhGraphicProfiler::VideoConvertStage, profiler->now(), 500000);
+			}
+
+			AssertThat(profiler->averageTime(PhGraphicProfiler::VideoDecodeStage, false), Equals(3000000));
+			AssertThat(profiler->averageTime(PhGraphicProfiler::VideoConvertStage, false), Equals(500000));
+			AssertThat(profiler->averageTime(PhGraphicProfiler::VideoConvertStage, true), Equals(-1));
+			AssertThat(profiler->averageTime(PhGraphicProfiler::StripTextStage, false), Equals(-1));
+		});
+
+		it("save_a_trace", [&](){
+			profiler->setEnabled(true);
+			for(int i = 0; i < 3; i++) {
+				profiler->beginFrame();
+				profiler->addSample(PhGraphicProfiler::VideoConvertStage, profiler->now(), 500000);
+			}
+
+			AssertThat(profiler->saveTrace("profile.json"), IsTrue());
+
+			QFile file("profile.json");
+			AssertThat(file.open(QFile::ReadOnly), IsTrue());
+			QString trace = file.readAll();
+			AssertThat(trace.startsWith("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), IsTrue());
+			AssertThat(trace.count("\"name\":\"convert\""), Equals(3));
+			AssertThat(trace.count("\"name\":\"frame\""), Equals(2));
+		});
+	});
+});
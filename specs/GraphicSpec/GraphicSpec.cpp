@@ -8,6 +8,7 @@
 #include "PhTools/PhPictureTools.h"
 
 #include "PhGraphic/PhGraphicView.h"
+#include "PhGraphic/PhGraphicOffscreen.h"
 #include "PhGraphic/PhGraphicSolidRect.h"
 #include "PhGraphic/PhGraphicTexturedRect.h"
 #include "PhGraphic/PhGraphicImage.h"
@@ -41,26 +42,42 @@ go_bandit([](){
 			AssertThat(paintCalled, IsTrue());
 		});
 
+		it("render_offscreen", [&](){
+			PhGraphicOffscreen offscreen(48, 32);
+			AssertThat(offscreen.isValid(), IsTrue());
+
+			PhTime elapsed = 0;
+			int paintWidth = 0, paintHeight = 0;
+
+			QObject::connect(&offscreen, &PhGraphicOffscreen::beforePaint, [&](PhTime elapsedTime) {
+				elapsed = elapsedTime;
+			});
+			QObject::connect(&offscreen, &PhGraphicOffscreen::paint, [&](int w, int h) {
+				paintWidth = w;
+				paintHeight = h;
+			});
+
+			QImage resultImage = offscreen.render(960);
+
+			AssertThat(elapsed, Equals(960));
+			AssertThat(paintWidth, Equals(48));
+			AssertThat(paintHeight, Equals(32));
+			AssertThat(resultImage.width(), Equals(48));
+			AssertThat(resultImage.height(), Equals(32));
+		});
+
 		it("draw_a_rect", [&](){
-			PhGraphicView view(32, 32);
+			PhGraphicOffscreen offscreen(32, 32);
 
 			PhGraphicSolidRect rect;
 			rect.setColor(Qt::red);
 
-			QObject::connect(&view, &PhGraphicView::paint, [&](int w, int h) {
+			QObject::connect(&offscreen, &PhGraphicOffscreen::paint, [&](int w, int h) {
 				rect.setSize(w / 2, h / 2);
 				rect.draw();
 			});
 
-			view.show();
-
-#warning /// @todo remove if unnecessary
-			//		QApplication::processEvents();
-
-			// Note: using view.grabFrameBuffer() causes timing issues.
-			// There is no warranty that the scene has been fully rendered.
-			// Use view.renderPixmap().toImage() instead.
-			QImage resultImage(view.renderPixmap(32, 32).toImage());
+			QImage resultImage(offscreen.render());
 			QString resultFile = "rectTest.result.bmp";
 			resultImage.save(resultFile);
 			QString expectedFile = "rectTest.expected.bmp";
@@ -71,18 +88,16 @@ go_bandit([](){
 		});
 
 		it("draw_an_image", [&](){
-			PhGraphicView view(64, 64);
+			PhGraphicOffscreen offscreen(64, 64);
 
 			PhGraphicImage image("rgbPatternTest.expected.bmp");
 
-			QObject::connect(&view, &PhGraphicView::paint, [&](int w, int h) {
+			QObject::connect(&offscreen, &PhGraphicOffscreen::paint, [&](int w, int h) {
 				image.setSize(w, h);
 				image.draw();
 			});
 
-			view.show();
-
-			QImage resultImage(view.renderPixmap(64, 64).toImage());
+			QImage resultImage(offscreen.render());
 			QString resultFile = "imageTest.result.bmp";
 			resultImage.save(resultFile);
 
@@ -99,11 +114,11 @@ go_bandit([](){
 		it("draw_a_rgb_pattern", [&](){
 			int w = 64;
 			int h = 64;
-			PhGraphicView view(w, h);
+			PhGraphicOffscreen offscreen(w, h);
 
 			PhGraphicTexturedRect rect(0, 0, w, h);
 
-			QObject::connect(&view, &PhGraphicView::paint, [&](int w, int h) {
+			QObject::connect(&offscreen, &PhGraphicOffscreen::paint, [&](int w, int h) {
 #warning /// @todo try to make it before (creating the texture on auto init)
 				unsigned char * buffer = PhPictureTools::generateRGBPattern(w, h);
 				rect.createTextureFromRGBBuffer(buffer, w, h);
@@ -111,9 +126,7 @@ go_bandit([](){
 				rect.draw();
 			});
 
-			view.show();
-
-			QImage resultImage(view.renderPixmap(64, 64).toImage());
+			QImage resultImage(offscreen.render());
 			QString resultFile = "rgbPatternTest.result.bmp";
 			resultImage.save(resultFile);
 			QString expectedFile = "rgbPatternTest.expected.bmp";
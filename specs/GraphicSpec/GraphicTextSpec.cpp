@@ -7,7 +7,7 @@
 #include "PhTools/PhDebug.h"
 #include "PhTools/PhPictureTools.h"
 
-#include "PhGraphic/PhGraphicView.h"
+#include "PhGraphic/PhGraphicOffscreen.h"
 #include "PhGraphic/PhGraphicText.h"
 #include "PhGraphic/PhGraphicSolidRect.h"
 
@@ -17,16 +17,16 @@ using namespace bandit;
 
 go_bandit([](){
 	describe("graphic_text_test", [&](){
-		PhGraphicView *view;
+		PhGraphicOffscreen *offscreen;
 		PhFont *font;
 
 		before_each([&](){
 			PhDebug::disable();
 
-			view = new PhGraphicView(776, 576);
+			offscreen = new PhGraphicOffscreen(776, 576);
 			font = new PhFont();
 
-			QObject::connect(view, &PhGraphicView::paint, [&](int w, int h) {
+			QObject::connect(offscreen, &PhGraphicOffscreen::paint, [&](int w, int h) {
 				glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 				glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -75,13 +75,13 @@ go_bandit([](){
 
 		after_each([&](){
 			delete font;
-			delete view;
+			delete offscreen;
 		});
 
 		it("draw_swenson_font", [&](){
 			font->setFontFile("SWENSON.ttf");
 
-			QImage resultImage(view->renderPixmap(776, 576).toImage());
+			QImage resultImage(offscreen->render());
 			resultImage.save("fontTest.SWENSON.ttf.result.bmp");
 			QImage expectedImage("fontTest.SWENSON.ttf.expected.bmp");
 
@@ -92,7 +92,7 @@ go_bandit([](){
 		it("draw_arial_font", [&](){
 			font->setFontFile("Arial.ttf");
 
-			QImage resultImage(view->renderPixmap(776, 576).toImage());
+			QImage resultImage(offscreen->render());
 			resultImage.save("fontTest.Arial.ttf.result.bmp");
 			QImage expectedImage("fontTest.Arial.ttf.expected.bmp");
 
@@ -103,7 +103,7 @@ go_bandit([](){
 		it("draw_bedizen_font", [&](){
 			font->setFontFile("Bedizen.ttf");
 
-			QImage resultImage(view->renderPixmap(776, 576).toImage());
+			QImage resultImage(offscreen->render());
 			resultImage.save("fontTest.Bedizen.ttf.result.bmp");
 			QImage expectedImage("fontTest.Bedizen.ttf.expected.bmp");
 
@@ -114,7 +114,7 @@ go_bandit([](){
 		it("draw_bad_font", [&](){
 			font->setFontFile("bad_font.ttf");
 
-			QImage resultImage(view->renderPixmap(776, 576).toImage());
+			QImage resultImage(offscreen->render());
 			resultImage.save("fontTest.bad_font.ttf.result.bmp");
 			QImage expectedImage("fontTest.bad_font.ttf.expected.bmp");
 
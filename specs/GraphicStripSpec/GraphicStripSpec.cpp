@@ -7,7 +7,7 @@
 #include "PhTools/PhDebug.h"
 #include "PhTools/PhPictureTools.h"
 
-#include "PhGraphic/PhGraphicView.h"
+#include "PhGraphic/PhGraphicOffscreen.h"
 #include "PhGraphicStrip/PhGraphicStrip.h"
 
 #include "GraphicStripSpecSettings.h"
@@ -18,18 +18,18 @@ using namespace bandit;
 
 go_bandit([](){
 	describe("graphic_strip_test", []() {
-		before_each([&](){
-			PhDebug::disable();
-		});
+		PhGraphicOffscreen *offscreen;
+		GraphicStripSpecSettings *settings;
+		GraphicStripSpecSettings *immediateSettings;
 
-		it("draw_a_graphic_strip", [&](){
-			PhGraphicView view(720, 240);
+		// Draw the drawTest document with a new strip
+		auto render = [&](GraphicStripSpecSettings *stripSettings, PhTime time, bool selectFirstPeople, bool textAcrossTiles) {
+			offscreen->makeCurrent();
+			PhGraphicStrip strip(stripSettings);
+			QList<PhPeople *> selectedPeoples;
 
-			GraphicStripSpecSettings settings;
-			PhGraphicStrip strip(&settings);
-
-			QObject::connect(&view, &PhGraphicView::paint, [&](int w, int h) {
-				strip.draw(0, 0, w, h);
+			QMetaObject::Connection connection = QObject::connect(offscreen, &PhGraphicOffscreen::paint, [&](int w, int h) {
+				strip.draw(0, 0, w, h, 0, 0, selectedPeoples);
 			});
 
 			PhStripDoc * doc = strip.doc();
@@ -43,9 +43,37 @@ go_bandit([](){
 			doc->addObject(new PhStripLoop(22000, "label"));
 			doc->addObject(new PhStripText(10000, doc->peoples().last(), 15000, 0.5f, "Hi !", 0.25f));
 			doc->addObject(new PhStripDetect(PhStripDetect::SemiOff, 10000, doc->peoples().last(), 15000, 0.5f));
+			// The tiles are one strip wide (57600 at 80 per pixel) and aligned on the time origin
+			if(textAcrossTiles) {
+				doc->addObject(new PhStripText(52000, doc->peoples().first(), 63000, 0.25f, "Across the tiles", 0.25f));
+				doc->addObject(new PhStripDetect(PhStripDetect::On, 52000, doc->peoples().first(), 63000, 0.25f));
+			}
 			doc->changed();
 
-			QImage resultImage(view.renderPixmap(720, 240).toImage());
+			if(selectFirstPeople)
+				selectedPeoples.append(doc->peoples().first());
+			strip.clock()->setTime(time);
+
+			QImage result(offscreen->render());
+			QObject::disconnect(connection);
+			return result;
+		};
+
+		before_each([&](){
+			PhDebug::disable();
+			offscreen = new PhGraphicOffscreen(720, 240);
+			settings = new GraphicStripSpecSettings();
+			immediateSettings = new GraphicStripSpecSettings();
+		});
+
+		after_each([&](){
+			delete immediateSettings;
+			delete settings;
+			delete offscreen;
+		});
+
+		it("draw_a_graphic_strip", [&](){
+			QImage resultImage = render(settings, 0, false, false);
 			QString resultFile = "drawTest.result.bmp";
 			resultImage.save(resultFile);
 			QString expectedFile = "drawTest.expected.bmp";
@@ -55,6 +83,43 @@ go_bandit([](){
 			PHDEBUG << "result:" << result;
 			AssertThat(result, IsLessThan(720 * 240)); // accept a difference of 1 per pixel
 		});
+
+		// The tiled and GPU strips must draw as the immediate one
+		auto describeMode = [&](const char *name, bool tiled, bool gpu) {
+			describe(name, [&, tiled, gpu]() {
+				before_each([&, tiled, gpu](){
+					settings->setTiledStrip(tiled);
+					settings->setGpuStrip(gpu);
+				});
+
+				it("draw_like_the_expected_image", [&](){
+					// The time origin is a tile boundary, at the sync bar
+					QImage resultImage = render(settings, 0, false, false);
+					QImage expectedImage("drawTest.expected.bmp");
+
+					AssertThat(PhPictureTools::compare(resultImage, expectedImage, true), IsLessThan(720 * 240));
+				});
+
+				it("draw_selected_people_with_inverted_colors", [&](){
+					settings->setInvertColor(true);
+					immediateSettings->setInvertColor(true);
+
+					QImage resultImage = render(settings, 5000, true, false);
+					QImage expectedImage = render(immediateSettings, 5000, true, false);
+
+					AssertThat(PhPictureTools::compare(resultImage, expectedImage, true), IsLessThan(720 * 240));
+				});
+
+				it("draw_a_text_across_a_tile_boundary", [&](){
+					QImage resultImage = render(settings, 57600, false, true);
+					QImage expectedImage = render(immediateSettings, 57600, false, true);
+
+					AssertThat(PhPictureTools::compare(resultImage, expectedImage, true), IsLessThan(720 * 240));
+				});
+			});
+		};
+
+		describeMode("tiled", true, false);
+		describeMode("gpu", false, true);
 	});
 });
-
@@ -13,6 +13,9 @@
 class GraphicStripSpecSettings : public PhGraphicStripSettings
 {
 public:
+	GraphicStripSpecSettings() : _tiledStrip(false), _gpuStrip(false), _invertColor(false) {
+	}
+
 	// PhGraphicSettings
 	int screenDelay() {
 		return 0;
@@ -54,6 +57,21 @@ public:
 	int textBoldness() {
 		return 1;
 	}
+	bool textDistanceField() {
+		return false;
+	}
+	bool tiledStrip() {
+		return _tiledStrip;
+	}
+	void setTiledStrip(bool tiledStrip) {
+		_tiledStrip = tiledStrip;
+	}
+	bool gpuStrip() {
+		return _gpuStrip;
+	}
+	void setGpuStrip(bool gpuStrip) {
+		_gpuStrip = gpuStrip;
+	}
 	bool stripTestMode() {
 		return false;
 	}
@@ -65,7 +83,10 @@ public:
 	}
 
 	bool invertColor() {
-		return false;
+		return _invertColor;
+	}
+	void setInvertColor(bool invertColor) {
+		_invertColor = invertColor;
 	}
 	bool displayRuler() {
 		return false;
@@ -104,6 +125,9 @@ public:
 	int verticalScaleSpaceInSeconds() {
 		return 5;
 	}
+
+private:
+	bool _tiledStrip, _gpuStrip, _invertColor;
 };
 
 #endif // GRAPHICSTRIPSPECSETTINGS_H
@@ -98,6 +98,25 @@ go_bandit([](){
 				AssertThat(t2s(doc.detects()[5]->timeOut(), PhTimeCodeType25), Equals("01:00:31:04"));
 				AssertThat(doc.detects()[5]->y(), Equals(0.5f));
 			});
+
+			it("import_stream_like_dom", [&](){
+				PhStripDoc domDoc;
+				AssertThat(domDoc.importDetXDomFile("notitle.detx"), IsTrue());
+				AssertThat(doc.importDetXFile("notitle.detx"), IsTrue());
+
+				AssertThat(doc.title().toStdString(), Equals(domDoc.title().toStdString()));
+				AssertThat(doc.authorName().toStdString(), Equals(domDoc.authorName().toStdString()));
+				AssertThat(doc.videoFilePath().toStdString(), Equals(domDoc.videoFilePath().toStdString()));
+				AssertThat(doc.videoTimeIn(), Equals(domDoc.videoTimeIn()));
+				AssertThat(doc.peoples().count(), Equals(domDoc.peoples().count()));
+				AssertThat(doc.cuts().count(), Equals(domDoc.cuts().count()));
+				AssertThat(doc.texts().count(), Equals(domDoc.texts().count()));
+				AssertThat(doc.texts()[0]->content().toStdString(), Equals(domDoc.texts()[0]->content().toStdString()));
+				AssertThat(doc.texts()[0]->timeIn(), Equals(domDoc.texts()[0]->timeIn()));
+				AssertThat(doc.texts()[0]->timeOut(), Equals(domDoc.texts()[0]->timeOut()));
+				AssertThat(doc.detects().count(), Equals(domDoc.detects().count()));
+				AssertThat(doc.detects()[0]->timeOut(), Equals(domDoc.detects()[0]->timeOut()));
+			});
 		});
 
 		describe("mos", [&]() {
@@ -473,6 +492,210 @@ go_bandit([](){
 				});
 			});
 		});
+		describe("query", [&]() {
+			PhPeople *sue = NULL, *paul = NULL;
+
+			before_each([&](){
+				sue = new PhPeople("Sue");
+				paul = new PhPeople("Paul");
+				doc.addPeople(sue);
+				doc.addPeople(paul);
+
+				doc.addObject(new PhStripText(5000, sue, 6000, 0, "B", 0.25f));
+				doc.addObject(new PhStripText(1000, paul, 2000, 0, "A", 0.25f));
+				doc.addObject(new PhStripText(9000, paul, 9500, 0, "C", 0.25f));
+				doc.addObject(new PhStripLoop(8000, "2"));
+				doc.addObject(new PhStripLoop(3000, "1"));
+				doc.addObject(new PhStripCut(7000, PhStripCut::Simple));
+				doc.addObject(new PhStripDetect(PhStripDetect::Off, 4000, sue, 4500, 0));
+				doc.addObject(new PhStripDetect(PhStripDetect::On, 1000, paul, 3000, 0));
+			});
+
+			it("query_next_text", [&](){
+				AssertThat(doc.nextText(0)->content().toStdString(), Equals("A"));
+				AssertThat(doc.nextText(1000)->content().toStdString(), Equals("B"));
+				AssertThat(doc.nextText(9000) == NULL, IsTrue());
+
+				AssertThat(doc.nextText(paul, 1000)->content().toStdString(), Equals("C"));
+				AssertThat(doc.nextText(sue, 5000) == NULL, IsTrue());
+			});
+
+			it("query_times", [&](){
+				AssertThat(doc.nextTextTime(5000), Equals(9000));
+				AssertThat(doc.previousTextTime(5000), Equals(1000));
+				AssertThat(doc.nextLoopTime(3000), Equals(8000));
+				AssertThat(doc.previousLoopTime(3000), Equals(PHTIMEMIN));
+				AssertThat(doc.nextCutTime(0), Equals(7000));
+				AssertThat(doc.previousCutTime(7000), Equals(PHTIMEMIN));
+				AssertThat(doc.timeIn(), Equals(1000));
+				AssertThat(doc.timeOut(), Equals(9000));
+			});
+
+			it("query_loops", [&](){
+				AssertThat(doc.nextLoop(0)->label().toStdString(), Equals("1"));
+				AssertThat(doc.previousLoop(9000)->label().toStdString(), Equals("2"));
+				AssertThat(doc.previousLoop(3000) == NULL, IsTrue());
+			});
+
+			it("query_detects", [&](){
+				AssertThat(doc.detects().count(), Equals(2));
+				AssertThat(doc.detects(0, 5000).count(), Equals(2));
+				AssertThat(doc.detects(0, 5000)[0]->people(), Equals(paul));
+				AssertThat(doc.detects(2000, 5000).count(), Equals(1));
+				AssertThat(doc.detects(0, 4000).count(), Equals(1));
+				AssertThat(doc.peopleDetects(sue, 0, 5000).count(), Equals(1));
+			});
+
+			it("query_people", [&](){
+				AssertThat(doc.peopleByName("Sue"), Equals(sue));
+				AssertThat(doc.peopleByName("Jeanne") == NULL, IsTrue());
+
+				AssertThat(doc.texts(paul).count(), Equals(2));
+				AssertThat(doc.texts(paul)[0]->content().toStdString(), Equals("A"));
+				AssertThat(doc.peopleDetects(paul).count(), Equals(1));
+
+				AssertThat(doc.nextText({sue, paul}, 0)->content().toStdString(), Equals("A"));
+				AssertThat(doc.nextText({sue, paul}, 1000)->content().toStdString(), Equals("B"));
+				AssertThat(doc.nextText({sue}, 1000)->content().toStdString(), Equals("B"));
+			});
+		});
+		describe("store", [&]() {
+			PhStripStore store;
+			PhPeople sue("Sue"), paul("Paul");
+
+			before_each([&](){
+				store.clear();
+			});
+
+			it("store_properties", [&](){
+				PhStripText *text = store.createText(1000, &sue, 2000, 0.5f, "Hello", 0.25f);
+				PhStripDetect *detect = store.createDetect(PhStripDetect::Off, 1500, &paul, 1800, 0.25f);
+				PhStripCut *cut = store.createCut(3000, PhStripCut::CrossFade);
+				PhStripLoop *loop = store.createLoop(4000, "2");
+
+				AssertThat(store.count(), Equals(4));
+				AssertThat(text->timeIn(), Equals(1000));
+				AssertThat(text->timeOut(), Equals(2000));
+				AssertThat(text->people(), Equals(&sue));
+				AssertThat(text->y(), Equals(0.5f));
+				AssertThat(text->height(), Equals(0.25f));
+				AssertThat(text->content().toStdString(), Equals("Hello"));
+				AssertThat(detect->type(), Equals(PhStripDetect::Off));
+				AssertThat(detect->people(), Equals(&paul));
+				AssertThat(cut->type(), Equals(PhStripCut::CrossFade));
+				AssertThat(cut->timeIn(), Equals(3000));
+				AssertThat(loop->label().toStdString(), Equals("2"));
+
+				text->setPeople(&paul);
+				text->setTimeOut(2500);
+				text->setY(0.75f);
+				AssertThat(store.people(0), Equals(&paul));
+				AssertThat(store.timeOut(0), Equals(2500));
+				AssertThat(store.y(0), Equals(0.75f));
+			});
+
+			it("store_string_pool", [&](){
+				for(int i = 0; i < 10000; i++)
+					store.createText(i * 1000, &sue, i * 1000 + 500, 0, (i % 2) ? "Hello" : "Hi", 0.25f);
+
+				AssertThat(store.count(), Equals(10000));
+				AssertThat(store.stringCount(), Equals(2));
+				AssertThat(store.string(9999).toStdString(), Equals("Hello"));
+				AssertThat(store.blockCount(), IsGreaterThan(1));
+
+				store.clear();
+				AssertThat(store.count(), Equals(0));
+				AssertThat(store.stringCount(), Equals(0));
+				AssertThat(store.blockCount(), Equals(0));
+			});
+
+			it("store_adopt", [&](){
+				PhStripText *text = new PhStripText(1000, &sue, 2000, 0.5f, "Hello", 0.25f);
+
+				AssertThat(store.adopt(text), IsTrue());
+				AssertThat(store.count(), Equals(1));
+				AssertThat(text->content().toStdString(), Equals("Hello"));
+				AssertThat(text->people(), Equals(&sue));
+				AssertThat(text->timeOut(), Equals(2000));
+
+				AssertThat(store.adopt(text), IsTrue());
+				AssertThat(store.count(), Equals(1));
+
+				PhStripStore otherStore;
+				AssertThat(otherStore.adopt(text), IsFalse());
+			});
+		});
+		describe("index", [&]() {
+			PhStripStore store;
+			PhStripIndex<PhStripText> index;
+
+			// Join the positions or the contents to compare them at once
+			auto positions = [](QVector<int> list) {
+				QStringList result;
+				foreach(int i, list)
+					result.append(QString::number(i));
+				return result.join(",").toStdString();
+			};
+			auto contents = [](QList<PhStripText *> list) {
+				QStringList result;
+				foreach(PhStripText *text, list)
+					result.append(text->content());
+				return result.join(",").toStdString();
+			};
+
+			before_each([&](){
+				index.clear();
+				store.clear();
+
+				// A and C last more than PHSTRIPINDEX_LONG_DURATION, they are inserted out of order
+				index.insert(store.createText(500000, NULL, 510000, 0, "D", 0.25f));
+				index.insert(store.createText(0, NULL, 1000000, 0, "A", 0.25f));
+				index.insert(store.createText(900000, NULL, 905000, 0, "E", 0.25f));
+				index.insert(store.createText(200000, NULL, 700000, 0, "C", 0.25f));
+				index.insert(store.createText(100000, NULL, 110000, 0, "B", 0.25f));
+			});
+
+			it("index_insert", [&](){
+				AssertThat(contents(index.objects()), Equals("A,B,C,D,E"));
+				AssertThat(index.timeOut(2), Equals(700000));
+			});
+
+			it("index_overlapping_positions", [&](){
+				AssertThat(positions(index.overlappingPositions(600000, 650000)), Equals("0,2"));
+				AssertThat(positions(index.overlappingPositions(505000, 505000)), Equals("0,2,3"));
+				AssertThat(positions(index.overlappingPositions(950000, 960000)), Equals("0"));
+				AssertThat(positions(index.overlappingPositions(105000, 200000)), Equals("0,1,2"));
+				AssertThat(positions(index.overlappingPositions(1000001, 2000000)), Equals(""));
+
+				// A long object inserted between the others shifts the following ones
+				index.insert(store.createText(150000, NULL, 900000, 0, "F", 0.25f));
+				AssertThat(contents(index.objects()), Equals("A,B,F,C,D,E"));
+				AssertThat(positions(index.overlappingPositions(800000, 800000)), Equals("0,2"));
+				AssertThat(positions(index.overlappingPositions(505000, 505000)), Equals("0,2,3,4"));
+			});
+
+			it("index_overlapping_like_a_scan", [&](){
+				index.insert(store.createText(150000, NULL, 900000, 0, "F", 0.25f));
+				for(PhTime timeIn = -100000; timeIn < 1100000; timeIn += 25000) {
+					foreach(PhTime duration, QList<PhTime>() << 0 << 30000 << 300000) {
+						PhTime timeOut = timeIn + duration;
+						QVector<int> expected;
+						for(int i = 0; i < index.count(); i++) {
+							if((index.timeIn(i) <= timeOut) && (index.timeOut(i) >= timeIn))
+								expected.append(i);
+						}
+						AssertThat(positions(index.overlappingPositions(timeIn, timeOut)), Equals(positions(expected)));
+					}
+				}
+			});
+
+			it("index_within", [&](){
+				AssertThat(contents(index.within(100000, 600000)), Equals("B,D"));
+				AssertThat(contents(index.within(0, 2000000)), Equals("A,B,C,D,E"));
+				AssertThat(contents(index.within(0, 1000000)), Equals("B,C,D,E"));
+				AssertThat(contents(index.within(120000, 190000)), Equals(""));
+			});
+		});
 		//void StripDocTest::openStripFileTest()
 		//{
 		//	PhStripDoc doc;
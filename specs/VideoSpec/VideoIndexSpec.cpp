@@ -0,0 +1,139 @@
+/**
+ * Copyright (C) 2012-2014 Phonations
+ * License: http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include <QFile>
+
+#include "PhTools/PhDebug.h"
+
+#include "PhVideo/PhVideoIndex.h"
+
+#include "PhSpec.h"
+
+using namespace bandit;
+
+go_bandit([](){
+	describe("video_index_test", [](){
+		PhVideoIndex *index;
+
+		before_each([&](){
+			PhDebug::disable();
+			index = new PhVideoIndex();
+		});
+
+		after_each([&](){
+			delete index;
+		});
+
+		it("is_empty_by_default", [&](){
+			AssertThat(index->ready(), IsFalse());
+			AssertThat(index->frameCount(), Equals(0));
+			AssertThat(index->frameTime(960), Equals(0));
+		});
+
+		it("build", [&](){
+			index->build("interlace_%03d.bmp");
+			index->wait();
+
+			AssertThat(index->ready(), IsTrue());
+			AssertThat(index->frameCount(), Equals(200));
+
+			// Each picture is a keyframe at 25 fps
+			AssertThat(index->frameTime(0), Equals(0));
+			AssertThat(index->frameTime(959), Equals(0));
+			AssertThat(index->frameTime(960), Equals(960));
+			AssertThat(index->frameTime(20 * 960 + 500), Equals(20 * 960));
+			AssertThat(index->keyframeTime(75 * 960 + 10), Equals(75 * 960));
+			AssertThat(index->frameTime(1000 * 960), Equals(199 * 960));
+		});
+
+		it("clear", [&](){
+			index->build("interlace_%03d.bmp");
+			index->clear();
+
+			AssertThat(index->ready(), IsFalse());
+			AssertThat(index->frameCount(), Equals(0));
+		});
+
+		it("fail_with_bad_file", [&](){
+			index->build("bad_file.mov");
+			index->wait();
+
+			AssertThat(index->ready(), IsFalse());
+		});
+
+		describe("cache", [&](){
+			QString fileName = "video_index_cache.bmp";
+
+			// The packets are read only when the cache can't be used
+			auto scanned = [](PhVideoIndex &videoIndex) {
+				return videoIndex.isRunning() || videoIndex.isFinished();
+			};
+
+			before_each([&](){
+				QFile::remove(fileName);
+				QFile::remove(PhVideoIndex::cacheFileName(fileName));
+				AssertThat(QFile::copy("interlace_000.bmp", fileName), IsTrue());
+
+				index->build(fileName);
+				index->wait();
+				AssertThat(scanned(*index), IsTrue());
+				AssertThat(index->ready(), IsTrue());
+			});
+
+			after_each([&](){
+				QFile::remove(fileName);
+				QFile::remove(PhVideoIndex::cacheFileName(fileName));
+			});
+
+			it("save_and_load", [&](){
+				AssertThat(QFile::exists(PhVideoIndex::cacheFileName(fileName)), IsTrue());
+
+				PhVideoIndex cachedIndex;
+				cachedIndex.build(fileName);
+
+				AssertThat(scanned(cachedIndex), IsFalse());
+				AssertThat(cachedIndex.ready(), IsTrue());
+				AssertThat(cachedIndex.frameCount(), Equals(index->frameCount()));
+				AssertThat(cachedIndex.frameTime(960), Equals(index->frameTime(960)));
+				AssertThat(cachedIndex.keyframeTime(960), Equals(index->keyframeTime(960)));
+				AssertThat(cachedIndex.maxKeyframeInterval(), Equals(index->maxKeyframeInterval()));
+			});
+
+			it("invalidate_on_size_change", [&](){
+				QFile file(fileName);
+				AssertThat(file.open(QIODevice::Append), IsTrue());
+				file.write("0");
+				file.close();
+
+				PhVideoIndex rebuiltIndex;
+				rebuiltIndex.build(fileName);
+				AssertThat(scanned(rebuiltIndex), IsTrue());
+				rebuiltIndex.wait();
+
+				// The new index replaces the outdated one in the cache
+				PhVideoIndex cachedIndex;
+				cachedIndex.build(fileName);
+				AssertThat(scanned(cachedIndex), IsFalse());
+				AssertThat(cachedIndex.ready(), IsTrue());
+			});
+
+			it("invalidate_on_date_change", [&](){
+				QFile file(fileName);
+				AssertThat(file.open(QIODevice::ReadWrite), IsTrue());
+				QByteArray content = file.readAll();
+				// Some file systems store the modification date in seconds
+				QThread::msleep(1100);
+				file.seek(0);
+				file.write(content);
+				file.close();
+
+				PhVideoIndex rebuiltIndex;
+				rebuiltIndex.build(fileName);
+				AssertThat(scanned(rebuiltIndex), IsTrue());
+				rebuiltIndex.wait();
+			});
+		});
+	});
+});
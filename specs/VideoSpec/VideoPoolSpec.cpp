@@ -0,0 +1,147 @@
+/**
+ * Copyright (C) 2012-2014 Phonations
+ * License: http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include "PhTools/PhDebug.h"
+
+#include "PhVideo/PhVideoPool.h"
+
+#include "PhSpec.h"
+
+using namespace bandit;
+
+go_bandit([](){
+	describe("video_pool_test", [](){
+		PhVideoPool *pool;
+
+		// Decode a frame as the decoder would
+		auto decode = [&](PhFrame frame) {
+			PhVideoBuffer *buffer = pool->takeFreeBuffer();
+			buffer->setFrame(frame);
+			pool->insert(buffer);
+		};
+
+		before_each([&](){
+			PhDebug::disable();
+			pool = new PhVideoPool(4);
+		});
+
+		after_each([&](){
+			delete pool;
+		});
+
+		it("is_empty_by_default", [&](){
+			AssertThat(pool->count(), Equals(0));
+			AssertThat(pool->nextMissingFrame(), Equals(PHFRAMEMIN));
+		});
+
+		it("give_the_next_missing_frame_forward", [&](){
+			pool->setCapacity(8);
+			pool->setWindow(10, 0, 40, 14);
+			AssertThat(pool->nextMissingFrame(), Equals(10));
+
+			decode(10);
+			AssertThat(pool->nextMissingFrame(), Equals(11));
+			decode(12);
+			AssertThat(pool->nextMissingFrame(), Equals(11));
+			decode(11);
+			AssertThat(pool->nextMissingFrame(), Equals(13));
+			decode(13);
+			decode(14);
+			AssertThat(pool->nextMissingFrame(), Equals(PHFRAMEMIN));
+		});
+
+		it("give_the_next_missing_frame_backward", [&](){
+			pool->setWindow(20, 0, 40, 17);
+			AssertThat(pool->nextMissingFrame(), Equals(20));
+
+			decode(20);
+			decode(19);
+			AssertThat(pool->nextMissingFrame(), Equals(18));
+			decode(17);
+			AssertThat(pool->nextMissingFrame(), Equals(18));
+			decode(18);
+			AssertThat(pool->nextMissingFrame(), Equals(PHFRAMEMIN));
+		});
+
+		it("evict_by_priority", [&](){
+			pool->setWindow(10, 8, 20, 12);
+			pool->setPinnedRange(100, 110);
+
+			decode(50);
+			decode(51);
+			decode(101);
+			decode(105);
+			AssertThat(pool->count(), Equals(4));
+
+			// The least recently used frame out of the window and the pinned range goes first
+			decode(11);
+			AssertThat(pool->contains(50), IsFalse());
+			AssertThat(pool->contains(51), IsTrue());
+			decode(18);
+			AssertThat(pool->contains(51), IsFalse());
+
+			// Then the frame of the window the farthest from the playhead
+			decode(12);
+			AssertThat(pool->contains(18), IsFalse());
+			decode(9);
+			AssertThat(pool->contains(12), IsFalse());
+			AssertThat(pool->contains(11), IsTrue());
+			AssertThat(pool->contains(9), IsTrue());
+
+			// The frames left out of the window are evicted before the pinned ones
+			pool->setWindow(200, 200, 210, 200);
+			pool->setCapacity(2);
+			AssertThat(pool->contains(11), IsFalse());
+			AssertThat(pool->contains(9), IsFalse());
+
+			// Finally the end of the pinned range
+			pool->setCapacity(1);
+			AssertThat(pool->contains(105), IsFalse());
+			AssertThat(pool->contains(101), IsTrue());
+
+			// A frame being read is not evicted
+			PhVideoBuffer *buffer = pool->acquire(101);
+			pool->setCapacity(0);
+			AssertThat(pool->contains(101), IsTrue());
+			pool->release(buffer);
+		});
+
+		it("evict_the_least_recently_used", [&](){
+			pool->setCapacity(2);
+			pool->setWindow(0, 0, 0, PHFRAMEMIN);
+
+			decode(50);
+			decode(51);
+			pool->release(pool->acquire(50));
+			decode(52);
+
+			AssertThat(pool->contains(50), IsTrue());
+			AssertThat(pool->contains(51), IsFalse());
+			AssertThat(pool->contains(52), IsTrue());
+		});
+
+		it("drop_the_frames_decoded_before_clear", [&](){
+			PhVideoBuffer *buffer = pool->takeFreeBuffer();
+			buffer->setFrame(5);
+			pool->clear();
+			pool->insert(buffer);
+
+			AssertThat(pool->contains(5), IsFalse());
+			AssertThat(pool->count(), Equals(0));
+
+			// The buffer is reused
+			AssertThat(pool->takeFreeBuffer(), Equals(buffer));
+			buffer->setFrame(6);
+			pool->insert(buffer);
+			AssertThat(pool->contains(6), IsTrue());
+
+			// A duplicate is dropped too
+			decode(6);
+			AssertThat(pool->count(), Equals(1));
+			AssertThat(pool->acquire(6), Equals(buffer));
+			pool->release(buffer);
+		});
+	});
+});
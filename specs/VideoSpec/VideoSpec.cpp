@@ -5,35 +5,37 @@
 
 #include "PhTools/PhDebug.h"
 #include "PhTools/PhPictureTools.h"
-#include "PhGraphic/PhGraphicView.h"
+#include "PhGraphic/PhGraphicOffscreen.h"
 
 #include "PhVideo/PhVideoEngine.h"
 
 #include "VideoSpecSettings.h"
 
-#define FRAME_WAIT_TIME 40
-
 #include "PhSpec.h"
 
 using namespace bandit;
 
 go_bandit([](){
 	describe("video_test", [](){
-		PhGraphicView *view;
+		PhGraphicOffscreen *offscreen;
 		PhVideoEngine *engine;
 		VideoSpecSettings settings;
 
+		// Render the frame corresponding to the clock once it is decoded
+		auto render = [&]() {
+			engine->waitForFrame();
+			return offscreen->render();
+		};
+
 		before_each([&](){
 			PhDebug::disable();
 
-			view = new PhGraphicView(64, 64);
+			offscreen = new PhGraphicOffscreen(64, 64);
 			engine = new PhVideoEngine(&settings);
 
-			view->show();
-
 			engine->setBilinearFiltering(false);
 
-			QObject::connect(view, &PhGraphicView::paint, [&](int w, int h) {
+			QObject::connect(offscreen, &PhGraphicOffscreen::paint, [&](int w, int h) {
 				engine->drawVideo(0, 0, w, h);
 			});
 		});
@@ -42,45 +44,37 @@ go_bandit([](){
 			engine->close();
 
 			delete engine;
-			delete view;
+			delete offscreen;
 		});
 
 		it("open_video", [&](){
 			AssertThat(engine->open("interlace_%03d.bmp"), IsTrue());
-
-			QThread::msleep(FRAME_WAIT_TIME);
 		});
 
 		it("default_framerate", [&](){
 			AssertThat(engine->open("interlace_%03d.bmp"), IsTrue());
 
-			QThread::msleep(FRAME_WAIT_TIME);
-
 			AssertThat(engine->framePerSecond(), Equals(25.00f));
 		});
 
 		it("go_to_01", [&](){
 			AssertThat(engine->open("interlace_%03d.bmp"), IsTrue());
 
-			QThread::msleep(FRAME_WAIT_TIME);
-			QImage result = view->renderPixmap(64, 64).toImage();
+			QImage result = render();
 			result.save("result.bmp");
 			AssertThat(result == QImage("interlace_000.bmp"), IsTrue());
 
 			engine->clock()->setFrame(20, PhTimeCodeType25);
 
-			QThread::msleep(FRAME_WAIT_TIME);
-			AssertThat(view->renderPixmap(64, 64).toImage() == QImage("interlace_020.bmp"), IsTrue());
+			AssertThat(render() == QImage("interlace_020.bmp"), IsTrue());
 
 			engine->clock()->setFrame(100, PhTimeCodeType25);
 
-			QThread::msleep(FRAME_WAIT_TIME);
-			AssertThat(view->renderPixmap(64, 64).toImage() == QImage("interlace_100.bmp"), IsTrue());
+			AssertThat(render() == QImage("interlace_100.bmp"), IsTrue());
 
 			engine->clock()->setFrame(75, PhTimeCodeType25);
 
-			QThread::msleep(FRAME_WAIT_TIME);
-			AssertThat(view->renderPixmap(64, 64).toImage() == QImage("interlace_075.bmp"), IsTrue());
+			AssertThat(render() == QImage("interlace_075.bmp"), IsTrue());
 		});
 
 		it("go_to_02", [&](){
@@ -88,24 +82,21 @@ go_bandit([](){
 
 			engine->clock()->setFrame(100, PhTimeCodeType25);
 
-			QThread::msleep(FRAME_WAIT_TIME);
-			AssertThat(view->renderPixmap(64, 64).toImage() == QImage("interlace_100.bmp"), IsTrue());
+			AssertThat(render() == QImage("interlace_100.bmp"), IsTrue());
 
 			engine->clock()->setFrame(99, PhTimeCodeType25);
 
 			PHDEBUG << "second paint";
 
-			QThread::msleep(FRAME_WAIT_TIME);
-			AssertThat(view->renderPixmap(64, 64).toImage() == QImage("interlace_099.bmp"), IsTrue());
+			AssertThat(render() == QImage("interlace_099.bmp"), IsTrue());
 
 			for(int i = 75; i >= 50; i--) {
 				engine->clock()->setFrame(i, PhTimeCodeType25);
 
 				qDebug() << "Set frame :" << i;
 
-				QThread::msleep(FRAME_WAIT_TIME);
 				QString name = QString("interlace_%1.bmp").arg(i, 3, 10, QChar('0'));
-				AssertThat(view->renderPixmap(64, 64).toImage() == QImage(name), IsTrue());
+				AssertThat(render() == QImage(name), IsTrue());
 			}
 		});
 
@@ -126,70 +117,60 @@ go_bandit([](){
 				PhFrame frame = list[i];
 				engine->clock()->setFrame(frame, PhTimeCodeType25);
 
-				QThread::msleep(FRAME_WAIT_TIME);
 				QString name = QString("interlace_%1.bmp").arg(frame, 3, 10, QChar('0'));
-				AssertThat(view->renderPixmap(64, 64).toImage() == QImage(name), IsTrue());
+				AssertThat(render() == QImage(name), IsTrue());
 			}
 		});
 
 		it("play", [&](){
 			AssertThat(engine->open("interlace_%03d.bmp"), IsTrue());
 
-			QThread::msleep(FRAME_WAIT_TIME);
-			AssertThat(view->renderPixmap(64, 64).toImage() == QImage("interlace_000.bmp"), IsTrue());
+			AssertThat(render() == QImage("interlace_000.bmp"), IsTrue());
 
 			engine->clock()->setRate(1);
 			engine->clock()->elapse(960); // 1 frame at 25 fps
 
-			QThread::msleep(FRAME_WAIT_TIME);
-			AssertThat(view->renderPixmap(64, 64).toImage() == QImage("interlace_001.bmp"), IsTrue());
+			AssertThat(render() == QImage("interlace_001.bmp"), IsTrue());
 
 
 			// Play 1 second
 			for(int i = 0; i < 25; i++) {
 				engine->clock()->elapse(960); // 1 frame at 25 fps
-				QThread::msleep(FRAME_WAIT_TIME);
 			}
 
-			AssertThat(view->renderPixmap(64, 64).toImage() == QImage("interlace_026.bmp"), IsTrue());
+			AssertThat(render() == QImage("interlace_026.bmp"), IsTrue());
 
 			engine->clock()->setRate(-1);
 			engine->clock()->elapse(960); // 1 frame at 25 fps
-			QThread::msleep(FRAME_WAIT_TIME);
-			AssertThat(view->renderPixmap(64, 64).toImage() == QImage("interlace_025.bmp"), IsTrue());
+			AssertThat(render() == QImage("interlace_025.bmp"), IsTrue());
 
 			// Play 1 second
 			for(int i = 24; i >= 0; i--) {
 				engine->clock()->elapse(960); // 1 frame at 25 fps
-				QThread::msleep(FRAME_WAIT_TIME);
 			}
-			AssertThat(view->renderPixmap(64, 64).toImage() == QImage("interlace_000.bmp"), IsTrue());
+			AssertThat(render() == QImage("interlace_000.bmp"), IsTrue());
 		});
 
 		it("deinterlace", [&](){
 			//Open the video file in interlaced mode
 			engine->open("interlace_%03d.bmp");
-			QThread::msleep(FRAME_WAIT_TIME);
-			AssertThat(view->renderPixmap(64, 64).toImage() == QImage("interlace_000.bmp"), IsTrue());
+			AssertThat(render() == QImage("interlace_000.bmp"), IsTrue());
 
 			//Change mode to deinterlaced
 			engine->setDeinterlace(true);
-			QThread::msleep(FRAME_WAIT_TIME);
-			AssertThat(view->renderPixmap(64, 64).toImage() == QImage("deinterlace_000.bmp"), IsTrue());
+			AssertThat(render() == QImage("deinterlace_000.bmp"), IsTrue());
 
 			//Move one picture forward
 			engine->clock()->setFrame(1, PhTimeCodeType25);
-			QThread::msleep(FRAME_WAIT_TIME);
-			AssertThat(view->renderPixmap(64, 64).toImage() == QImage("deinterlace_001.bmp"), IsTrue());
+			AssertThat(render() == QImage("deinterlace_001.bmp"), IsTrue());
 
 			//Go back to interlaced mode
 			engine->setDeinterlace(false);
-			QThread::msleep(FRAME_WAIT_TIME);
-			AssertThat(view->renderPixmap(64, 64).toImage() == QImage("interlace_001.bmp"), IsTrue());
+			AssertThat(render() == QImage("interlace_001.bmp"), IsTrue());
 		});
 
 		//		it("saveBuffer(QString fileName) {
-		//		   QImage test = view->renderPixmap(64, 64).toImage();
+		//		   QImage test = render();
 		//		test.save(fileName);
 		//		system(PHNQ(QString("open %0").arg(fileName)));
 		//	}
@@ -6,6 +6,8 @@
 
 include($$TOP_ROOT/libs/PhVideo/PhVideo.pri)
 
-SOURCES += $$TOP_ROOT/specs/VideoSpec/VideoSpec.cpp
+SOURCES += $$TOP_ROOT/specs/VideoSpec/VideoSpec.cpp \
+	$$TOP_ROOT/specs/VideoSpec/VideoIndexSpec.cpp \
+	$$TOP_ROOT/specs/VideoSpec/VideoPoolSpec.cpp
 
 QMAKE_POST_LINK += $${QMAKE_COPY} $$shell_path($${TOP_ROOT}/data/img/video/*.bmp) . $${CS}
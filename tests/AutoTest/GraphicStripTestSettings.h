@@ -53,6 +53,15 @@ public:
 	int textBoldness() {
 		return 1;
 	}
+	bool textDistanceField() {
+		return false;
+	}
+	bool tiledStrip() {
+		return false;
+	}
+	bool gpuStrip() {
+		return false;
+	}
 	bool stripTestMode() {
 		return false;
 	}
@@ -28,6 +28,9 @@ public:
 	PH_SETTING_STRING2(setHudFontFile, hudFontFile, QApplication::applicationDirPath() + PATH_TO_RESSOURCES + "/HelveticaCYPlain.ttf")
 	PH_SETTING_STRING2(setTextFontFile, textFontFile, QApplication::applicationDirPath() + PATH_TO_RESSOURCES + "/SWENSON.TTF")
 	PH_SETTING_INT2(setTextBoldness, textBoldness, 1)
+	PH_SETTING_BOOL(setTextDistanceField, textDistanceField)
+	PH_SETTING_BOOL(setTiledStrip, tiledStrip)
+	PH_SETTING_BOOL(setGpuStrip, gpuStrip)
 	PH_SETTING_BOOL(setStripTestMode, stripTestMode)
 	PH_SETTING_BOOL2(setDisplayNextText, displayNextText, true)
 	PH_SETTING_BOOL(setHideSelectedPeoples, hideSelectedPeoples)
@@ -0,0 +1,225 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QProcess>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+#include "PhSync/PhTimeCode.h"
+
+#include "StripBenchmark.h"
+
+/** The size of the picture of each role, as written by Cappella (in byte) */
+#define STRIPBENCHMARK_IMAGE_SIZE 3000
+
+bool StripBenchmark::generate(QString fileName, int lineCount, int roleCount, uint seed)
+{
+	QFile file(fileName);
+	if(!file.open(QIODevice::WriteOnly))
+		return false;
+
+	qsrand(seed);
+	PhTimeCodeType tcType = PhTimeCodeType25;
+	PhTime frame = PhTimeCode::timePerFrame(tcType);
+	PhTime timeIn = PhTimeCode::timeFromString("01:00:00:00", tcType);
+
+	QXmlStreamWriter xml(&file);
+	xml.setAutoFormatting(true);
+	xml.writeStartDocument();
+	xml.writeStartElement("detx");
+
+	xml.writeStartElement("header");
+	xml.writeEmptyElement("cappella");
+	xml.writeAttribute("version", "3.5.0, 1");
+	xml.writeTextElement("title", "Benchmark");
+	xml.writeStartElement("videofile");
+	xml.writeAttribute("timestamp", PhTimeCode::stringFromTime(timeIn, tcType));
+	xml.writeCharacters("benchmark.mov");
+	xml.writeEndElement();
+	xml.writeEndElement();
+
+	xml.writeStartElement("roles");
+	QString image(STRIPBENCHMARK_IMAGE_SIZE, 'A');
+	for(int i = 0; i < roleCount; i++) {
+		xml.writeStartElement("role");
+		xml.writeAttribute("color", QString("#%1").arg(qrand() % 0x1000000, 6, 16, QChar('0')));
+		xml.writeAttribute("id", QString("role%1").arg(i));
+		xml.writeAttribute("name", QString("Role %1").arg(i));
+		xml.writeTextElement("image", image);
+		xml.writeEndElement();
+	}
+	xml.writeEndElement();
+
+	xml.writeStartElement("body");
+	PhTime time = timeIn;
+	PhTime nextLoopTime = timeIn;
+	for(int i = 0; i < lineCount; i++) {
+		// A loop per minute and a shot every few lines
+		if(time >= nextLoopTime) {
+			xml.writeEmptyElement("loop");
+			xml.writeAttribute("timecode", PhTimeCode::stringFromTime(time, tcType));
+			nextLoopTime += 60 * 24000;
+		}
+		if(qrand() % 4 == 0) {
+			xml.writeEmptyElement("shot");
+			xml.writeAttribute("timecode", PhTimeCode::stringFromTime(time, tcType));
+		}
+
+		xml.writeStartElement("line");
+		xml.writeAttribute("role", QString("role%1").arg(qrand() % roleCount));
+		xml.writeAttribute("track", QString::number(qrand() % 4));
+		if(qrand() % 5 == 0)
+			xml.writeAttribute("voice", "off");
+
+		int textCount = 1 + qrand() % 3;
+		xml.writeEmptyElement("lipsync");
+		xml.writeAttribute("timecode", PhTimeCode::stringFromTime(time, tcType));
+		xml.writeAttribute("type", "in_open");
+		for(int j = 0; j < textCount; j++) {
+			xml.writeTextElement("text", QString("Sentence %1 of the line %2 ").arg(j).arg(i));
+			time += (10 + qrand() % 40) * frame;
+			xml.writeEmptyElement("lipsync");
+			xml.writeAttribute("timecode", PhTimeCode::stringFromTime(time, tcType));
+			xml.writeAttribute("type", (j == textCount - 1) ? "out_open" : "neutral");
+		}
+		xml.writeEndElement();
+
+		time += (qrand() % 50) * frame;
+	}
+	xml.writeEndElement();
+
+	xml.writeEndElement();
+	xml.writeEndDocument();
+
+	return !xml.hasError();
+}
+
+QJsonObject StripBenchmark::measure(QString fileName, int runCount, bool dom)
+{
+	QJsonObject result;
+	qint64 peakBefore = peakMemory();
+	QJsonArray durations;
+	double total = 0, best = 0;
+	int textCount = 0;
+	for(int i = 0; i < runCount; i++) {
+		PhStripDoc doc;
+		QElapsedTimer timer;
+		timer.start();
+		bool success = dom ? doc.importDetXDomFile(fileName) : doc.importDetXFile(fileName);
+		double duration = timer.nsecsElapsed() / 1e6;
+		if(!success) {
+			result["error"] = QString("Unable to import %1").arg(fileName);
+			return result;
+		}
+		durations.append(duration);
+		total += duration;
+		if((i == 0) || (duration < best))
+			best = duration;
+		textCount = doc.texts().count();
+	}
+
+	result["texts"] = textCount;
+	result["durations"] = durations;
+	result["mean"] = runCount ? total / runCount : 0;
+	result["min"] = best;
+	if(peakBefore >= 0) {
+		qint64 peakAfter = peakMemory();
+		result["peakMemory"] = static_cast<double>(peakAfter);
+		result["peakMemoryIncrease"] = static_cast<double>(peakAfter - peakBefore);
+	}
+	return result;
+}
+
+QJsonObject StripBenchmark::measureInProcess(QString fileName, int runCount, bool dom)
+{
+	QStringList args;
+	args << "--measure" << (dom ? "dom" : "stream") << "--runs" << QString::number(runCount) << fileName;
+
+	QProcess process;
+	process.start(QCoreApplication::applicationFilePath(), args);
+	if(!process.waitForFinished(-1) || (process.exitStatus() != QProcess::NormalExit) || process.exitCode()) {
+		QJsonObject result;
+		result["error"] = QString("The measure process failed: %1").arg(QString(process.readAllStandardError()));
+		return result;
+	}
+
+	return QJsonDocument::fromJson(process.readAllStandardOutput()).object();
+}
+
+QString StripBenchmark::streamError(QString fileName)
+{
+	QFile file(fileName);
+	if(!file.open(QIODevice::ReadOnly))
+		return file.errorString();
+
+	// The same errors stop importDetXFile() since it reads the whole document
+	QXmlStreamReader xml(&file);
+	while(!xml.atEnd())
+		xml.readNext();
+	if(xml.hasError())
+		return QString("line %1: %2").arg(xml.lineNumber()).arg(xml.errorString());
+	return "";
+}
+
+bool StripBenchmark::compare(QString fileName)
+{
+	PhStripDoc streamDoc, domDoc;
+	if(!streamDoc.importDetXFile(fileName) || !domDoc.importDetXDomFile(fileName))
+		return false;
+
+	if((streamDoc.title() != domDoc.title()) || (streamDoc.videoTimeIn() != domDoc.videoTimeIn()))
+		return false;
+
+	if(streamDoc.peoples().count() != domDoc.peoples().count())
+		return false;
+	for(int i = 0; i < streamDoc.peoples().count(); i++) {
+		if(streamDoc.peoples()[i]->name() != domDoc.peoples()[i]->name())
+			return false;
+	}
+
+	QList<PhStripText *> streamTexts = streamDoc.texts(), domTexts = domDoc.texts();
+	if(streamTexts.count() != domTexts.count())
+		return false;
+	for(int i = 0; i < streamTexts.count(); i++) {
+		if((streamTexts[i]->timeIn() != domTexts[i]->timeIn())
+		   || (streamTexts[i]->timeOut() != domTexts[i]->timeOut())
+		   || (streamTexts[i]->content() != domTexts[i]->content())
+		   || (streamTexts[i]->y() != domTexts[i]->y()))
+			return false;
+	}
+
+	QList<PhStripDetect *> streamDetects = streamDoc.detects(), domDetects = domDoc.detects();
+	if(streamDetects.count() != domDetects.count())
+		return false;
+	for(int i = 0; i < streamDetects.count(); i++) {
+		if((streamDetects[i]->timeIn() != domDetects[i]->timeIn())
+		   || (streamDetects[i]->timeOut() != domDetects[i]->timeOut())
+		   || (streamDetects[i]->type() != domDetects[i]->type()))
+			return false;
+	}
+
+	return (streamDoc.loops().count() == domDoc.loops().count())
+	       && (streamDoc.cuts().count() == domDoc.cuts().count());
+}
+
+qint64 StripBenchmark::peakMemory()
+{
+	// Only available on Linux
+	QFile file("/proc/self/status");
+	if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return -1;
+
+	foreach(QByteArray line, file.readAll().split('\n')) {
+		if(line.startsWith("VmHWM:"))
+			return line.mid(6).trimmed().split(' ').first().toLongLong() * 1024;
+	}
+	return -1;
+}
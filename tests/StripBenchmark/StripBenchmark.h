@@ -0,0 +1,78 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef STRIPBENCHMARK_H
+#define STRIPBENCHMARK_H
+
+#include <QJsonObject>
+
+#include "PhStrip/PhStripDoc.h"
+
+/**
+ * @brief Compare the DetX importers of PhStripDoc
+ *
+ * The streaming importer (PhStripDoc::importDetXFile()) and the DOM one
+ * (PhStripDoc::importDetXDomFile()) import the same file several times.
+ * Each measure returns a JSON object with the import durations and the
+ * growth of the process peak memory. The peak memory of a process never
+ * decreases, so each importer is measured in its own process
+ * (see measureInProcess()).
+ */
+class StripBenchmark
+{
+public:
+	/**
+	 * @brief Write a DetX file similar to the ones of a long series
+	 * @param fileName The file path
+	 * @param lineCount The number of lines (a detect and one to three texts each)
+	 * @param roleCount The number of roles
+	 * @param seed The random generator seed
+	 * @return True if the file was written, false otherwise
+	 */
+	static bool generate(QString fileName, int lineCount, int roleCount, uint seed);
+
+	/**
+	 * @brief Measure an importer
+	 * @param fileName A DetX file path
+	 * @param runCount The number of imports
+	 * @param dom True for the DOM importer, false for the streaming one
+	 * @return A JSON object
+	 */
+	static QJsonObject measure(QString fileName, int runCount, bool dom);
+
+	/**
+	 * @brief Measure an importer in a child process
+	 *
+	 * The child is this executable started with the --measure option.
+	 * @param fileName A DetX file path
+	 * @param runCount The number of imports
+	 * @param dom True for the DOM importer, false for the streaming one
+	 * @return A JSON object
+	 */
+	static QJsonObject measureInProcess(QString fileName, int runCount, bool dom);
+
+	/**
+	 * @brief Check if the streaming importer reads a file by itself
+	 *
+	 * PhStripDoc::importDetXFile() falls back to the DOM importer when
+	 * the stream reader refuses the file.
+	 * @param fileName A DetX file path
+	 * @return An empty string or the error of the stream reader
+	 */
+	static QString streamError(QString fileName);
+
+	/**
+	 * @brief Check that both importers give the same document
+	 * @param fileName A DetX file path
+	 * @return True if the peoples, texts, detects, loops and cuts are the same
+	 */
+	static bool compare(QString fileName);
+
+private:
+	static qint64 peakMemory();
+};
+
+#endif // STRIPBENCHMARK_H
@@ -0,0 +1,130 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include "PhTools/PhDebug.h"
+
+#include "StripBenchmark.h"
+
+static void usage()
+{
+	QTextStream(stderr) << "Usage: StripBenchmark [--lines <count>] [--roles <count>] [--runs <count>]"
+	                    << " [--seed <value>] [--output <file>] [<detx file>]\n"
+	                    << "       StripBenchmark --measure stream|dom [--runs <count>] <detx file>\n";
+}
+
+/**
+ * @brief The application main entry point
+ * @param argc Command line argument count
+ * @param argv Command line argument list
+ * @return 0 if the benchmark succeeded.
+ */
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	// The standard output is kept for the report
+	PhDebug::setLogMask(0);
+
+	int lineCount = 50000;
+	int roleCount = 40;
+	int runCount = 3;
+	uint seed = 0;
+	QString outputFileName;
+	QString fileName;
+	QString measuredImporter;
+
+	QStringList args = app.arguments();
+	for(int i = 1; i < args.count(); i++) {
+		QString arg = args[i];
+		bool hasValue = (i + 1 < args.count());
+		if((arg == "--lines") && hasValue)
+			lineCount = args[++i].toInt();
+		else if((arg == "--roles") && hasValue)
+			roleCount = qMax(1, args[++i].toInt());
+		else if((arg == "--runs") && hasValue)
+			runCount = qMax(1, args[++i].toInt());
+		else if((arg == "--seed") && hasValue)
+			seed = args[++i].toUInt();
+		else if((arg == "--output") && hasValue)
+			outputFileName = args[++i];
+		else if((arg == "--measure") && hasValue)
+			measuredImporter = args[++i];
+		else if(!arg.startsWith("--") && fileName.isEmpty())
+			fileName = arg;
+		else {
+			usage();
+			return 1;
+		}
+	}
+
+	// Child process started by StripBenchmark::measureInProcess()
+	if(!measuredImporter.isEmpty()) {
+		if(fileName.isEmpty() || ((measuredImporter != "stream") && (measuredImporter != "dom"))) {
+			usage();
+			return 1;
+		}
+		QJsonObject result = StripBenchmark::measure(fileName, runCount, measuredImporter == "dom");
+		QTextStream(stdout) << QJsonDocument(result).toJson();
+		return result.contains("error") ? 3 : 0;
+	}
+
+	QTemporaryDir dir;
+	QJsonObject report;
+	if(fileName.isEmpty()) {
+		fileName = dir.path() + "/benchmark.detx";
+		if(!dir.isValid() || !StripBenchmark::generate(fileName, lineCount, roleCount, seed)) {
+			QTextStream(stderr) << "Unable to generate " << fileName << "\n";
+			return 2;
+		}
+		report["lines"] = lineCount;
+		report["roles"] = roleCount;
+		report["seed"] = static_cast<double>(seed);
+	}
+	else if(!QFile::exists(fileName)) {
+		QTextStream(stderr) << "Unable to open " << fileName << "\n";
+		return 2;
+	}
+
+	report["file"] = fileName;
+	report["fileSize"] = static_cast<double>(QFileInfo(fileName).size());
+
+	// The streaming importer measures the DOM one on the files it refuses
+	QString streamError = StripBenchmark::streamError(fileName);
+	report["streamFallback"] = !streamError.isEmpty();
+	if(!streamError.isEmpty())
+		report["streamError"] = streamError;
+
+	// Each importer runs in a fresh process: the peak memory never decreases
+	QJsonObject stream = StripBenchmark::measureInProcess(fileName, runCount, false);
+	QJsonObject dom = StripBenchmark::measureInProcess(fileName, runCount, true);
+	report["stream"] = stream;
+	report["dom"] = dom;
+	if(stream["min"].toDouble() > 0)
+		report["speedup"] = dom["min"].toDouble() / stream["min"].toDouble();
+
+	report["identical"] = StripBenchmark::compare(fileName);
+
+	QByteArray json = QJsonDocument(report).toJson();
+	if(outputFileName.isEmpty()) {
+		QTextStream(stdout) << json;
+		return 0;
+	}
+
+	QFile file(outputFileName);
+	if(!file.open(QIODevice::WriteOnly)) {
+		QTextStream(stderr) << "Unable to write " << outputFileName << "\n";
+		return 4;
+	}
+	file.write(json);
+
+	return 0;
+}
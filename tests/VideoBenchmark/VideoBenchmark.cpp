@@ -0,0 +1,308 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtMath>
+
+#include "PhTools/PhDebug.h"
+
+#include "VideoBenchmark.h"
+
+/** Time after which a frame request is considered as failed (in millisecond) */
+#define VIDEOBENCHMARK_FRAME_TIMEOUT 10000
+/** Time after which the benchmark stops waiting for the keyframe index (in millisecond) */
+#define VIDEOBENCHMARK_INDEX_TIMEOUT 120000
+
+VideoBenchmark::VideoBenchmark(int readhead) :
+	_readhead(readhead),
+	_threadCount(0),
+	_threadType(PhVideoDecoder::AutoThreading),
+	_pool(qMax(32, readhead + 1)),
+	_decoder(&_pool),
+	_lastFrame(-1),
+	_pixelBuffer(NULL),
+	_uploadCount(0),
+	_uploadTime(0)
+{
+}
+
+VideoBenchmark::~VideoBenchmark()
+{
+	_decoder.close();
+	delete _pixelBuffer;
+}
+
+bool VideoBenchmark::open(QString fileName, int threadCount, PhVideoDecoder::ThreadType threadType, bool yuvOutput, bool waitIndex)
+{
+	_fileName = fileName;
+	_threadCount = threadCount;
+	_threadType = threadType;
+	_decoder.setThreading(threadCount, threadType);
+	_decoder.setYUVOutput(yuvOutput);
+	if(!_decoder.open(fileName))
+		return false;
+
+	_lastFrame = (_decoder.length() - 1) / PhTimeCode::timePerFrame(_decoder.timeCodeType());
+
+	if(waitIndex) {
+		QElapsedTimer timer;
+		timer.start();
+		while(!_decoder.indexReady() && (timer.elapsed() < VIDEOBENCHMARK_INDEX_TIMEOUT))
+			QThread::msleep(10);
+		PHDEBUG << "index:" << _decoder.indexReady() << "in" << timer.elapsed() << "ms";
+	}
+
+	return true;
+}
+
+bool VideoBenchmark::enableUpload()
+{
+	if(!QGLPixelBuffer::hasOpenGLPbuffers())
+		return false;
+
+	// The picture is never displayed: a tiny surface is enough to get a context
+	_pixelBuffer = new QGLPixelBuffer(16, 16);
+	return _pixelBuffer->makeCurrent();
+}
+
+QJsonObject VideoBenchmark::info()
+{
+	QJsonObject result;
+	result["codec"] = _decoder.codecName();
+	result["width"] = _decoder.width();
+	result["height"] = _decoder.height();
+	result["fps"] = _decoder.framePerSecond();
+	result["frameCount"] = static_cast<double>(_lastFrame + 1);
+	result["index"] = _decoder.indexReady();
+	return result;
+}
+
+QJsonObject VideoBenchmark::measureSequential(int frameCount)
+{
+	PhFrame first = 0;
+	PhFrame last = qMin(static_cast<PhFrame>(frameCount - 1), _lastFrame);
+
+	_decoder.setRate(1);
+	_pool.clear();
+	resetStages();
+
+	QElapsedTimer timer;
+	timer.start();
+	int decoded = 0;
+	for(PhFrame frame = first; frame <= last; frame++) {
+		// Same window as PhVideoEngine when playing forward
+		_pool.setWindow(frame, frame, frame + _readhead, qMin(frame + _readhead, _lastFrame));
+		if(!waitFrame(frame))
+			break;
+		upload(frame);
+		decoded++;
+	}
+	qint64 elapsed = timer.nsecsElapsed();
+
+	QJsonObject result;
+	result["frames"] = decoded;
+	result["seconds"] = elapsed / 1e9;
+	result["fps"] = elapsed ? decoded * 1e9 / elapsed : 0;
+	result["stages"] = stages();
+	return result;
+}
+
+QJsonObject VideoBenchmark::measureSeeks(int seekCount, uint seed)
+{
+	_decoder.setRate(0);
+	resetStages();
+	qsrand(seed);
+
+	QList<double> values;
+	for(int i = 0; i < seekCount; i++) {
+		PhFrame frame = qrand() % (_lastFrame + 1);
+		_pool.clear();
+
+		QElapsedTimer timer;
+		timer.start();
+		_pool.setWindow(frame, frame, frame, frame);
+		if(!waitFrame(frame))
+			continue;
+		values.append(timer.nsecsElapsed() / 1e6);
+		upload(frame);
+	}
+
+	QJsonObject result = latencies(values);
+	result["stages"] = stages();
+	return result;
+}
+
+QJsonObject VideoBenchmark::measureReverseSteps(int stepCount)
+{
+	// Start from the middle of the file so that the steps cross several GOPs
+	PhFrame start = qMin(_lastFrame, _lastFrame / 2 + stepCount / 2);
+
+	_decoder.setRate(0);
+	_pool.clear();
+	_pool.setWindow(start, start, start, start);
+	waitFrame(start);
+	resetStages();
+
+	int capacity = _pool.capacity();
+	QList<double> values;
+	for(PhFrame frame = start - 1; (frame >= 0) && (frame > start - stepCount - 1); frame--) {
+		QElapsedTimer timer;
+		timer.start();
+		// Same window as PhVideoEngine when paused, only the current frame is requested
+		_pool.setWindow(frame, frame - (capacity - _readhead) / 2, frame + _readhead, frame);
+		if(!waitFrame(frame))
+			break;
+		values.append(timer.nsecsElapsed() / 1e6);
+		upload(frame);
+	}
+
+	QJsonObject result = latencies(values);
+	result["stages"] = stages();
+	return result;
+}
+
+QJsonObject VideoBenchmark::compareThreading(int frameCount)
+{
+	QJsonObject result;
+	QList<PhVideoDecoder::ThreadType> threadTypes;
+	threadTypes << PhVideoDecoder::AutoThreading << PhVideoDecoder::FrameThreading << PhVideoDecoder::SliceThreading;
+	foreach(PhVideoDecoder::ThreadType threadType, threadTypes) {
+		// The threading is applied when the codec is opened
+		_decoder.close();
+		_decoder.setThreading(_threadCount, threadType);
+		if(_decoder.open(_fileName))
+			result[threadTypeName(threadType)] = measureSequential(frameCount);
+	}
+
+	_decoder.close();
+	_decoder.setThreading(_threadCount, _threadType);
+	_decoder.open(_fileName);
+	return result;
+}
+
+QString VideoBenchmark::threadTypeName(PhVideoDecoder::ThreadType threadType)
+{
+	switch(threadType) {
+	case PhVideoDecoder::FrameThreading:
+		return "frame";
+	case PhVideoDecoder::SliceThreading:
+		return "slice";
+	case PhVideoDecoder::AutoThreading:
+		break;
+	}
+	return "auto";
+}
+
+bool VideoBenchmark::waitFrame(PhFrame frame)
+{
+	QElapsedTimer timer;
+	timer.start();
+	_decoder.requestDecoding();
+	while(!_pool.contains(frame)) {
+		if(timer.elapsed() > VIDEOBENCHMARK_FRAME_TIMEOUT) {
+			PHDEBUG << "unable to get" << frame;
+			return false;
+		}
+		QCoreApplication::processEvents();
+	}
+	return true;
+}
+
+void VideoBenchmark::upload(PhFrame frame)
+{
+	if(_pixelBuffer == NULL)
+		return;
+
+	PhVideoBuffer *buffer = _pool.acquire(frame);
+	if(buffer == NULL)
+		return;
+
+	QElapsedTimer timer;
+	timer.start();
+	bool uploaded;
+	if(buffer->format() == PhVideoBuffer::BGRA)
+		uploaded = _videoRect.createTextureFromBGRABuffer(buffer->rgb(), buffer->width(), buffer->height());
+	else {
+		uploaded = _yuvRect.createTextureFromYUVPlanes(buffer->plane(0), buffer->plane(1), buffer->plane(2),
+		                                               buffer->width(), buffer->height(),
+		                                               buffer->planeWidth(1), buffer->planeHeight(1),
+		                                               buffer->bitDepth());
+	}
+	// Wait for the transfer to be over
+	glFinish();
+	if(uploaded) {
+		_uploadCount++;
+		_uploadTime += timer.nsecsElapsed();
+	}
+
+	_pool.release(buffer);
+}
+
+void VideoBenchmark::resetStages()
+{
+	_decoder.resetStatistics();
+	_uploadCount = 0;
+	_uploadTime = 0;
+}
+
+QJsonObject VideoBenchmark::stages()
+{
+	PhVideoDecoder::Statistics statistics = _decoder.statistics();
+
+	QJsonObject seek;
+	seek["count"] = statistics.seekCount;
+	seek["totalMs"] = statistics.seekTime / 1e6;
+	seek["meanMs"] = statistics.seekCount ? statistics.seekTime / 1e6 / statistics.seekCount : 0;
+
+	QJsonObject decode;
+	decode["count"] = statistics.decodeCount;
+	decode["totalMs"] = statistics.decodeTime / 1e6;
+	decode["meanMs"] = statistics.decodeCount ? statistics.decodeTime / 1e6 / statistics.decodeCount : 0;
+
+	QJsonObject convert;
+	convert["count"] = statistics.convertCount;
+	convert["totalMs"] = statistics.convertTime / 1e6;
+	convert["meanMs"] = statistics.convertCount ? statistics.convertTime / 1e6 / statistics.convertCount : 0;
+
+	QJsonObject result;
+	result["seek"] = seek;
+	result["decode"] = decode;
+	result["convert"] = convert;
+
+	if(_pixelBuffer) {
+		QJsonObject upload;
+		upload["count"] = _uploadCount;
+		upload["totalMs"] = _uploadTime / 1e6;
+		upload["meanMs"] = _uploadCount ? _uploadTime / 1e6 / _uploadCount : 0;
+		result["upload"] = upload;
+	}
+
+	return result;
+}
+
+QJsonObject VideoBenchmark::latencies(QList<double> values)
+{
+	QJsonObject result;
+	result["count"] = values.count();
+	if(values.isEmpty())
+		return result;
+
+	qSort(values);
+	double total = 0;
+	foreach(double value, values)
+		total += value;
+
+	// Nearest rank percentile
+	int count = values.count();
+	result["meanMs"] = total / count;
+	result["p50Ms"] = values[qCeil(0.50 * count) - 1];
+	result["p95Ms"] = values[qCeil(0.95 * count) - 1];
+	result["p99Ms"] = values[qCeil(0.99 * count) - 1];
+	result["maxMs"] = values.last();
+	return result;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#ifndef VIDEOBENCHMARK_H
+#define VIDEOBENCHMARK_H
+
+#include <QJsonObject>
+#include <QGLPixelBuffer>
+
+#include "PhGraphic/PhGraphicTexturedRect.h"
+#include "PhGraphic/PhGraphicYUVRect.h"
+#include "PhVideo/PhVideoPool.h"
+#include "PhVideo/PhVideoDecoder.h"
+
+/**
+ * @brief Measure the performance of the video decoding path
+ *
+ * The frames are requested the same way PhVideoEngine does: by setting the
+ * window of the PhVideoPool and waking the PhVideoDecoder up. The decoder
+ * lives in the benchmark thread and its queued calls are processed until
+ * the requested frame is available.
+ *
+ * Each measure returns a JSON object with its results and the time spent
+ * in each stage of the decoding.
+ */
+class VideoBenchmark
+{
+public:
+	/**
+	 * @brief VideoBenchmark constructor
+	 * @param readhead The number of frames requested ahead of the playhead during playback
+	 */
+	explicit VideoBenchmark(int readhead = 8);
+
+	~VideoBenchmark();
+
+	/**
+	 * @brief Open a video file
+	 * @param fileName A video file path
+	 * @param threadCount A number of decoding threads or 0 for automatic
+	 * @param threadType A threading method of the codec
+	 * @param yuvOutput True to keep the YUV planes, false to convert to BGRA
+	 * @param waitIndex True to wait for the keyframe index before returning
+	 * @return True if the file was opened successfully, false otherwise
+	 */
+	bool open(QString fileName, int threadCount, PhVideoDecoder::ThreadType threadType, bool yuvOutput, bool waitIndex);
+
+	/**
+	 * @brief Enable the texture upload measure
+	 *
+	 * An offscreen OpenGL context is created for that purpose.
+	 * @return True if the context is available, false otherwise
+	 */
+	bool enableUpload();
+
+	/**
+	 * @brief The properties of the opened file
+	 * @return A JSON object
+	 */
+	QJsonObject info();
+
+	/**
+	 * @brief Measure the decoding speed when playing forward
+	 * @param frameCount The number of frames to decode
+	 * @return A JSON object
+	 */
+	QJsonObject measureSequential(int frameCount);
+
+	/**
+	 * @brief Measure the latency of random frame requests
+	 * @param seekCount The number of seeks to perform
+	 * @param seed The random generator seed
+	 * @return A JSON object
+	 */
+	QJsonObject measureSeeks(int seekCount, uint seed);
+
+	/**
+	 * @brief Measure the cost of stepping backward frame by frame
+	 * @param stepCount The number of steps to perform
+	 * @return A JSON object
+	 */
+	QJsonObject measureReverseSteps(int stepCount);
+
+	/**
+	 * @brief Measure the forward decoding speed of each threading method
+	 *
+	 * The file is opened again with each method, then with the one given
+	 * to open().
+	 * @param frameCount The number of frames to decode with each method
+	 * @return A JSON object with a measureSequential() result per method
+	 */
+	QJsonObject compareThreading(int frameCount);
+
+	/**
+	 * @brief The name of a threading method
+	 * @param threadType A threading method
+	 * @return "auto", "frame" or "slice"
+	 */
+	static QString threadTypeName(PhVideoDecoder::ThreadType threadType);
+
+private:
+	bool waitFrame(PhFrame frame);
+	void upload(PhFrame frame);
+	void resetStages();
+	QJsonObject stages();
+	static QJsonObject latencies(QList<double> values);
+
+	int _readhead;
+	QString _fileName;
+	int _threadCount;
+	PhVideoDecoder::ThreadType _threadType;
+	PhVideoPool _pool;
+	PhVideoDecoder _decoder;
+	PhFrame _lastFrame;
+
+	QGLPixelBuffer *_pixelBuffer;
+	PhGraphicTexturedRect _videoRect;
+	PhGraphicYUVRect _yuvRect;
+	int _uploadCount;
+	qint64 _uploadTime;
+};
+
+#endif // VIDEOBENCHMARK_H
@@ -0,0 +1,147 @@
+/**
+ * @file
+ * @copyright (C) 2012-2014 Phonations
+ * @license http://www.gnu.org/licenses/gpl.html GPL version 2 or higher
+ */
+
+#include <QApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QScopedPointer>
+#include <QTextStream>
+
+#include "PhTools/PhDebug.h"
+
+#include "VideoBenchmark.h"
+
+static void usage()
+{
+	QTextStream(stderr) << "Usage: VideoBenchmark [--frames <count>] [--seeks <count>] [--steps <count>]"
+	                    << " [--readhead <count>] [--threads <count>] [--thread-type <type>]"
+	                    << " [--compare-threading] [--bgra] [--upload] [--no-index] [--seed <value>]"
+	                    << " [--output <file>] <video file>\n";
+}
+
+/**
+ * @brief The application main entry point
+ * @param argc Command line argument count
+ * @param argv Command line argument list
+ * @return 0 if the benchmark succeeded.
+ */
+int main(int argc, char *argv[])
+{
+	// Only the offscreen OpenGL context of the upload measure needs a GUI application
+	bool measureUpload = false;
+	for(int i = 1; i < argc; i++) {
+		if(QString(argv[i]) == "--upload")
+			measureUpload = true;
+	}
+	QScopedPointer<QCoreApplication> app(measureUpload ? new QApplication(argc, argv) : new QCoreApplication(argc, argv));
+	// The standard output is kept for the report
+	PhDebug::setLogMask(0);
+
+	int frameCount = 500;
+	int seekCount = 100;
+	int stepCount = 50;
+	int readhead = 8;
+	int threadCount = 0;
+	PhVideoDecoder::ThreadType threadType = PhVideoDecoder::AutoThreading;
+	bool compareThreading = false;
+	bool yuvOutput = true;
+	bool waitIndex = true;
+	uint seed = 0;
+	QString outputFileName;
+	QString fileName;
+
+	QStringList args = app->arguments();
+	for(int i = 1; i < args.count(); i++) {
+		QString arg = args[i];
+		bool hasValue = (i + 1 < args.count());
+		if((arg == "--frames") && hasValue)
+			frameCount = args[++i].toInt();
+		else if((arg == "--seeks") && hasValue)
+			seekCount = args[++i].toInt();
+		else if((arg == "--steps") && hasValue)
+			stepCount = args[++i].toInt();
+		else if((arg == "--readhead") && hasValue)
+			readhead = args[++i].toInt();
+		else if((arg == "--threads") && hasValue)
+			threadCount = args[++i].toInt();
+		else if((arg == "--thread-type") && hasValue) {
+			QString name = args[++i];
+			if(name == VideoBenchmark::threadTypeName(PhVideoDecoder::FrameThreading))
+				threadType = PhVideoDecoder::FrameThreading;
+			else if(name == VideoBenchmark::threadTypeName(PhVideoDecoder::SliceThreading))
+				threadType = PhVideoDecoder::SliceThreading;
+			else if(name == VideoBenchmark::threadTypeName(PhVideoDecoder::AutoThreading))
+				threadType = PhVideoDecoder::AutoThreading;
+			else {
+				usage();
+				return 1;
+			}
+		}
+		else if((arg == "--seed") && hasValue)
+			seed = args[++i].toUInt();
+		else if((arg == "--output") && hasValue)
+			outputFileName = args[++i];
+		else if(arg == "--bgra")
+			yuvOutput = false;
+		else if(arg == "--upload") {
+			// Already read to create the application
+		}
+		else if(arg == "--no-index")
+			waitIndex = false;
+		else if(arg == "--compare-threading")
+			compareThreading = true;
+		else if(!arg.startsWith("--") && fileName.isEmpty())
+			fileName = arg;
+		else {
+			usage();
+			return 1;
+		}
+	}
+
+	if(fileName.isEmpty()) {
+		usage();
+		return 1;
+	}
+
+	VideoBenchmark benchmark(readhead);
+	if(!benchmark.open(fileName, threadCount, threadType, yuvOutput, waitIndex)) {
+		QTextStream(stderr) << "Unable to open " << fileName << "\n";
+		return 2;
+	}
+
+	if(measureUpload && !benchmark.enableUpload()) {
+		QTextStream(stderr) << "No OpenGL context available for the upload measure\n";
+		return 3;
+	}
+
+	QJsonObject report = benchmark.info();
+	report["file"] = fileName;
+	report["threadCount"] = threadCount;
+	report["threadType"] = VideoBenchmark::threadTypeName(threadType);
+	report["yuvOutput"] = yuvOutput;
+	report["readhead"] = readhead;
+	report["sequential"] = benchmark.measureSequential(frameCount);
+	report["seek"] = benchmark.measureSeeks(seekCount, seed);
+	report["reverse"] = benchmark.measureReverseSteps(stepCount);
+	// Last as the file is opened again with each method
+	if(compareThreading)
+		report["threading"] = benchmark.compareThreading(frameCount);
+
+	QByteArray json = QJsonDocument(report).toJson();
+	if(outputFileName.isEmpty()) {
+		QTextStream(stdout) << json;
+		return 0;
+	}
+
+	QFile file(outputFileName);
+	if(!file.open(QIODevice::WriteOnly)) {
+		QTextStream(stderr) << "Unable to write " << outputFileName << "\n";
+		return 4;
+	}
+	file.write(json);
+
+	return 0;
+}
@@ -231,7 +231,7 @@ void VideoTestWindow::onPaint(int width, int height)
 	int videoRate = _videoEngine.refreshRate();
 	if(videoRate > _maxVideoRate)
 		_maxVideoRate = videoRate;
-	QString info = QString("%1 / %2").arg(videoRate).arg(_maxVideoRate);
+	QString info = QString("%1 / %2 (decode: %3)").arg(videoRate).arg(_maxVideoRate).arg(_videoEngine.decodeRate());
 	ui->videoView->addInfo(info);
 	_videoEngine.drawVideo(0, 0, width, height);
 }
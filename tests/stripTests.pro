@@ -3,6 +3,7 @@ TEMPLATE = subdirs
 SUBDIRS += \
 	GraphicStripSyncTest \
 	GraphicStripTest \
+	StripBenchmark \
 	StripTest \
 	VideoStripTest \
 
@@ -12,9 +12,11 @@ SUBDIRS += \
 	OpenGLTest \
 	SDLTest \
 	SerialTest \
+	StripBenchmark \
 	StripTest \
 	TextEditTest \
 	TimecodePlayer \
+	VideoBenchmark \
 	VideoStripTest \
 	VideoSyncTest \
 	VideoTest \
@@ -2,6 +2,7 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
 	FFmpegTest \
+	VideoBenchmark \
 	VideoStripTest \
 	VideoSyncTest \
 	VideoTest \